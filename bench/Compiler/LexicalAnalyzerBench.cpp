@@ -0,0 +1,152 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
+#include "ZeeBasic/Compiler/ParallelLexer.hpp"
+#include "ZeeBasic/Compiler/TokenBuffer.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+// Measures lexer throughput for the character-at-a-time reader path against the table-driven buffer path at each
+// scan level. Levels the processor does not support fall back to the best one it does. The parallel lexer keeps every
+// token, so it is compared against collecting the tokens into a buffer on one thread.
+
+// Reader that only offers one character at a time, which forces the lexer down the character path.
+class CharSourceReader
+    :
+    public ISourceReader
+{
+public:
+    CharSourceReader(const std::string& text) : m_text(text), m_offset(0) { }
+
+    char readNextChar() override
+    {
+        if (m_offset >= m_text.size())
+        {
+            return 0;
+        }
+
+        return m_text[m_offset++];
+    }
+
+private:
+    const std::string& m_text;
+    size_t m_offset;
+};
+
+static std::string generateSource(size_t size)
+{
+    static const char* lines[] = {
+        "total% = total% + value% * 3 ' running sum\n",
+        "PRINT \"item number \" + STR$(index%)\n",
+        "fullName$ = firstName$ + \" \" + lastName$\n",
+        "ratio! = 1.5 / (count% + .25) - offset!\n",
+        "done? = index% >= limit% AND NOT failed?\n",
+        "        ' the loop below walks every record once and reports the ones that fail validation\n",
+        "        message$ = \"Record \" + STR$(index%) + \" failed validation, see the log for details\"\n",
+        "\n",
+    };
+
+    auto source = std::string{};
+    source.reserve(size + 64);
+    for (auto i = 0; source.size() < size; ++i)
+    {
+        source += lines[i % (sizeof(lines) / sizeof(lines[0]))];
+    }
+    return source;
+}
+
+static int countTokens(LexicalAnalyzer& lexer)
+{
+    auto count = 0;
+    while (lexer.parseNextToken().id != TokenId::EndOfCode)
+    {
+        ++count;
+    }
+    return count;
+}
+
+template<typename Lex>
+static void run(const char* name, const std::string& source, Lex lex)
+{
+    auto best = 0.0;
+    auto count = 0;
+    for (auto pass = 0; pass < 5; ++pass)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        count = lex();
+
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        auto mbps = double(source.size()) / (1024.0 * 1024.0) / seconds;
+        best = mbps > best ? mbps : best;
+    }
+
+    printf("%-12s %10.1f MB/s  (%d tokens)\n", name, best, count);
+}
+
+int main(int argc, char* argv[])
+{
+    auto size = size_t(argc > 1 ? atoi(argv[1]) : 64) * 1024 * 1024;
+    auto source = generateSource(size);
+    printf("lexing %zu bytes\n", source.size());
+
+    run("character", source, [&] {
+        auto reader = CharSourceReader{ source };
+        auto lexer = LexicalAnalyzer{ reader };
+        return countTokens(lexer);
+    });
+    run("scalar", source, [&] {
+        auto lexer = LexicalAnalyzer{ source.data(), source.size(), ScanLevel::Scalar };
+        return countTokens(lexer);
+    });
+    run("sse2", source, [&] {
+        auto lexer = LexicalAnalyzer{ source.data(), source.size(), ScanLevel::SSE2 };
+        return countTokens(lexer);
+    });
+    run("avx2", source, [&] {
+        auto lexer = LexicalAnalyzer{ source.data(), source.size(), ScanLevel::AVX2 };
+        return countTokens(lexer);
+    });
+    run("collected", source, [&] {
+        auto lexer = LexicalAnalyzer{ source.data(), source.size() };
+        auto tokens = TokenBuffer{ source.data(), source.size() };
+        for (auto token = lexer.parseNextToken(); token.id != TokenId::EndOfCode; token = lexer.parseNextToken())
+        {
+            tokens.append(token);
+        }
+        return int(tokens.getCount());
+    });
+    run("parallel", source, [&] {
+        return int(ParallelLexer{ source.data(), source.size() }.run().getCount()) - 1;
+    });
+
+    return 0;
+}
@@ -0,0 +1,329 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <utility>
+
+#include "ZeeBasic/Compiler/AssignmentStatementNode.hpp"
+#include "ZeeBasic/Compiler/BinaryExpressionNode.hpp"
+#include "ZeeBasic/Compiler/CastExpressionNode.hpp"
+#include "ZeeBasic/Compiler/ConstantPropagation.hpp"
+#include "ZeeBasic/Compiler/CTranslator.hpp"
+#include "ZeeBasic/Compiler/DeadCodeElimination.hpp"
+#include "ZeeBasic/Compiler/FlatAst.hpp"
+#include "ZeeBasic/Compiler/FunctionCallExpressionNode.hpp"
+#include "ZeeBasic/Compiler/ITranslator.hpp"
+#include "ZeeBasic/Compiler/IrLowering.hpp"
+#include "ZeeBasic/Compiler/Parser.hpp"
+#include "ZeeBasic/Compiler/Pipeline.hpp"
+#include "ZeeBasic/Compiler/PrintStatementNode.hpp"
+#include "ZeeBasic/Compiler/Program.hpp"
+#include "ZeeBasic/Compiler/UnaryExpressionNode.hpp"
+#include "ZeeBasic/Compiler/ValueNumbering.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+// Measures passes over a large parsed program in nodes per second: walking the node tree through virtual dispatch
+// against scanning the flat form with a switch, then flattening the tree, lowering the flat form to SSA, optimizing
+// it and translating the SSA form to C. Also reports how many C statements the optimizations save, and how large the C
+// is and how long the C compiler takes over it when every value gets a temporary and when expressions are nested, and
+// how long a program that builds strings runs when each concatenation is a call and when a chain is one call.
+
+// Reads source text kept in memory, so the benchmark does not depend on the file system.
+class BufferSourceReader
+    :
+    public ISourceReader
+{
+public:
+    BufferSourceReader(const std::string& text) : m_text(text), m_offset(0) { }
+
+    char readNextChar() override { return m_offset < m_text.size() ? m_text[m_offset++] : 0; }
+
+    const char* getData() const override { return m_text.data(); }
+    size_t getSize() const override { return m_text.size(); }
+
+private:
+    const std::string& m_text;
+    size_t m_offset;
+};
+
+// Counts the nodes of the tree, visiting them the way translation used to.
+class TreeWalker
+    :
+    public ITranslator
+{
+public:
+    TreeWalker(const Program& program) : m_program(program) { }
+
+    void run() override
+    {
+        for (auto statement : m_program.statements)
+        {
+            statement->translate(*this);
+        }
+    }
+
+    void translate(const Nodes::AssignmentStatementNode& node) override { ++count; node.getExpression()->translate(*this); }
+    void translate(const Nodes::BinaryExpressionNode& node) override { ++count; node.getLeft().translate(*this); node.getRight().translate(*this); }
+    void translate(const Nodes::BooleanLiteralNode&) override { ++count; }
+    void translate(const Nodes::CastExpressionNode& node) override { ++count; node.getExpression().translate(*this); }
+    void translate(const Nodes::FunctionCallExpressionNode& node) override
+    {
+        ++count;
+        for (auto argument : node.getArguments())
+        {
+            argument->translate(*this);
+        }
+    }
+    void translate(const Nodes::IdentifierExpressionNode&) override { ++count; }
+    void translate(const Nodes::IntegerLiteralNode&) override { ++count; }
+    void translate(const Nodes::PrintStatementNode& node) override
+    {
+        ++count;
+        if (node.getExpression())
+        {
+            node.getExpression()->translate(*this);
+        }
+    }
+    void translate(const Nodes::RealLiteralNode&) override { ++count; }
+    void translate(const Nodes::StringLiteralNode&) override { ++count; }
+    void translate(const Nodes::UnaryExpressionNode& node) override { ++count; node.getExpression().translate(*this); }
+
+    size_t count = 0;
+
+private:
+    const Program& m_program;
+};
+
+static size_t scanFlat(const FlatAst& ast)
+{
+    auto count = size_t(0);
+    for (uint32_t index = 0; index < ast.getCount(); ++index)
+    {
+        switch (ast.getKind(index))
+        {
+        case FlatAst::Kind::Binary:
+        case FlatAst::Kind::Assignment:
+            count += ast.getSecond(index) != FlatAst::kNone;
+            break;
+        default:
+            ++count;
+            break;
+        }
+    }
+    return count;
+}
+
+// statements the C translator emits for a function: one for each instruction other than a phi
+static size_t countStatements(const Ir::Function& function)
+{
+    auto count = size_t(0);
+    for (uint32_t block = 0; block < function.getBlockCount(); ++block)
+    {
+        for (auto index : function.getBlock(block).instructions)
+        {
+            count += function.getInstruction(index).opcode != Ir::Opcode::Phi;
+        }
+    }
+    return count;
+}
+
+static std::string generateSource(int lineCount)
+{
+    auto source = std::string{ "v0% = 1\nr! = 0.5\n" };
+    for (auto i = 1; i < lineCount; ++i)
+    {
+        auto a = std::to_string((int64_t(i) * 7919 + 13) % i);
+        auto b = std::to_string((int64_t(i) * 104729 + 7) % i);
+        source += "v" + std::to_string(i) + "% = v" + a + "% * 3 + (v" + b + "% - 7) \\ 2 + " + std::to_string(i) + "\n";
+        if (i % 16 == 0)
+        {
+            source += "r! = r! + v" + a + "% / 3\nPRINT \"line \" + STR$(v" + b + "%)\n";
+        }
+    }
+    return source;
+}
+
+// An unrolled loop appending several parts to a string at a time, the way a program builds up its output.
+static std::string generateConcatenation(int lineCount)
+{
+    auto source = std::string{ "t$ = STRING$(100, \"ab\")\ns$ = \"\"\n" };
+    for (auto i = 0; i < lineCount; ++i)
+    {
+        source += "s$ = s$ + t$ + \",\" + STR$(" + std::to_string(i) + ")\n";
+    }
+    source += "PRINT LEN(s$)\n";
+    return source;
+}
+
+// Writes the C for a program in each emission mode and times the C compiler over it, on the program as lowered, so the
+// passes that already remove most of the temporaries do not hide the difference.
+static void compareEmission(int lineCount, const std::string& path)
+{
+    auto source = generateSource(lineCount);
+    auto reader = BufferSourceReader{ source };
+    auto program = Program{};
+    Parser{ reader, program }.run();
+    Pipeline{ program, Pass_None }.run();
+
+    auto object = path + ".o";
+    auto command = "cc -std=c99 -O1 -Iinclude -c -o \"" + object + "\" \"" + path + "\"";
+    const std::pair<const char*, CTranslator::Emission> modes[] = {
+        { "temporaries", CTranslator::Emission::Temporaries },
+        { "expressions", CTranslator::Emission::Expressions }
+    };
+    for (const auto& mode : modes)
+    {
+        CTranslator{ path, program, mode.second }.run();
+        auto size = std::filesystem::file_size(path);
+
+        auto start = std::chrono::steady_clock::now();
+        auto status = std::system(command.c_str());
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (status == 0)
+        {
+            printf("%-12s %10.1f KB of C, cc -O1 in %.2f s\n", mode.first, double(size) / 1024.0, seconds);
+        }
+        else
+        {
+            printf("%-12s %10.1f KB of C, cc failed\n", mode.first, double(size) / 1024.0);
+        }
+    }
+    std::filesystem::remove(object);
+}
+
+// Builds the string program in each emission mode against the runtime and times running it.
+static void compareConcatenation(int lineCount, const std::string& path)
+{
+    auto source = generateConcatenation(lineCount);
+    auto reader = BufferSourceReader{ source };
+    auto program = Program{};
+    Parser{ reader, program }.run();
+    Pipeline{ program, Pass_None }.run();
+
+    auto executable = path + ".exe";
+    auto build = "cc -std=c99 -O1 -Iinclude -o \"" + executable + "\" \"" + path + "\" src/Runtime/ZeeRuntime.c -lm";
+    auto command = "\"" + executable + "\" > " + (std::filesystem::temp_directory_path() / "TranslatorBench.out").string();
+    const std::pair<const char*, CTranslator::Emission> modes[] = {
+        { "pairwise", CTranslator::Emission::Temporaries },
+        { "fused", CTranslator::Emission::Expressions }
+    };
+    for (const auto& mode : modes)
+    {
+        CTranslator{ path, program, mode.second }.run();
+        if (std::system(build.c_str()) != 0)
+        {
+            printf("%-12s cc failed\n", mode.first);
+            continue;
+        }
+
+        auto best = 0.0;
+        for (auto i = 0; i < 5; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            std::system(command.c_str());
+            auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            best = i == 0 || seconds < best ? seconds : best;
+        }
+        printf("%-12s %10.1f ms to concatenate %d lines\n", mode.first, best * 1000.0, lineCount);
+    }
+    std::filesystem::remove(executable);
+    std::filesystem::remove(std::filesystem::temp_directory_path() / "TranslatorBench.out");
+}
+
+template<typename Pass>
+static void run(const char* name, size_t nodeCount, Pass pass)
+{
+    auto best = 0.0;
+    for (auto i = 0; i < 5; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        pass();
+
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        auto rate = double(nodeCount) / seconds / 1e6;
+        best = rate > best ? rate : best;
+    }
+
+    printf("%-12s %10.1f M nodes/s\n", name, best);
+}
+
+int main(int argc, char* argv[])
+{
+    auto source = generateSource(argc > 1 ? atoi(argv[1]) : 200000);
+    auto reader = BufferSourceReader{ source };
+    auto program = Program{};
+    Parser{ reader, program }.run();
+    Pipeline{ program }.run();
+
+    auto nodeCount = program.ast.getCount();
+    printf("translating %zu nodes (%zu bytes of source)\n", nodeCount, source.size());
+
+    auto total = size_t(0);
+    run("tree walk", nodeCount, [&] {
+        auto walker = TreeWalker{ program };
+        walker.run();
+        total += walker.count;
+    });
+    run("flat scan", nodeCount, [&] {
+        total += scanFlat(program.ast);
+    });
+    run("flatten", nodeCount, [&] {
+        total += FlatAst::build(program.statements).getCount();
+    });
+
+    run("lower", nodeCount, [&] {
+        total += IrLowering{ program.ast, program.symbols }.run().getInstructionCount();
+    });
+    run("optimize", nodeCount, [&] {
+        auto function = IrLowering{ program.ast, program.symbols }.run();
+        ConstantPropagation{ function }.run();
+        ValueNumbering{ function }.run();
+        DeadCodeElimination{ function }.run();
+        total += function.getBlockCount();
+    });
+
+    auto unoptimized = countStatements(IrLowering{ program.ast, program.symbols }.run());
+    printf("C statements: %zu before optimizing, %zu after\n", unoptimized, countStatements(program.ir));
+
+    auto path = (std::filesystem::temp_directory_path() / "TranslatorBench.c").string();
+    run("translate", nodeCount, [&] {
+        CTranslator{ path, program }.run();
+    });
+
+    compareEmission(argc > 2 ? atoi(argv[2]) : 5000, path);
+    compareConcatenation(argc > 3 ? atoi(argv[3]) : 5000, path);
+    std::filesystem::remove(path);
+
+    return total == 0;
+}
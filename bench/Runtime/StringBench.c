@@ -0,0 +1,139 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2020, Jason Hoyt
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ZeeBasic/Runtime/ZeeRuntime.h"
+
+/* Measures the string runtime on the calls generated code makes most, for short text that fits in a string's own
+   buffer and for long text that does not: making and freeing a string, concatenating into a new string, and
+   overwriting a string on the stack the way a temporary slot is. Then assigning large strings to a slot, and appending
+   to a slot just assigned, which has to copy the text it shares first. */
+
+static const char* shortText = "KEY-0042";
+static const char* longText = "a field long enough that it never fits in the small buffer of a string";
+
+static volatile zrt_Int sink;
+
+static void report(const char* name, int count, clock_t start)
+{
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("%-16s %8.1f ns/op\n", name, seconds * 1e9 / count);
+}
+
+static void benchNew(const char* name, const char* text, int count)
+{
+    clock_t start = clock();
+    int i;
+    for (i = 0; i < count; ++i)
+    {
+        zrt_String* str = zrt_str_new(text);
+        sink += str->length;
+        zrt_str_del(str);
+    }
+    report(name, count, start);
+}
+
+static void benchConcat(const char* name, const char* text, int count)
+{
+    zrt_String* lhs = zrt_str_new(text);
+    zrt_String* rhs = zrt_str_new(shortText);
+    clock_t start = clock();
+    int i;
+    for (i = 0; i < count; ++i)
+    {
+        zrt_String* str = zrt_str_concat(lhs, rhs);
+        sink += str->length;
+        zrt_str_del(str);
+    }
+    report(name, count, start);
+    zrt_str_del(rhs);
+    zrt_str_del(lhs);
+}
+
+static void benchSlot(const char* name, const char* text, int count)
+{
+    zrt_String* lhs = zrt_str_new(text);
+    zrt_String* rhs = zrt_str_new(shortText);
+    zrt_String slot[1];
+    clock_t start = clock();
+    int i;
+    zrt_str_init(slot);
+    for (i = 0; i < count; ++i)
+    {
+        zrt_str_concat_into(slot, lhs, rhs);
+        sink += slot->length;
+        zrt_str_take(slot, zrt_str_dup(lhs));
+        sink += slot->length;
+    }
+    zrt_str_release(slot);
+    report(name, count, start);
+    zrt_str_del(rhs);
+    zrt_str_del(lhs);
+}
+
+static void benchAssign(const char* name, zrt_Int length, int append, int count)
+{
+    zrt_String* first = zrt_str_space(length);
+    zrt_String* second = zrt_str_space(length + 1);
+    zrt_String slot[1];
+    clock_t start = clock();
+    int i;
+    zrt_str_init(slot);
+    for (i = 0; i < count; ++i)
+    {
+        zrt_str_retain(slot, i % 2 ? second : first);
+        if (append)
+        {
+            zrt_str_append(slot, first);
+        }
+        sink += slot->length;
+    }
+    zrt_str_release(slot);
+    report(name, count, start);
+    zrt_str_del(second);
+    zrt_str_del(first);
+}
+
+int main(int argc, char* argv[])
+{
+    int count = argc > 1 ? atoi(argv[1]) : 10000000;
+
+    benchNew("new short", shortText, count);
+    benchNew("new long", longText, count);
+    benchConcat("concat short", shortText, count);
+    benchConcat("concat long", longText, count);
+    benchSlot("slot short", shortText, count);
+    benchSlot("slot long", longText, count);
+    benchAssign("assign 64K", 65536, 0, count / 100);
+    benchAssign("assign+append", 65536, 1, count / 100);
+
+    return sink == 0;
+}
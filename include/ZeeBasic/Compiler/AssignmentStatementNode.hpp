@@ -26,8 +26,6 @@
 
 #pragma once
 
-#include <memory>
-
 #include "Node.hpp"
 
 namespace ZeeBasic::Compiler
@@ -49,11 +47,11 @@ namespace ZeeBasic::Compiler::Nodes
 		void translate(ITranslator& translator) const override;
 
 		const auto getSymbol() const { return m_symbol; }
-		const auto getExpression() const { return m_expr.get(); }
+		const auto getExpression() const { return m_expr; }
 
 	private:
 		Symbol* m_symbol = nullptr;
-		std::unique_ptr<ExpressionNode> m_expr;
+		ExpressionNode* m_expr = nullptr;
 	};
 
 }
@@ -56,7 +56,10 @@ namespace ZeeBasic::Compiler::Nodes
 			BitwiseXor		// boolean and integer only
 		};
 
-		BinaryExpressionNode(Operator op, std::unique_ptr<ExpressionNode> lhs, std::unique_ptr<ExpressionNode> rhs);
+		// one past the last operator, which sizes the operator type table
+		static constexpr int kOperatorCount = int(Operator::BitwiseXor) + 1;
+
+		BinaryExpressionNode(Operator op, ExpressionNode* lhs, ExpressionNode* rhs);
 		virtual ~BinaryExpressionNode();
 
 		auto getOperator() const { return m_op; }
@@ -68,8 +71,8 @@ namespace ZeeBasic::Compiler::Nodes
 
 	private:
 		Operator m_op;
-		std::unique_ptr<ExpressionNode> m_lhs;
-		std::unique_ptr<ExpressionNode> m_rhs;		
+		ExpressionNode* m_lhs;
+		ExpressionNode* m_rhs;		
 	};
 
 }
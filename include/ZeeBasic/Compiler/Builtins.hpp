@@ -0,0 +1,83 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+
+#include "TokenId.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Signature and C lowering of a built-in function, such as SQR or MID$.
+	struct Builtin
+	{
+		// Argument and result types. A Real argument also takes an integer, which is cast up; a Number argument takes
+		// either, and a Number result has the type of the Number argument.
+		enum class Operand : uint8_t
+		{
+			None,
+			Integer,
+			Real,
+			Number,
+			String
+		};
+
+		enum class Lowering : uint8_t
+		{
+			Inline,			// C expression, including <math.h> functions
+			Runtime			// call into the ZeeBASIC runtime, which may allocate
+		};
+
+		static constexpr int kMaxArguments = 3;
+
+		TokenId id;
+		const char* name;
+		Operand result;
+		Operand arguments[kMaxArguments];
+		uint8_t requiredArgumentCount;		// only the last argument may be optional
+		bool isPure;						// no side effects and the result only depends on the arguments
+		Lowering lowering;
+		const char* code;					// C code with $0, $1, ... standing for the arguments
+		const char* realCode;				// C code to use instead when the Number argument is real, or nullptr
+		const char* defaultArgument;		// C code standing for a missing optional argument, or nullptr
+
+		int getArgumentCount() const
+		{
+			auto count = 0;
+			while (count < kMaxArguments && arguments[count] != Operand::None)
+			{
+				++count;
+			}
+			return count;
+		}
+	};
+
+	// Get the built-in function for a keyword, or nullptr if the keyword does not name one.
+	const Builtin* getBuiltin(TokenId id);
+
+}
@@ -30,68 +30,95 @@
 #include <string>
 #include <vector>
 
-#include "ITranslator.hpp"
-
-#include "Symbol.hpp"
+#include "Ir.hpp"
+#include "SlotAllocator.hpp"
 #include "Type.hpp"
 
 namespace ZeeBasic::Compiler
 {
 
+	struct Program;
+
+	// Translates the SSA form of a program to C. Every block becomes a label, laid out so that each block follows the
+	// blocks that dominate it, and a phi becomes a variable that is assigned on each edge into its block.
+	//
+	// Values are written as nested C expressions where that is safe: a constant wherever it is used, and a pure scalar
+	// operation at its only use when that is later in the same block. A chain of concatenations becomes one call that
+	// sizes the result once. Other strings, values with side effects and values used more than once get a C variable of
+	// their own. Emitting a variable for every value instead is kept as a mode, for
+	// comparing the two and for reading the C against the SSA form.
+	//
+	// The variables are slots shared by values that are never live together, declared once at the top of the function.
+	// A string slot is a string on the stack that each value in it overwrites in place, so a string statement reuses
+	// the storage of the last one rather than allocating its own and freeing it afterwards. A string literal
+	// needs no slot: each distinct one is a static string, marked so the runtime never frees it, and used in place.
 	class CTranslator
-		:
-		public ITranslator
 	{
 	public:
-		CTranslator(const std::string& path, const Program& program);
-		virtual ~CTranslator();
-
-		void run() override;
-
-		void translate(const Nodes::AssignmentStatementNode& node) override;
-		void translate(const Nodes::BinaryExpressionNode& node) override;
-		void translate(const Nodes::BooleanLiteralNode& node) override;
-		void translate(const Nodes::CastExpressionNode& node) override;
-		void translate(const Nodes::FunctionCallExpressionNode& node) override;
-		void translate(const Nodes::IdentifierExpressionNode& node) override;
-		void translate(const Nodes::IntegerLiteralNode& node) override;
-		void translate(const Nodes::PrintStatementNode& node) override;
-		void translate(const Nodes::RealLiteralNode& node) override;
-		void translate(const Nodes::StringLiteralNode& node) override;
-		void translate(const Nodes::UnaryExpressionNode& node) override;
+		enum class Emission
+		{
+			Expressions,
+			Temporaries
+		};
+
+		CTranslator(const std::string& path, const Program& program, Emission emission = Emission::Expressions);
+		~CTranslator();
+
+		void run();
 
 	private:
 		FILE* m_file = nullptr;
 
 		const Program& m_program;
+		const Ir::Function& m_function;
+		Emission m_emission;
+
+		// values written out where they are used, rather than as a variable
+		std::vector<bool> m_inlined;
+
+		// the static string for each string literal instruction, and the distinct texts in order
+		std::vector<uint32_t> m_literals;
+		std::vector<ConstString> m_literalTexts;
+
+		SlotAllocator m_slots;
 
-		enum class IndexType
+		void findInlinedValues();
+		void findLiterals();
+		void declareLiterals();
+		void declareSlots();
+
+		void translate(uint32_t index);
+		void translatePrint(uint32_t index);
+		void translateString(uint32_t index);
+		void translateEdge(uint32_t from, uint32_t to);
+
+		// write the C expression computing the value of an instruction
+		void writeExpression(uint32_t index);
+		void writeBinary(uint32_t index);
+		void writeCall(uint32_t index);
+		void writeCast(uint32_t index);
+		void writeUnary(uint32_t index);
+
+		// start a line assigning the value of an instruction to its slot
+		void assign(uint32_t index);
+
+		// a value, written by its C name or as the expression computing it
+		struct Value
 		{
-			Temporary,
-			Local
+			uint32_t index;
 		};
 
-		struct VariableIndex
+		// text written as a C string literal, escaped
+		struct Literal
 		{
-			IndexType indexType;
-			Type type;
-			union
-			{
-				int id;
-				const Symbol* symbol = nullptr;
-			};
-
-			VariableIndex(const Symbol& symbol) : indexType(IndexType::Local), type(symbol.type), symbol(&symbol) { }
-			VariableIndex(Type type) : indexType(IndexType::Temporary), type(type), id(0) { }
+			const ConstString& text;
 		};
-		std::vector<VariableIndex> m_variableIndices;
-
-		int m_nextTempId = 1;
 
 		class Writer
 		{
 		public:
-			Writer(std::vector<VariableIndex>& variableIndices);
+			Writer(CTranslator& translator);
+
 			void setFile(FILE* file);
 
 			void indent();
@@ -100,24 +127,23 @@ namespace ZeeBasic::Compiler
 
 			Writer& operator<<(char ch);
 			Writer& operator<<(const char* text);
+			Writer& operator<<(const ConstString& text);
+			Writer& operator<<(const Literal& literal);
 			Writer& operator<<(int64_t value);
-			Writer& operator<<(bool value);
-			Writer& operator<<(int index);
-			Writer& operator<<(const VariableIndex& index);
-			Writer& operator<<(const Symbol& symbol);
+			Writer& operator<<(Value value);
 
 		private:
-			std::vector<VariableIndex>& m_variableIndices;
+			CTranslator& m_translator;
 			FILE* m_outFile = nullptr;
 			int m_indent = 0;
 		};
 
 		Writer m_writer;
 
-		int pushIndex(const Symbol& symbol);
-		int pushIndex(const Type& type);
-		VariableIndex popIndex();
-		void destroyIndex(const VariableIndex& index);
+		Value getOperand(uint32_t index, uint32_t operand) const { return { m_function.getOperand(index, operand) }; }
+
+		// the strings a concatenation chain joins, in order
+		void findParts(uint32_t index, std::vector<Value>& parts);
 	};
 
 }
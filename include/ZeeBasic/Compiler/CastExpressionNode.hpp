@@ -36,7 +36,7 @@ namespace ZeeBasic::Compiler::Nodes
 		public ExpressionNode
 	{
 	public:
-		CastExpressionNode(int castType, std::unique_ptr<ExpressionNode> expr);
+		CastExpressionNode(int castType, ExpressionNode* expr);
 
 		void parse(IParser& parser) override;
 		void translate(ITranslator& translator) const override;
@@ -44,7 +44,7 @@ namespace ZeeBasic::Compiler::Nodes
 		const auto& getExpression() const { return *m_expr; }
 
 	private:
-		std::unique_ptr<ExpressionNode> m_expr;
+		ExpressionNode* m_expr;
 	};
 
 }
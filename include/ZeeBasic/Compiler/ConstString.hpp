@@ -29,6 +29,9 @@
 namespace ZeeBasic::Compiler
 {
 
+    // Immutable, length-delimited piece of text. The text is either copied into a shared arena, or viewed in place
+    // when the owner of the text guarantees it outlives the string. Viewed text is not null-terminated, so always
+    // respect getLength() when reading it.
     class ConstString
     {
     public:
@@ -36,6 +39,9 @@ namespace ZeeBasic::Compiler
         ConstString(const char* text, int length);
         ~ConstString();
 
+        // Reference existing text without copying it.
+        static ConstString view(const char* text, int length);
+
         ConstString(const ConstString&) = default;
         ConstString(ConstString&&) = default;
         ConstString& operator=(const ConstString&) = default;
@@ -52,6 +58,9 @@ namespace ZeeBasic::Compiler
     private:
         const char* m_text;
         int m_length;
+
+        struct ViewTag { };
+        ConstString(ViewTag, const char* text, int length);
     };
 
 }
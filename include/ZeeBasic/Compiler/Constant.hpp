@@ -0,0 +1,58 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+
+#include "BinaryExpressionNode.hpp"
+#include "ConstString.hpp"
+#include "Type.hpp"
+#include "UnaryExpressionNode.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// A value known at compile time.
+	struct Constant
+	{
+		int base;
+		int64_t integer;		// booleans as 0 or 1
+		double real;
+		ConstString text;		// reals as written, and strings
+	};
+
+	// Evaluate operations on constants the way the C the translator generates would at run time. Each returns false,
+	// leaving the operation for run time, when the result would overflow, divide by zero or lose its value in a literal.
+	bool evaluateUnary(Nodes::UnaryExpressionNode::Operator op, const Type& type, const Constant& operand, Constant& result);
+	bool evaluateBinary(Nodes::BinaryExpressionNode::Operator op, const Type& type, const Constant& lhs, const Constant& rhs, Constant& result);
+	bool evaluateCast(const Type& type, const Constant& operand, Constant& result);
+
+	// Shortest text that reads back as the same double, always with a decimal point or exponent.
+	ConstString formatReal(double value);
+	double parseReal(const ConstString& text);
+
+}
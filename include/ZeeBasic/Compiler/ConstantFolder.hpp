@@ -0,0 +1,83 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Constant.hpp"
+#include "FlatAst.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Folds constant expressions and simple algebraic identities in the flat form of a program, and replaces uses of
+	// CONST symbols with their values. Folding follows the semantics of the C the translator generates; anything that
+	// would overflow, divide by zero or lose its value in a literal is left for run time.
+	//
+	// The program is copied node by node. Children come right before their parent, so when an operation's operands
+	// turn out to be literals they are the last nodes of the copy, and are dropped and replaced by the result.
+	class ConstantFolder
+	{
+	public:
+		ConstantFolder(const FlatAst& ast);
+		~ConstantFolder();
+
+		FlatAst run();
+
+	private:
+		// start of a subtree that is a single node
+		static constexpr uint32_t kSelf = FlatAst::kNone;
+
+		const FlatAst& m_ast;
+		FlatAst m_folded;
+
+		// node of the copy for each node of the original
+		std::vector<uint32_t> m_map;
+
+		// first node of the subtree ending at each node of the copy, and whether that subtree is free of side effects
+		std::vector<uint32_t> m_starts;
+		std::vector<bool> m_pure;
+
+		std::unordered_map<const Symbol*, Constant> m_constants;
+
+		uint32_t fold(uint32_t index);
+		uint32_t foldUnary(uint32_t index);
+		uint32_t foldBinary(uint32_t index);
+		uint32_t foldCast(uint32_t index);
+		uint32_t foldFunctionCall(uint32_t index);
+		uint32_t foldAssignment(uint32_t index);
+
+		bool getValue(uint32_t folded, Constant& value) const;
+		uint32_t addValue(const Constant& value, SourceLocation location);
+
+		uint32_t added(uint32_t folded, uint32_t start, bool pure);
+		void drop(uint32_t count);
+	};
+
+}
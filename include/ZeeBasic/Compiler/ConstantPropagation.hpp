@@ -0,0 +1,85 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Constant.hpp"
+#include "Ir.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Sparse conditional constant propagation, after Wegman and Zadeck. Every value starts out unknown and only moves
+	// towards varying, and only the edges a branch can take are followed, so a value is constant when every definition
+	// reaching it along those edges is the same constant, through phis and loops alike. Afterwards, constant values are
+	// replaced by constants, branches on constants become jumps and blocks that cannot be reached are emptied.
+	class ConstantPropagation
+	{
+	public:
+		ConstantPropagation(Ir::Function& function);
+		~ConstantPropagation();
+
+		void run();
+
+	private:
+		enum class State : uint8_t
+		{
+			Unknown,
+			Constant,
+			Varying
+		};
+
+		Ir::Function& m_function;
+
+		std::vector<State> m_states;
+		std::vector<Constant> m_values;
+
+		// instructions using each value
+		std::vector<std::vector<uint32_t>> m_users;
+
+		// blocks reached, and for each block which of its incoming edges can be taken, in predecessor order
+		std::vector<bool> m_reached;
+		std::vector<std::vector<bool>> m_taken;
+
+		std::vector<std::pair<uint32_t, uint32_t>> m_edgeWorklist;
+		std::vector<uint32_t> m_valueWorklist;
+
+		void visit(uint32_t index);
+		void visitPhi(uint32_t index);
+		void visitOperation(uint32_t index);
+		void visitBranch(uint32_t index);
+
+		void takeEdge(uint32_t from, uint32_t to);
+		void setState(uint32_t index, State state, const Constant& value = {});
+
+		void rewrite();
+	};
+
+}
@@ -0,0 +1,59 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Ir.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Removes instructions whose values nothing needs. Output, control flow and builtins with side effects are needed,
+	// along with whatever values they use, transitively; everything else goes. Releasing a string is not a use of it,
+	// so a string that is made, perhaps assigned to a variable that is never read, and released is removed together
+	// with its release.
+	class DeadCodeElimination
+	{
+	public:
+		DeadCodeElimination(Ir::Function& function);
+		~DeadCodeElimination();
+
+		void run();
+
+	private:
+		Ir::Function& m_function;
+
+		std::vector<bool> m_live;
+		std::vector<uint32_t> m_worklist;
+
+		bool isNeeded(uint32_t index) const;
+		void markLive(uint32_t index);
+	};
+
+}
@@ -27,7 +27,10 @@
 #pragma once
 
 #include <stdexcept>
+#include <string>
+
 #include "Range.hpp"
+#include "SourceLocation.hpp"
 
 namespace ZeeBasic::Compiler
 {
@@ -39,14 +42,27 @@ namespace ZeeBasic::Compiler
     public:
         static Error create(const Range& range, const char* format, ...);
 
+        // Create an error at a source location, whose line and column are only shown once the error is resolved.
+        static Error create(SourceLocation location, const char* format, ...);
+
         virtual ~Error();
 
+        const char* what() const noexcept override { return m_message.c_str(); }
+
+        SourceLocation getLocation() const { return m_location; }
         const Range& getRange() const { return m_range; }
 
+        // Set the line and column of the error location, which prefix the message from then on.
+        void resolve(const Range& range);
+        bool isResolved() const { return m_range.startLine > 0; }
+
     private:
+        SourceLocation m_location;
         Range m_range;
+        std::string m_text;
+        std::string m_message;
 
-        Error(const Range& range, const char* msg);
+        Error(SourceLocation location, const Range& range, const char* text);
     };
 
 }
@@ -26,8 +26,6 @@
 
 #pragma once
 
-#include <memory>
-
 #include "Node.hpp"
 #include "Type.hpp"
 
@@ -39,7 +37,7 @@ namespace ZeeBasic::Compiler::Nodes
 		public Node
 	{
 	public:
-		static std::unique_ptr<ExpressionNode> parseExpression(IParser& parser, int prec = 0);
+		static ExpressionNode* parseExpression(IParser& parser, int prec = 0);
 
 		const auto& getType() const { return m_type; }
 
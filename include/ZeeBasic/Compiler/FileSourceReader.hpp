@@ -30,6 +30,7 @@
 #include <string>
 
 #include "ISourceReader.hpp"
+#include "LineIndex.hpp"
 
 namespace ZeeBasic::Compiler
 {
@@ -47,12 +48,16 @@ namespace ZeeBasic::Compiler
         FileSourceReader& operator=(FileSourceReader&) = delete;
         FileSourceReader& operator=(FileSourceReader&&) = default;
 
-        // Get the current read position for the next character within the stream.
-        void getReadPosition(int& lineNo, int& colNo) override { lineNo = m_lineNo; colNo = m_colNo; }
-
         // Read the next character in the source stream, or a 0 if the stream is complete.
         char readNextChar() override;
 
+        // Get the entire file contents, which remain valid for the lifetime of the reader.
+        const char* getData() const override { return m_data.get(); }
+        size_t getSize() const override { return m_size; }
+
+        // Get the line and column of a location, indexing the lines of the file the first time this is called.
+        Range getRange(SourceLocation location) const override { return m_lines.getRange(location); }
+
     private:
         // data read from file
         size_t m_size;
@@ -60,8 +65,8 @@ namespace ZeeBasic::Compiler
 
         // current read position
         size_t m_offset;
-        int m_lineNo;
-        int m_colNo;
+
+        LineIndex m_lines;
     };
 
 }
@@ -0,0 +1,142 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BinaryExpressionNode.hpp"
+#include "Builtins.hpp"
+#include "ConstString.hpp"
+#include "SourceLocation.hpp"
+#include "Symbol.hpp"
+#include "Type.hpp"
+#include "UnaryExpressionNode.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Flat form of a parsed program that the translator and later passes run over. Nodes live in parallel arrays and
+	// refer to their children by 32-bit index instead of by pointer, with types and locations in side tables and
+	// literal values, symbols and call arguments in pools. Children always come before their parents and statements
+	// are in program order, so a pass that only needs each child before its parent is one linear scan with a switch on
+	// the node kind.
+	class FlatAst
+	{
+	public:
+		enum class Kind : uint8_t
+		{
+			BooleanLiteral,		// value in first
+			IntegerLiteral,		// integer pool index in first
+			RealLiteral,		// text pool index in first
+			StringLiteral,		// text pool index in first
+			Identifier,			// symbol pool index in first
+			Unary,				// operand in first
+			Binary,				// operands in first and second
+			Cast,				// operand in first, cast to the node type
+			FunctionCall,		// builtin token in the operator, argument count then arguments in the argument pool from second
+			Assignment,			// symbol pool index in first, value in second
+			Print,				// value in first, or kNone
+		};
+
+		static constexpr uint32_t kNone = UINT32_MAX;
+
+		FlatAst();
+		~FlatAst();
+
+		FlatAst(const FlatAst&) = delete;
+		FlatAst(FlatAst&&) = default;
+		FlatAst& operator=(const FlatAst&) = delete;
+		FlatAst& operator=(FlatAst&&) = default;
+
+		// Flatten the statements of a parsed program.
+		static FlatAst build(const std::vector<Nodes::Node*>& statements);
+
+		// Add nodes, each after its children. Every function returns the index of the new node.
+		uint32_t addBooleanLiteral(bool value, SourceLocation location);
+		uint32_t addIntegerLiteral(int64_t value, SourceLocation location);
+		uint32_t addRealLiteral(const ConstString& text, SourceLocation location);
+		uint32_t addStringLiteral(const ConstString& text, SourceLocation location);
+		uint32_t addIdentifier(const Symbol& symbol, SourceLocation location);
+		uint32_t addUnary(Nodes::UnaryExpressionNode::Operator op, Type type, uint32_t operand, SourceLocation location);
+		uint32_t addBinary(Nodes::BinaryExpressionNode::Operator op, Type type, uint32_t lhs, uint32_t rhs, SourceLocation location);
+		uint32_t addCast(Type type, uint32_t operand, SourceLocation location);
+		uint32_t addFunctionCall(const Builtin& builtin, Type type, const std::vector<uint32_t>& arguments, SourceLocation location);
+
+		// Add statements, which are also recorded in program order.
+		uint32_t addAssignment(const Symbol& symbol, uint32_t value, SourceLocation location);
+		uint32_t addPrint(uint32_t value, SourceLocation location);
+
+		// Remove every node from count on, along with their pool entries, so that a pass can replace the most recently
+		// added nodes.
+		void truncate(uint32_t count);
+
+		size_t getCount() const { return m_kinds.size(); }
+		const std::vector<uint32_t>& getStatements() const { return m_statements; }
+
+		Kind getKind(uint32_t index) const { return m_kinds[index]; }
+		uint32_t getFirst(uint32_t index) const { return m_first[index]; }
+		uint32_t getSecond(uint32_t index) const { return m_second[index]; }
+		const Type& getType(uint32_t index) const { return m_types[index]; }
+		SourceLocation getLocation(uint32_t index) const { return m_locations[index]; }
+
+		auto getUnaryOperator(uint32_t index) const { return Nodes::UnaryExpressionNode::Operator(m_operators[index]); }
+		auto getBinaryOperator(uint32_t index) const { return Nodes::BinaryExpressionNode::Operator(m_operators[index]); }
+		const Builtin& getFunction(uint32_t index) const { return *getBuiltin(TokenId(m_operators[index])); }
+
+		// Payloads of literal, identifier, call and assignment nodes.
+		bool getBoolean(uint32_t index) const { return m_first[index] != 0; }
+		int64_t getInteger(uint32_t index) const { return m_integers[m_first[index]]; }
+		const ConstString& getText(uint32_t index) const { return m_texts[m_first[index]]; }
+		const Symbol& getSymbol(uint32_t index) const { return *m_symbols[m_first[index]]; }
+		uint32_t getArgumentCount(uint32_t index) const { return m_arguments[m_second[index]]; }
+		uint32_t getArgument(uint32_t index, uint32_t argument) const { return m_arguments[m_second[index] + 1 + argument]; }
+
+	private:
+		// per node
+		std::vector<Kind> m_kinds;
+		std::vector<uint8_t> m_operators;
+		std::vector<uint32_t> m_first;
+		std::vector<uint32_t> m_second;
+
+		// side tables
+		std::vector<Type> m_types;
+		std::vector<SourceLocation> m_locations;
+
+		// pools
+		std::vector<int64_t> m_integers;
+		std::vector<ConstString> m_texts;
+		std::vector<const Symbol*> m_symbols;
+		std::vector<uint32_t> m_arguments;
+
+		std::vector<uint32_t> m_statements;
+
+		uint32_t add(Kind kind, uint8_t op, uint32_t first, uint32_t second, Type type, SourceLocation location);
+	};
+
+}
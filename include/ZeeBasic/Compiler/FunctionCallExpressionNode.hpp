@@ -26,9 +26,9 @@
 
 #pragma once
 
-#include <memory>
 #include <vector>
 
+#include "Builtins.hpp"
 #include "ExpressionNode.hpp"
 
 namespace ZeeBasic::Compiler::Nodes
@@ -43,11 +43,13 @@ namespace ZeeBasic::Compiler::Nodes
 		void translate(ITranslator& translator) const override;
 
 		const auto& getName() const { return m_name; }
+		const auto& getBuiltin() const { return *m_builtin; }
 		const auto& getArguments() const { return m_arguments; }
 
 	private:
 		ConstString m_name;
-		std::vector<std::unique_ptr<ExpressionNode>> m_arguments;		
+		const Builtin* m_builtin = nullptr;
+		std::vector<ExpressionNode*> m_arguments;		
 	};
 
 }
@@ -33,6 +33,11 @@ namespace ZeeBasic::Compiler
 
 	class SymbolTable;
 
+	namespace Nodes
+	{
+		class NodeArena;
+	}
+
 	class IParser
 	{
 	public:
@@ -44,6 +49,7 @@ namespace ZeeBasic::Compiler
 		virtual void eatToken() = 0;
 		virtual void eatEndOfLine() = 0;
 		virtual SymbolTable& getSymbolTable() = 0;
+		virtual Nodes::NodeArena& getNodeArena() = 0;
 	};
 
 }
@@ -26,22 +26,33 @@
 
 #pragma once
 
+#include <cstddef>
+
+#include "Range.hpp"
+#include "SourceLocation.hpp"
+
 namespace ZeeBasic::Compiler
 {
 
-    // Interface class that provides a way for the lexical analyzer to read source code characters and position
-    // information.
+    // Interface class that provides a way for the lexical analyzer to read source code characters, and for errors to
+    // find the line and column of a location in them.
     class ISourceReader
     {
     public:
         ISourceReader() { }
         virtual ~ISourceReader() { }
 
-        // Get the current read position within the stream.
-        virtual void getReadPosition(int& lineNo, int& colNo) = 0;
-
         // Read the next character in the source stream, or a 0 if the stream is complete.
         virtual char readNextChar() = 0;
+
+        // Get the entire source as one contiguous buffer, or nullptr if the reader does not keep one. The buffer stays
+        // valid for the lifetime of the reader, so tokens may reference it instead of copying their text.
+        virtual const char* getData() const { return nullptr; }
+        virtual size_t getSize() const { return 0; }
+
+        // Get the line and column of a location (the number of characters read before it), or an empty range if the
+        // reader cannot tell.
+        virtual Range getRange(SourceLocation location) const { (void)location; return {}; }
     };
 
 }
@@ -0,0 +1,68 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ConstString.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Case-insensitive table of identifiers. Each distinct name is copied once and given a small dense id, so that two
+	// names can be compared by id instead of by text, and per-name data can be kept in arrays indexed by the id.
+	class IdentifierTable
+	{
+	public:
+		IdentifierTable();
+		~IdentifierTable();
+
+		// Get the id of a name, adding the name if it is new. Names that only differ in case share an id.
+		int intern(const ConstString& name);
+
+		// Get the id of a name, or -1 if it has never been interned.
+		int find(const ConstString& name) const;
+
+		// Get a name as it was spelled when first interned.
+		const ConstString& getName(int id) const { return m_names[id]; }
+
+		int getCount() const { return int(m_names.size()); }
+
+	private:
+		std::vector<ConstString> m_names;
+		std::vector<uint32_t> m_hashes;
+
+		// open addressed slots holding id + 1, with 0 marking an empty slot
+		std::vector<int> m_slots;
+
+		size_t findSlot(const ConstString& name, uint32_t hash) const;
+		void grow();
+	};
+
+}
@@ -0,0 +1,173 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BinaryExpressionNode.hpp"
+#include "Builtins.hpp"
+#include "Constant.hpp"
+#include "ConstString.hpp"
+#include "Type.hpp"
+#include "UnaryExpressionNode.hpp"
+
+namespace ZeeBasic::Compiler::Ir
+{
+
+	enum class Opcode : uint8_t
+	{
+		// constants
+		Constant,			// boolean or integer value in the integer pool, real text in the text pool
+
+		// strings, each of which is owned by exactly one value until it is released
+		StringLiteral,		// new string with the text in the text pool
+		StringEmpty,		// new empty string
+		StringCopy,			// new string with the text of the operand
+		StringRelease,		// frees the operand
+
+		// operations
+		Unary,				// operator and one operand
+		Binary,				// operator and two operands
+		Cast,				// one operand, converted to the instruction type
+		Call,				// builtin token in the operator, arguments as operands
+		Phi,				// one operand for each predecessor of the block, in the same order
+
+		// statements
+		Print,				// operand, or none for an empty line
+
+		// terminators
+		Jump,				// to the only successor
+		Branch,				// on the operand, to the first successor if true and the second if false
+		Return,
+
+		// left behind by a pass, and skipped by everything else
+		Removed
+	};
+
+	struct Instruction
+	{
+		Opcode opcode;
+		uint8_t op;					// operator or builtin token
+		Type type;					// unknown for instructions without a value
+		uint32_t block;
+		uint32_t operands;			// start in the operand pool
+		uint32_t operandCount;
+		uint32_t payload;			// pool index of a constant or literal
+	};
+
+	struct Block
+	{
+		std::vector<uint32_t> instructions;			// phis first, then the body, then one terminator
+		std::vector<uint32_t> predecessors;
+		std::vector<uint32_t> successors;
+	};
+
+	// A program as a function in SSA form. Every instruction that has a type defines one value, named by the index of
+	// the instruction, and every value is defined once. Blocks of instructions end in a terminator and are connected
+	// by edges; where values from different edges meet, a phi picks the one for the edge taken.
+	class Function
+	{
+	public:
+		static constexpr uint32_t kNone = UINT32_MAX;
+
+		Function();
+		~Function();
+
+		Function(const Function&) = delete;
+		Function(Function&&) = default;
+		Function& operator=(const Function&) = delete;
+		Function& operator=(Function&&) = default;
+
+		uint32_t createBlock();
+		void addEdge(uint32_t from, uint32_t to);
+
+		// Remove an edge, along with the operand each phi of the target block took from it.
+		void removeEdge(uint32_t from, uint32_t to);
+
+		// Append an instruction to a block, or insert it before the block's terminator if it already has one.
+		uint32_t append(uint32_t block, Opcode opcode, uint8_t op, Type type, const uint32_t* operands, uint32_t operandCount, uint32_t payload = kNone);
+
+		// Insert a phi at the start of a block, with its operands to be set once the predecessors are known.
+		uint32_t insertPhi(uint32_t block, Type type);
+		void setPhiOperands(uint32_t phi, const std::vector<uint32_t>& operands);
+
+		uint32_t addInteger(int64_t value);
+		uint32_t addText(const ConstString& text);
+
+		// Point every use of a value at another value, and take an instruction out of its block.
+		void replaceAllUses(uint32_t from, uint32_t to);
+		void remove(uint32_t instruction);
+
+		// Take every flagged instruction out of its block, in a single pass over the blocks.
+		void remove(const std::vector<bool>& removed);
+
+		// Turn an instruction into a constant, or a literal for a string, in place.
+		void replaceWithConstant(uint32_t instruction, const Constant& value);
+
+		// Turn a branch into a jump to one of its targets, removing the edge to the other.
+		void replaceWithJump(uint32_t branch, uint32_t target);
+
+		size_t getInstructionCount() const { return m_instructions.size(); }
+		const Instruction& getInstruction(uint32_t index) const { return m_instructions[index]; }
+
+		size_t getBlockCount() const { return m_blocks.size(); }
+		const Block& getBlock(uint32_t index) const { return m_blocks[index]; }
+
+		uint32_t getOperand(uint32_t instruction, uint32_t operand) const { return m_operands[m_instructions[instruction].operands + operand]; }
+		void setOperand(uint32_t instruction, uint32_t operand, uint32_t value) { m_operands[m_instructions[instruction].operands + operand] = value; }
+
+		// Payloads of constants, literals and calls.
+		int64_t getInteger(uint32_t instruction) const { return m_integers[m_instructions[instruction].payload]; }
+		const ConstString& getText(uint32_t instruction) const { return m_texts[m_instructions[instruction].payload]; }
+		auto getUnaryOperator(uint32_t instruction) const { return Nodes::UnaryExpressionNode::Operator(m_instructions[instruction].op); }
+		auto getBinaryOperator(uint32_t instruction) const { return Nodes::BinaryExpressionNode::Operator(m_instructions[instruction].op); }
+		const Builtin& getFunction(uint32_t instruction) const { return *getBuiltin(TokenId(m_instructions[instruction].op)); }
+
+		bool isTerminator(uint32_t instruction) const;
+
+		// Blocks reachable from the entry block, each after the blocks that dominate it.
+		std::vector<uint32_t> getReversePostorder() const;
+
+		// Immediate dominator of each block, with the entry block as its own and kNone for blocks that cannot be reached.
+		std::vector<uint32_t> getImmediateDominators() const;
+
+		// Text form of the function, one instruction to a line, for tests and debugging.
+		std::string dump() const;
+
+	private:
+		std::vector<Instruction> m_instructions;
+		std::vector<Block> m_blocks;
+
+		// pools
+		std::vector<uint32_t> m_operands;
+		std::vector<int64_t> m_integers;
+		std::vector<ConstString> m_texts;
+	};
+
+}
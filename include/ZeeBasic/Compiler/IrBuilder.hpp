@@ -0,0 +1,107 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Ir.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Appends instructions to a function and keeps it in SSA form while it is built. Variables are written and read
+	// by number; a read finds the value last written in the block, or looks through the predecessors and adds phis
+	// where values from several edges meet. A block is sealed once all of its predecessors are known, and phis for
+	// reads made before that are completed when it is. Based on "Simple and Efficient Construction of Static Single
+	// Assignment Form" (Braun et al.), which needs no dominance information.
+	class IrBuilder
+	{
+	public:
+		IrBuilder(Ir::Function& function);
+		~IrBuilder();
+
+		uint32_t createBlock() { return m_function.createBlock(); }
+		void setBlock(uint32_t block) { m_block = block; }
+		uint32_t getBlock() const { return m_block; }
+		void sealBlock(uint32_t block);
+
+		void writeVariable(uint32_t variable, uint32_t value);
+		uint32_t readVariable(uint32_t variable, const Type& type);
+
+		uint32_t constant(bool value);
+		uint32_t constant(int64_t value);
+		uint32_t constantReal(const ConstString& text);
+
+		uint32_t stringLiteral(const ConstString& text);
+		uint32_t stringEmpty();
+		uint32_t stringCopy(uint32_t value);
+		void stringRelease(uint32_t value);
+
+		uint32_t unary(Nodes::UnaryExpressionNode::Operator op, const Type& type, uint32_t operand);
+		uint32_t binary(Nodes::BinaryExpressionNode::Operator op, const Type& type, uint32_t lhs, uint32_t rhs);
+		uint32_t cast(const Type& type, uint32_t operand);
+		uint32_t call(const Builtin& builtin, const Type& type, const std::vector<uint32_t>& arguments);
+
+		void print(uint32_t value);
+
+		void jump(uint32_t target);
+		void branch(uint32_t condition, uint32_t whenTrue, uint32_t whenFalse);
+		void ret();
+
+	private:
+		Ir::Function& m_function;
+		uint32_t m_block = 0;
+
+		// value of each variable at the end of each block, keyed by block and variable
+		std::unordered_map<uint64_t, uint32_t> m_definitions;
+
+		// phis waiting for a block to be sealed
+		struct IncompletePhi
+		{
+			uint32_t block;
+			uint32_t variable;
+			uint32_t phi;
+		};
+		std::vector<IncompletePhi> m_incompletePhis;
+
+		std::vector<bool> m_sealed;
+		std::vector<Type> m_variableTypes;
+
+		void writeVariable(uint32_t variable, uint32_t block, uint32_t value);
+		uint32_t readVariable(uint32_t variable, uint32_t block);
+		uint32_t readVariableRecursive(uint32_t variable, uint32_t block);
+		uint32_t addPhiOperands(uint32_t variable, uint32_t phi);
+		uint32_t tryRemoveTrivialPhi(uint32_t phi);
+		uint32_t createDefault(uint32_t variable, uint32_t block);
+
+		bool isSealed(uint32_t block) const { return block < m_sealed.size() && m_sealed[block]; }
+		uint32_t append(Ir::Opcode opcode, uint8_t op, const Type& type, std::initializer_list<uint32_t> operands, uint32_t payload = Ir::Function::kNone);
+	};
+
+}
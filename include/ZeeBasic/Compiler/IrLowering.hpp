@@ -0,0 +1,71 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "FlatAst.hpp"
+#include "Ir.hpp"
+#include "IrBuilder.hpp"
+#include "SymbolTable.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Lowers the flat form of a program to SSA form. Variables become values, with each assignment defining a new one,
+	// and the lifetime of every string is made explicit: a string made by an expression is owned by whatever consumes
+	// it and released right after, unless it is assigned, in which case the variable takes it over until the next
+	// assignment or the end of the program. Assigning another variable's string copies it.
+	class IrLowering
+	{
+	public:
+		IrLowering(const FlatAst& ast, const SymbolTable& symbols);
+		~IrLowering();
+
+		Ir::Function run();
+
+	private:
+		const FlatAst& m_ast;
+		const SymbolTable& m_symbols;
+
+		Ir::Function m_function;
+		IrBuilder m_builder;
+
+		// value of each flat node, and whether it is a string its consumer must release
+		std::vector<uint32_t> m_values;
+		std::vector<bool> m_owned;
+
+		// string variables holding a string, by symbol index
+		std::vector<bool> m_holdsString;
+
+		void lower(uint32_t index);
+		void lowerAssignment(uint32_t index);
+		void release(uint32_t node);
+	};
+
+}
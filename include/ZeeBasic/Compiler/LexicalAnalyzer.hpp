@@ -26,19 +26,34 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "ISourceReader.hpp"
+#include "SourceScanner.hpp"
 #include "Token.hpp"
 
 namespace ZeeBasic::Compiler
 {
 
-    // Class that handles parsing source code into a stream of tokens for the compiler.
+    // Class that handles parsing source code into a stream of tokens for the compiler. Sources that are available as
+    // one contiguous buffer are lexed by a table-driven state machine, and their tokens reference the buffer directly
+    // instead of copying their text. Other sources are read one character at a time.
     class LexicalAnalyzer
     {
     public:
         LexicalAnalyzer(ISourceReader& sourceReader);
+
+        // Lex a contiguous buffer, which must outlive the tokens produced from it.
+        LexicalAnalyzer(const char* data, size_t size);
+
+        // Lex a contiguous buffer, scanning whitespace, comments and strings with a specific instruction set.
+        LexicalAnalyzer(const char* data, size_t size, ScanLevel scanLevel);
+
+        // Lex the lines in [begin, end) of the contiguous buffer that starts at source, where begin is the start of a
+        // line. Tokens match those produced for the same lines when lexing the whole buffer.
+        LexicalAnalyzer(const char* source, const char* begin, const char* end, ScanLevel scanLevel);
+
         ~LexicalAnalyzer();
 
         // Returns a token with an id of TokenId::EndOfCode when there is no more code to parse.
@@ -61,17 +76,30 @@ namespace ZeeBasic::Compiler
         };
         State m_state;
 
-        // current character being analyzed
+        // current character being analyzed, and the number of characters read up to and including it
         char m_ch;
-        int m_lineNo;
-        int m_colNo;
+        uint32_t m_offset;
 
         // start of current token being parsed
-        Range m_range;
+        SourceLocation m_location;
 
-        // contents of token text;
+        // contents of token text
+        char m_first;
+        int m_length;
         std::string m_text;
 
+        // source buffer being lexed by the state machine (null when reading characters from m_sourceReader)
+        const char* m_begin;
+        const char* m_cursor;
+        const char* m_end;
+        const SourceScanner* m_scanner;
+
+        // parse next token with the state machine
+        Token parseNextBufferToken();
+
+        // read the next character from m_sourceReader, counting it
+        char readNextChar();
+
         // determine what type of token the character starts
         State getTokenStartState(char ch);
 
@@ -0,0 +1,73 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Range.hpp"
+#include "SourceLocation.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    // Maps source locations back to line and column numbers. The offsets of the line starts are only found the first
+    // time a location is resolved, which normally happens just once to report an error, so compiling a correct
+    // program never pays for them.
+    class LineIndex
+    {
+    public:
+        LineIndex();
+
+        // Index a contiguous source, which must outlive the index.
+        LineIndex(const char* data, size_t size);
+
+        ~LineIndex();
+
+        LineIndex(const LineIndex&) = delete;
+        LineIndex(LineIndex&&) = default;
+        LineIndex& operator=(const LineIndex&) = delete;
+        LineIndex& operator=(LineIndex&&) = default;
+
+        // Get the line and column (both counted from 1) of a location. Locations past the end give the end.
+        Range getRange(SourceLocation location) const;
+
+        // Get the number of lines in the source. A newline always starts another line, even at the end of the source.
+        int getLineCount() const;
+
+    private:
+        const char* m_data;
+        size_t m_size;
+
+        // offsets of the first character of every line
+        mutable std::vector<uint32_t> m_lineStarts;
+
+        void build() const;
+    };
+
+}
@@ -0,0 +1,78 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <string>
+
+#include "ISourceReader.hpp"
+#include "LineIndex.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    // Source reader that maps the file into memory instead of reading it. Tokens produced from this reader view their
+    // text directly inside the mapping, so the reader must outlive every token, symbol and node built from it.
+    class MappedSourceReader
+        :
+        public ISourceReader
+    {
+    public:
+        MappedSourceReader(const std::string& path);
+        ~MappedSourceReader();
+
+        MappedSourceReader(MappedSourceReader&) = delete;
+        MappedSourceReader(MappedSourceReader&& other);
+        MappedSourceReader& operator=(MappedSourceReader&) = delete;
+        MappedSourceReader& operator=(MappedSourceReader&&) = delete;
+
+        // Read the next character in the source stream, or a 0 if the stream is complete.
+        char readNextChar() override;
+
+        // Get the mapped file contents, which remain valid for the lifetime of the reader.
+        const char* getData() const override { return m_data; }
+        size_t getSize() const override { return m_size; }
+
+        // Get the line and column of a location, indexing the lines of the file the first time this is called.
+        Range getRange(SourceLocation location) const override { return m_lines.getRange(location); }
+
+    private:
+        // mapped file view (points at an empty string for empty files, which cannot be mapped)
+        size_t m_size;
+        const char* m_data;
+#ifdef _WIN32
+        void* m_mapping;
+#endif
+
+        // current read position
+        size_t m_offset;
+
+        LineIndex m_lines;
+
+        void unmap();
+    };
+
+}
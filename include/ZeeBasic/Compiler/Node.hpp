@@ -28,7 +28,7 @@
 
 #include "IParser.hpp"
 #include "ITranslator.hpp"
-#include "Range.hpp"
+#include "SourceLocation.hpp"
 
 namespace ZeeBasic::Compiler::Nodes
 {
@@ -39,13 +39,13 @@ namespace ZeeBasic::Compiler::Nodes
 		Node() { }
 		virtual ~Node() { }
 
-		const auto& getRange() const { return m_range; }
+		SourceLocation getLocation() const { return m_location; }
 
 		virtual void parse(IParser& parser) = 0;
 		virtual void translate(ITranslator& translator) const = 0;
 
 	protected:
-		Range m_range;
+		SourceLocation m_location;
 	};
 
 }
@@ -0,0 +1,99 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Node.hpp"
+
+namespace ZeeBasic::Compiler::Nodes
+{
+
+	// Owns every node of a program. Nodes are placed one after another in large blocks by bumping a pointer, instead of
+	// each being allocated on its own, and are released together with the arena. Nodes refer to each other through
+	// plain pointers, which stay valid for the lifetime of the arena.
+	class NodeArena
+	{
+	public:
+		static constexpr size_t kBlockSize = 64 * 1024;
+
+		NodeArena();
+		~NodeArena();
+
+		NodeArena(const NodeArena&) = delete;
+		NodeArena(NodeArena&&) = default;
+		NodeArena& operator=(const NodeArena&) = delete;
+		NodeArena& operator=(NodeArena&&) = default;
+
+		// Construct a node in the arena.
+		template<typename T, typename... Args>
+		T* create(Args&&... args)
+		{
+			static_assert(std::is_base_of_v<Node, T>, "the arena only holds nodes");
+
+			auto node = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+			m_nodes.push_back(node);
+			return node;
+		}
+
+		// Destroy every node, keeping the first block for reuse.
+		void clear();
+
+		size_t getNodeCount() const { return m_nodes.size(); }
+		size_t getBlockCount() const { return m_blocks.size(); }
+
+	private:
+		std::vector<std::unique_ptr<char[]>> m_blocks;
+
+		// free space in the last block
+		char* m_cursor;
+		char* m_end;
+
+		// nodes in creation order, so they can be destroyed without walking the blocks
+		std::vector<Node*> m_nodes;
+
+		void* allocate(size_t size, size_t alignment)
+		{
+			auto address = (reinterpret_cast<size_t>(m_cursor) + alignment - 1) & ~(alignment - 1);
+			if (!m_cursor || address + size > reinterpret_cast<size_t>(m_end))
+			{
+				return allocateBlock(size, alignment);
+			}
+
+			m_cursor = reinterpret_cast<char*>(address + size);
+			return reinterpret_cast<void*>(address);
+		}
+
+		void* allocateBlock(size_t size, size_t alignment);
+	};
+
+}
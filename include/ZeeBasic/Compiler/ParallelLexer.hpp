@@ -0,0 +1,66 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstddef>
+
+#include "SourceScanner.hpp"
+#include "TokenBuffer.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    // Lexes a large contiguous source on several threads. Every line starts in the same lexer state, because comments
+    // end at a newline and string literals may not contain one, so the source is split into chunks of whole lines
+    // that are lexed independently and then joined. The tokens view the source buffer, which must outlive them.
+    class ParallelLexer
+    {
+    public:
+        static constexpr size_t kDefaultChunkSize = 256 * 1024;
+
+        // A thread count of zero uses one thread per hardware thread.
+        ParallelLexer(const char* data, size_t size, unsigned threadCount = 0, size_t chunkSize = kDefaultChunkSize);
+        ~ParallelLexer();
+
+        ParallelLexer(ParallelLexer&) = delete;
+        ParallelLexer(ParallelLexer&&) = delete;
+        ParallelLexer& operator=(ParallelLexer&) = delete;
+        ParallelLexer& operator=(ParallelLexer&&) = delete;
+
+        // Lex the whole source, returning the same tokens as a single LexicalAnalyzer, up to and including the final
+        // TokenId::EndOfCode. When several chunks fail, the error that comes first in the source is thrown.
+        TokenBuffer run();
+
+    private:
+        const char* m_data;
+        size_t m_size;
+        unsigned m_threadCount;
+        size_t m_chunkSize;
+        ScanLevel m_scanLevel;
+    };
+
+}
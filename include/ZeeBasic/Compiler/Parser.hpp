@@ -26,11 +26,13 @@
 
 #pragma once
 
-#include <vector>
+#include <array>
+#include <cstddef>
 
 #include "IParser.hpp"
 #include "LexicalAnalyzer.hpp"
 #include "Token.hpp"
+#include "TokenBuffer.hpp"
 
 namespace ZeeBasic::Compiler
 {
@@ -53,13 +55,30 @@ namespace ZeeBasic::Compiler
 		void eatToken() override;
 		void eatEndOfLine() override;
 		SymbolTable& getSymbolTable() override;
+		Nodes::NodeArena& getNodeArena() override;
+
+		// Tokens further ahead than this can not be inspected.
+		static constexpr int kMaxLookAhead = 4;
 
 	private:
+		ISourceReader& m_source;
 		LexicalAnalyzer m_lexicalAnalyzer;
 
 		Program& m_program;
 
-		std::vector<Token> m_tokens;
+		// Sources that are available as one buffer are lexed up front into m_tokenBuffer, and m_cursor indexes the
+		// current token within it. Other sources are lexed one token at a time as the lookahead requires.
+		TokenBuffer m_tokenBuffer;
+		bool m_isPreTokenized;
+
+		// index of the current token, and of the first token not yet produced
+		size_t m_cursor;
+		size_t m_produced;
+
+		// ring of produced tokens from m_cursor on, indexed by token index
+		std::array<Token, kMaxLookAhead> m_tokens;
+
+		Token produceToken(size_t index);
 	};
 
 }
@@ -0,0 +1,62 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+
+namespace ZeeBasic::Compiler
+{
+
+	struct Program;
+
+	enum Pass : uint32_t
+	{
+		Pass_ConstantPropagation = 1 << 0,
+		Pass_ValueNumbering = 1 << 1,
+		Pass_DeadCodeElimination = 1 << 2,
+
+		Pass_None = 0,
+		Pass_All = Pass_ConstantPropagation | Pass_ValueNumbering | Pass_DeadCodeElimination
+	};
+
+	// Takes a parsed program to the form the translators read. The statements are flattened and folded, which always
+	// happens as CONST symbols only get their values from folding, then lowered to SSA form, which the chosen passes
+	// optimize in order.
+	class Pipeline
+	{
+	public:
+		Pipeline(Program& program, uint32_t passes = Pass_All);
+		~Pipeline();
+
+		void run();
+
+	private:
+		Program& m_program;
+		uint32_t m_passes;
+	};
+
+}
@@ -26,8 +26,6 @@
 
 #pragma once
 
-#include <memory>
-
 #include "Node.hpp"
 
 namespace ZeeBasic::Compiler::Nodes
@@ -46,10 +44,10 @@ namespace ZeeBasic::Compiler::Nodes
 		void parse(IParser& parser) override;
 		void translate(ITranslator& translator) const override;
 
-		const auto getExpression() const { return m_expr.get(); }
+		const auto getExpression() const { return m_expr; }
 
 	private:
-		std::unique_ptr<ExpressionNode> m_expr;
+		ExpressionNode* m_expr;
 	};
 
 }
@@ -26,10 +26,12 @@
 
 #pragma once
 
-#include <memory>
 #include <vector>
 
+#include "FlatAst.hpp"
+#include "Ir.hpp"
 #include "Node.hpp"
+#include "NodeArena.hpp"
 #include "SymbolTable.hpp"
 
 namespace ZeeBasic::Compiler
@@ -37,8 +39,13 @@ namespace ZeeBasic::Compiler
 
 	struct Program
 	{
-		std::vector<std::unique_ptr<Nodes::Node>> statements;
+		Nodes::NodeArena nodes;
+		std::vector<Nodes::Node*> statements;
 		SymbolTable symbols;
+
+		// statements flattened and folded by the pipeline, then lowered to SSA form for the backends
+		FlatAst ast;
+		Ir::Function ir;
 	};
 
 }
@@ -26,8 +26,6 @@
 
 #pragma once
 
-#include <cstdint>
-
 namespace ZeeBasic::Compiler
 {
 
@@ -50,10 +48,10 @@ namespace ZeeBasic::Compiler
         Range& operator=(const Range&) = default;
         Range& operator=(Range&&) = default;
 
-        uint64_t startCol : 8;
-        uint64_t endCol : 8;
-        uint64_t startLine : 24;
-        uint64_t endLine : 24;
+        int startCol;
+        int endCol;
+        int startLine;
+        int endLine;
 
         Range& operator+=(const Range& rhs)
         {
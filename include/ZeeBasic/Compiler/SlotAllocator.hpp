@@ -0,0 +1,90 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Ir.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Assigns the values of a function that need a C variable to a small set of slots, one set for each type, that are
+	// declared once and reused. Two values share a slot only if they are never live at the same time. Liveness comes
+	// from the usual backward data flow over the blocks, with a phi's operands used at the end of their edges, and the
+	// values are then coloured in dominator order, which for SSA needs no more slots than are ever live at once.
+	//
+	// A value written out inside the expression that uses it has no slot, and its operands are used where that
+	// expression finally is. A string never takes the slot of a string it is made from, so that the runtime can build
+	// it in place without reading what it overwrites, except that a concatenation whose first part is used for the last
+	// time takes that part's slot and is built by appending the rest to it.
+	class SlotAllocator
+	{
+	public:
+		static constexpr uint32_t kNone = Ir::Function::kNone;
+
+		SlotAllocator(const Ir::Function& function, const std::vector<bool>& inlined);
+		~SlotAllocator();
+
+		void run();
+
+		// slot of a value, numbered within its type
+		uint32_t getSlot(uint32_t value) const { return m_slots[value]; }
+		uint32_t getSlotCount(int base) const { return m_slotCounts[base]; }
+
+		// whether a concatenation is in the slot of its first part, so only the other parts need to be appended
+		bool isAppend(uint32_t value) const { return m_appends[value]; }
+
+		// strings used for the last time by an instruction, whose slots can let go of their text once it has run
+		const std::vector<uint32_t>& getReleases(uint32_t index) const;
+
+	private:
+		const Ir::Function& m_function;
+		const std::vector<bool>& m_inlined;
+
+		std::vector<uint32_t> m_slots;
+		std::vector<bool> m_appends;
+		std::unordered_map<uint32_t, std::vector<uint32_t>> m_releases;
+		uint32_t m_slotCounts[BaseType_Udt] = {};
+
+		// the instruction where each instruction is written out, which for an inlined one is where its user is
+		std::vector<uint32_t> m_anchors;
+
+		// values live on entry to and exit from each block, sorted
+		std::vector<std::vector<uint32_t>> m_liveIn;
+		std::vector<std::vector<uint32_t>> m_liveOut;
+
+		bool needsSlot(uint32_t value) const;
+		uint32_t findAppendedPart(uint32_t value) const;
+		void findAnchors();
+		void computeLiveness();
+		void assignSlots(uint32_t block, std::vector<std::vector<bool>>& used);
+	};
+
+}
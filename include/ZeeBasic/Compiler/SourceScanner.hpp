@@ -0,0 +1,66 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+namespace ZeeBasic::Compiler
+{
+
+    // Instruction sets the source scanner can use, from slowest to fastest.
+    enum class ScanLevel
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+    };
+
+    // Routines that skip over the runs of source text that the lexer either discards (whitespace and comments) or
+    // takes verbatim (string literals), a whole block of characters at a time. Each routine returns the first
+    // character in [cursor, end) that stops the run, or end when there is none, and never reads outside that range.
+    struct SourceScanner
+    {
+        ScanLevel level;
+
+        // Skip spaces and tabs.
+        const char* (*skipBlanks)(const char* cursor, const char* end);
+
+        // Find the newline or null character that ends a comment.
+        const char* (*findLineEnd)(const char* cursor, const char* end);
+
+        // Find the quote, newline or null character that ends a string literal.
+        const char* (*findStringEnd)(const char* cursor, const char* end);
+
+        // Get the best level supported by the processor running the compiler.
+        static ScanLevel getBestLevel();
+
+        // Get the scanner for the best supported level.
+        static const SourceScanner& get();
+
+        // Get the scanner for a level, falling back to the best supported level below it.
+        static const SourceScanner& get(ScanLevel level);
+    };
+
+}
@@ -26,8 +26,6 @@
 
 #pragma once
 
-#include <memory>
-
 namespace ZeeBasic::Compiler
 {
 	class IParser;
@@ -37,6 +35,6 @@ namespace ZeeBasic::Compiler::Nodes
 {
 	class Node;
 
-	std::unique_ptr<Node> parseStatement(IParser& parser);
+	Node* parseStatement(IParser& parser);
 
 }
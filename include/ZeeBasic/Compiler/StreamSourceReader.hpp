@@ -0,0 +1,93 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "ISourceReader.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    // Source reader for streams that cannot be seeked or mapped, such as pipes and standard input. The stream is read
+    // a chunk at a time into a pair of buffers: characters come from the current buffer, and once it is used up the
+    // other buffer is refilled with the next chunk and the two swap roles. Memory use depends only on the chunk size,
+    // however long the stream is. The source is never contiguous, so the lexer reads it a character at a time and
+    // copies token text, which keeps tokens that span two chunks whole. Those copies live in the ConstString arena and
+    // are not covered by the bound: they grow with the number of tokens lexed.
+    class StreamSourceReader
+        :
+        public ISourceReader
+    {
+    public:
+        static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+        // Read from an open file descriptor, which stays owned by the caller.
+        StreamSourceReader(int fd, size_t chunkSize = kDefaultChunkSize);
+        ~StreamSourceReader();
+
+        StreamSourceReader(StreamSourceReader&) = delete;
+        StreamSourceReader(StreamSourceReader&&) = default;
+        StreamSourceReader& operator=(StreamSourceReader&) = delete;
+        StreamSourceReader& operator=(StreamSourceReader&&) = default;
+
+        // Read the next character in the source stream, or a 0 if the stream is complete.
+        char readNextChar() override;
+
+        // Get the line and column of a location in the two chunks still buffered, which covers the tokens the parser
+        // is looking at when it reports an error. Older locations give an empty range.
+        Range getRange(SourceLocation location) const override;
+
+    private:
+        struct Chunk
+        {
+            std::unique_ptr<char[]> data;
+            size_t size;
+
+            // stream offset, line and column of the first character
+            uint64_t offset;
+            int lineNo;
+            int colNo;
+        };
+
+        int m_fd;
+        size_t m_chunkSize;
+        std::array<Chunk, 2> m_chunks;
+        int m_current;
+        bool m_isEnd;
+
+        // unread characters of the current chunk
+        const char* m_cursor;
+        const char* m_end;
+
+        // read the next chunk into the other buffer and make it current, or return false at the end of the stream
+        bool refill();
+    };
+
+}
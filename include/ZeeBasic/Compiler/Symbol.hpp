@@ -27,7 +27,7 @@
 #pragma once
 
 #include "ConstString.hpp"
-#include "Range.hpp"
+#include "SourceLocation.hpp"
 #include "Type.hpp"
 
 namespace ZeeBasic::Compiler
@@ -36,11 +36,14 @@ namespace ZeeBasic::Compiler
 	struct Symbol
 	{
 		int index;
+		int identifier;
+		int scope;
 		ConstString name;
-		Range range;
+		SourceLocation location;
 		Type type;
+		bool isConstant = false;		// declared by CONST, so its uses are replaced by its value
 
-		Symbol(int index, const ConstString& name, const Range& range, Type type) : index(index), name(name), range(range), type(type) { }
+		Symbol(int index, int identifier, int scope, const ConstString& name, SourceLocation location, Type type) : index(index), identifier(identifier), scope(scope), name(name), location(location), type(type) { }
 	};
 
 }
@@ -28,21 +28,66 @@
 
 #include <memory>
 #include <vector>
+#include "IdentifierTable.hpp"
 #include "Symbol.hpp"
 
 namespace ZeeBasic::Compiler
 {
 
+	// Table of every symbol in a program, kept in the order the symbols were declared. Names are resolved through an
+	// array indexed by identifier id that holds the innermost visible symbol for each name, so lookups take the same
+	// time however many symbols exist. Scopes nest; a symbol declared in a scope hides symbols of the same name from
+	// enclosing scopes until the scope exits.
 	class SymbolTable
 	{
 	public:
+		SymbolTable();
+		~SymbolTable();
+
+		SymbolTable(const SymbolTable&) = delete;
+		SymbolTable(SymbolTable&&) = default;
+		SymbolTable& operator=(const SymbolTable&) = delete;
+		SymbolTable& operator=(SymbolTable&&) = default;
+
 		const auto& getSymbols() const { return m_symbols; }
+		const IdentifierTable& getIdentifiers() const { return m_identifiers; }
 
+		// Find the innermost visible symbol with a name.
 		Symbol* findSymbol(const ConstString& name) const;
-		Symbol* findOrCreateSymbol(const ConstString& name, const Range& range, const Type& type);
+
+		// Find the innermost visible symbol with a name, declaring it in the current scope if there is none.
+		Symbol* findOrCreateSymbol(const ConstString& name, SourceLocation location, const Type& type);
+
+		// Declare a symbol in the current scope, hiding any symbol with the same name in an enclosing scope. Returns
+		// null if the current scope already has a symbol with the name.
+		Symbol* createSymbol(const ConstString& name, SourceLocation location, const Type& type);
+
+		// Scopes are entered in constant time, and exiting one only undoes the declarations made inside it.
+		void enterScope();
+		void exitScope();
+
+		// The program level is scope 0.
+		int getScope() const { return int(m_scopes.size()); }
 
 	private:
 		std::vector<std::unique_ptr<Symbol>> m_symbols;
+		IdentifierTable m_identifiers;
+
+		// innermost visible symbol for each identifier id, or null
+		std::vector<Symbol*> m_visible;
+
+		// symbols hidden by declarations in open scopes, restored when their scope exits
+		struct Hidden
+		{
+			int identifier;
+			Symbol* symbol;
+		};
+		std::vector<Hidden> m_hidden;
+
+		// start of each open scope within m_hidden
+		std::vector<size_t> m_scopes;
+
+		Symbol* declare(int identifier, SourceLocation location, const Type& type);
 	};
 
 }
@@ -27,7 +27,7 @@
 #pragma once
 
 #include "ConstString.hpp"
-#include "Range.hpp"
+#include "SourceLocation.hpp"
 #include "TokenId.hpp"
 
 namespace ZeeBasic::Compiler
@@ -37,7 +37,7 @@ namespace ZeeBasic::Compiler
     struct Token
     {
         TokenId id;
-        Range range;
+        SourceLocation location;
         ConstString text;
     };
 
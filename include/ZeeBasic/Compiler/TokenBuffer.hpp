@@ -0,0 +1,81 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Token.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    // Compact store for every token of a contiguous source, kept as separate arrays of ids, locations and text lengths
+    // (9 bytes per token instead of the 24 of a Token). The text of a token is not stored, because it starts at its
+    // location, or just after it for string literals. Tokens appended to the buffer must view their text inside the
+    // source, which must outlive the buffer.
+    class TokenBuffer
+    {
+    public:
+        TokenBuffer();
+        TokenBuffer(const char* source, size_t size);
+        ~TokenBuffer();
+
+        TokenBuffer(const TokenBuffer&) = delete;
+        TokenBuffer(TokenBuffer&&) = default;
+        TokenBuffer& operator=(const TokenBuffer&) = delete;
+        TokenBuffer& operator=(TokenBuffer&&) = default;
+
+        static constexpr size_t kBytesPerToken = sizeof(uint8_t) + 2 * sizeof(uint32_t);
+
+        void reserve(size_t count);
+
+        void append(const Token& token);
+
+        // Append the tokens of another buffer over the same source.
+        void append(const TokenBuffer& other);
+
+        size_t getCount() const { return m_ids.size(); }
+
+        TokenId getId(size_t index) const { return TokenId(m_ids[index]); }
+        SourceLocation getLocation(size_t index) const { return SourceLocation{ m_locations[index] }; }
+        ConstString getText(size_t index) const;
+
+        // Build the full token at an index.
+        Token getToken(size_t index) const;
+
+    private:
+        const char* m_source;
+
+        std::vector<uint8_t> m_ids;
+
+        std::vector<uint32_t> m_locations;
+        std::vector<uint32_t> m_lengths;
+    };
+
+}
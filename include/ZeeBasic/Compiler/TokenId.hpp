@@ -87,4 +87,7 @@ namespace ZeeBasic::Compiler
         Sym_Period,
     };
 
+    // one past the last token id, which sizes tables indexed by token
+    constexpr int kTokenIdCount = int(TokenId::Sym_Period) + 1;
+
 }
@@ -51,7 +51,7 @@ namespace ZeeBasic::Compiler::Nodes
 
 	private:
 		Operator m_op = Operator::Unknown;
-		std::unique_ptr<ExpressionNode> m_expr;
+		ExpressionNode* m_expr = nullptr;
 	};
 
 }
@@ -0,0 +1,74 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Ir.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	// Global value numbering over the dominator tree. A pure instruction that computes what an instruction in the same
+	// block or a dominating one already has, from the same operands, is replaced by that earlier value. Values are SSA,
+	// so an assignment to a variable makes a new value and anything computed from the old one no longer matches.
+	//
+	// A repeated string is a fresh allocation that is released after use, so it is only reused when the earlier string
+	// is released in the same block: one of the two releases goes, and the survivor frees the string once both are done
+	// with it. A string that a variable holds beyond the block is never reused, as it may not be released on every path.
+	class ValueNumbering
+	{
+	public:
+		ValueNumbering(Ir::Function& function);
+		~ValueNumbering();
+
+		void run();
+
+	private:
+		Ir::Function& m_function;
+
+		// the value that replaces each value, which is itself when it stays
+		std::vector<uint32_t> m_leaders;
+		std::vector<bool> m_removed;
+
+		// releases of each string value, and the position of each instruction within its block
+		std::vector<std::vector<uint32_t>> m_releases;
+		std::vector<uint32_t> m_positions;
+
+		// values computed by the blocks from the entry down to the current one, by what they compute
+		std::unordered_map<std::string, uint32_t> m_available;
+		std::vector<std::string> m_added;
+
+		void number(uint32_t block);
+		bool getKey(uint32_t index, std::string& key) const;
+		bool reuseString(uint32_t earlier, uint32_t later);
+	};
+
+}
@@ -36,19 +36,65 @@ typedef double zrt_Real;
 
 void zrt_init(int argc, char* argv[]);
 
+/* text this short is kept in the string itself rather than in a separate allocation */
+#define ZRT_STR_SMALL 24
+
 typedef struct zrt_String {
 	zrt_Int length;
 	zrt_Int capacity;
-	char* data;
+	char* data;			/* small while the text fits there */
+	char small[ZRT_STR_SMALL];
 } zrt_String;
 
+/* capacity of a string the program never frees, such as a static literal */
+#define ZRT_STR_IMMORTAL -1
+
+/* a string whose header the caller owns, on the stack or inside another object, is set up and torn down in place */
+zrt_String* zrt_str_init(zrt_String* str);
+
+/* retain gives a string the value of another by sharing its text until one of them is written, where copy always
+   copies the text; dup shares too, and release lets go of the text, leaving the string empty */
+void zrt_str_retain(zrt_String* dst, zrt_String* src);
+void zrt_str_release(zrt_String* str);
+
 zrt_String* zrt_str_empty();
 zrt_String* zrt_str_new(const char* text);
 zrt_String* zrt_str_new_from_int(zrt_Int value);
 zrt_String* zrt_str_concat(zrt_String* lhs, zrt_String* rhs);
 void zrt_str_copy(zrt_String* dst, zrt_String* src);
 void zrt_str_del(zrt_String* str);
+zrt_String* zrt_str_dup(zrt_String* str);
+void zrt_str_concat_into(zrt_String* dst, zrt_String* lhs, zrt_String* rhs);
+void zrt_str_concat_n(zrt_String* dst, int count, zrt_String** parts);
+void zrt_str_append(zrt_String* dst, zrt_String* src);
+void zrt_str_append_n(zrt_String* dst, int count, zrt_String** parts);
+void zrt_str_take(zrt_String* dst, zrt_String* src);
+
+zrt_String* zrt_str_new_from_real(zrt_Real value);
+zrt_Int zrt_str_asc(zrt_String* str);
+zrt_String* zrt_str_chr(zrt_Int code);
+zrt_Int zrt_str_instr(zrt_String* str, zrt_String* find);
+zrt_String* zrt_str_lcase(zrt_String* str);
+zrt_String* zrt_str_left(zrt_String* str, zrt_Int count);
+zrt_String* zrt_str_ltrim(zrt_String* str);
+zrt_String* zrt_str_mid(zrt_String* str, zrt_Int start, zrt_Int count);
+zrt_String* zrt_str_radix(zrt_Int value, int radix);
+zrt_String* zrt_str_repeat(zrt_Int count, zrt_String* str);
+zrt_String* zrt_str_right(zrt_String* str, zrt_Int count);
+zrt_String* zrt_str_rtrim(zrt_String* str);
+zrt_String* zrt_str_space(zrt_Int count);
+zrt_String* zrt_str_ucase(zrt_String* str);
+zrt_Real zrt_str_val(zrt_String* str);
+
+zrt_String* zrt_command();
+zrt_String* zrt_date();
+zrt_String* zrt_environ(zrt_String* name);
+zrt_String* zrt_inkey();
+zrt_Real zrt_rnd();
+zrt_String* zrt_time();
+zrt_Real zrt_timer();
 
+void zrt_println();
 void zrt_println_bool(zrt_Bool arg);
 void zrt_println_int(zrt_Int arg);
 void zrt_println_real(zrt_Real arg);
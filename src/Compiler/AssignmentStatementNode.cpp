@@ -29,6 +29,7 @@
 #include "ZeeBasic/Compiler/CastExpressionNode.hpp"
 #include "ZeeBasic/Compiler/Error.hpp"
 #include "ZeeBasic/Compiler/ExpressionNode.hpp"
+#include "ZeeBasic/Compiler/NodeArena.hpp"
 #include "ZeeBasic/Compiler/SymbolTable.hpp"
 
 namespace ZeeBasic::Compiler::Nodes
@@ -36,23 +37,34 @@ namespace ZeeBasic::Compiler::Nodes
 
 	void AssignmentStatementNode::parse(IParser& parser)
 	{
+		// CONST declares a symbol whose value is folded into every use
+		auto isConstant = parser.getToken().id == TokenId::Key_CONST;
+		if (isConstant)
+		{
+			parser.eatToken();
+			if (parser.getToken().id != TokenId::UntypedName && parser.getToken().id != TokenId::TypedName)
+			{
+				throw Error::create(parser.getToken().location, "Expected name for constant");
+			}
+		}
+
 		// save name for to add symbol later
-		auto& token = parser.getToken();		
+		auto token = parser.getToken();
 		auto name = token.text;
 
 		// finish parsing expression side first
 		parser.eatToken();
 		if (parser.getToken().id != TokenId::Sym_Equal)
 		{
-			throw Error::create(parser.getToken().range, "Expected equals after variable name for assignment");
+			throw Error::create(parser.getToken().location, "Expected equals after variable name for assignment");
 		}
-		m_range = parser.getToken().range;
+		m_location = parser.getToken().location;
 		parser.eatToken();
 
 		m_expr = ExpressionNode::parseExpression(parser);
 		if (!m_expr)
 		{
-			throw Error::create(parser.getToken().range, "Expected expression for assignment");
+			throw Error::create(parser.getToken().location, "Expected expression for assignment");
 		}
 
 		parser.eatEndOfLine();
@@ -70,14 +82,34 @@ namespace ZeeBasic::Compiler::Nodes
 		{
 			type.base = BaseType_Real;
 		}
+		else if (isConstant && token.id == TokenId::UntypedName)
+		{
+			// untyped constants take the type of their value
+			type.base = m_expr->getType().base;
+		}
 		else
 		{
 			type.base = BaseType_Integer;
 		}
 
-		m_symbol = parser.getSymbolTable().findOrCreateSymbol(name, token.range, type);
-		
-		
+		if (isConstant)
+		{
+			m_symbol = parser.getSymbolTable().createSymbol(name, token.location, type);
+			if (!m_symbol)
+			{
+				throw Error::create(token.location, "Constant name already in use");
+			}
+			m_symbol->isConstant = true;
+		}
+		else
+		{
+			m_symbol = parser.getSymbolTable().findOrCreateSymbol(name, token.location, type);
+			if (m_symbol->isConstant)
+			{
+				throw Error::create(token.location, "Unable to assign to a constant");
+			}
+		}
+
 		if (m_expr->getType().base != m_symbol->type.base)
 		{
 			// only allow casting boolean -> integer, integer -> real and real -> integer (everything else must be explicit)
@@ -87,7 +119,7 @@ namespace ZeeBasic::Compiler::Nodes
 			{
 				if (m_expr->getType().base == BaseType_Boolean || m_expr->getType().base == BaseType_Real)
 				{
-					m_expr = std::make_unique<CastExpressionNode>(m_symbol->type.base, std::move(m_expr));
+					m_expr = parser.getNodeArena().create<CastExpressionNode>(m_symbol->type.base, m_expr);
 					casted = true;
 				}
 			}
@@ -95,14 +127,14 @@ namespace ZeeBasic::Compiler::Nodes
 			{
 				if (m_expr->getType().base == BaseType_Integer)
 				{
-					m_expr = std::make_unique<CastExpressionNode>(m_symbol->type.base, std::move(m_expr));
+					m_expr = parser.getNodeArena().create<CastExpressionNode>(m_symbol->type.base, m_expr);
 					casted = true;
 				}
 			}
 
 			if (!casted)
 			{
-				throw Error::create(m_range, "Unable to implicitly cast type");
+				throw Error::create(m_location, "Unable to implicitly cast type");
 			}
 		}
 	}
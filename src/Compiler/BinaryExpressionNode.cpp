@@ -24,167 +24,205 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
+#include <array>
+#include <cstdint>
+
 #include "ZeeBasic/Compiler/BinaryExpressionNode.hpp"
 
 #include "ZeeBasic/Compiler/CastExpressionNode.hpp"
 #include "ZeeBasic/Compiler/Error.hpp"
+#include "ZeeBasic/Compiler/NodeArena.hpp"
 
 namespace ZeeBasic::Compiler::Nodes
 {
 
-	BinaryExpressionNode::BinaryExpressionNode(Operator op, std::unique_ptr<ExpressionNode> lhs, std::unique_ptr<ExpressionNode> rhs)
+	BinaryExpressionNode::BinaryExpressionNode(Operator op, ExpressionNode* lhs, ExpressionNode* rhs)
 		:
 		m_op(op),
-		m_lhs(std::move(lhs)),
-		m_rhs(std::move(rhs))
+		m_lhs(lhs),
+		m_rhs(rhs)
 	{ }
 
 	BinaryExpressionNode::~BinaryExpressionNode()
 	{ }
 
-	void BinaryExpressionNode::parse(IParser& parser)
-	{ 
-		m_range = Range{ m_lhs->getRange(), m_rhs->getRange() };
-		
-		const auto& lhsType = m_lhs->getType();
-		const auto& rhsType = m_rhs->getType();
+	namespace
+	{
+
+		using Operator = BinaryExpressionNode::Operator;
 
-		enum class ImplicitCastSide
+		enum class ImplicitCastSide : uint8_t
 		{
 			None,
 			Left,
 			Right
 		};
 
-		static struct {
-			int lhsBaseType;
-			int rhsBaseType;
-			Operator op;
+		struct Operation
+		{
+			const char* errorMessage;		// nullptr if the operation is allowed
 			ImplicitCastSide castSide;
-			int castToType;
-			bool allowed;
-			const char* errorMessage;
-		} operationTable[] = {
+			uint8_t castToType;
+			uint8_t resultType;
+		};
+
+		// every user-defined type shares the last slot
+		constexpr auto kTypeSlotCount = BaseType_Udt + 1;
+
+		constexpr int getTypeSlot(int baseType)
+		{
+			return baseType < BaseType_Udt ? baseType : BaseType_Udt;
+		}
+
+		constexpr bool isBitwise(Operator op)
+		{
+			return op == Operator::BitwiseOr || op == Operator::BitwiseAnd || op == Operator::BitwiseXor;
+		}
+
+		constexpr bool isComparison(Operator op)
+		{
+			return op >= Operator::Equals && op <= Operator::GreaterEquals;
+		}
+
+		constexpr Operation allow(Operator op, int operandType, ImplicitCastSide castSide = ImplicitCastSide::None)
+		{
+			auto resultType = operandType;
+			if (op == Operator::Divide)
+			{
+				resultType = BaseType_Real;
+			}
+			else if (op == Operator::IntDivide)
+			{
+				resultType = BaseType_Integer;
+			}
+			else if (isComparison(op))
+			{
+				resultType = BaseType_Boolean;
+			}
+
+			return { nullptr, castSide, uint8_t(operandType), uint8_t(resultType) };
+		}
+
+		constexpr Operation reject(const char* errorMessage)
+		{
+			return { errorMessage, ImplicitCastSide::None, BaseType_Unknown, BaseType_Unknown };
+		}
+
+		constexpr Operation describe(int lhs, int rhs, Operator op)
+		{
+			// an operand whose type is not known yet passes through untyped
+			if (lhs == BaseType_Unknown || rhs == BaseType_Unknown)
+			{
+				return { nullptr, ImplicitCastSide::None, BaseType_Unknown, BaseType_Unknown };
+			}
+
+			if (lhs == BaseType_Udt || rhs == BaseType_Udt)
+			{
+				return reject("Operation not allowed on user-defined types");
+			}
+
 			//
 			// No Implicit Conversions
 			//
 
-			// Boolean|Boolean - bitwise & comparison allowed
-			{ BaseType_Boolean, BaseType_Boolean, Operator::BitwiseAnd, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::BitwiseOr, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::BitwiseXor, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::Equals, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::NotEquals, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::Less, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::LessEquals, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::Greater, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::GreaterEquals, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Boolean, BaseType_Boolean, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Operation not allowed on boolean types" },
-
-			// Integer|Integer - all allowed
-			{ BaseType_Integer, BaseType_Integer, Operator::None, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-
-			// Real|Real - no bitwise allowed
-			{ BaseType_Real, BaseType_Real, Operator::Add, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::Subtract, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::Multiply, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::Divide, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::IntDivide, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::Modulus, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::Equals, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::NotEquals, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::Less, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::LessEquals, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::Greater, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::GreaterEquals, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_Real, BaseType_Real, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Bitwise operation not allowed on real types" },
-
-			// String|String - only add allowed
-			{ BaseType_String, BaseType_String, Operator::Add, ImplicitCastSide::None, BaseType_Unknown, true, nullptr },
-			{ BaseType_String, BaseType_String, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Operation not allowed on string types" },
+			if (lhs == rhs)
+			{
+				switch (lhs)
+				{
+				case BaseType_Boolean:
+					// bitwise & comparison allowed
+					return isBitwise(op) || isComparison(op) ? allow(op, lhs) : reject("Operation not allowed on boolean types");
+
+				case BaseType_Integer:
+					// all allowed
+					return allow(op, lhs);
+
+				case BaseType_Real:
+					// no bitwise allowed
+					return isBitwise(op) ? reject("Bitwise operation not allowed on real types") : allow(op, lhs);
+
+				default:
+					// only add allowed on strings
+					return op == Operator::Add ? allow(op, lhs) : reject("Operation not allowed on string types");
+				}
+			}
 
 			//
 			// Implicit Conversions
 			//
 
-			// Boolean|Integer - not allowed
-			// Integer|Boolean - not allowed
-			{ BaseType_Boolean, BaseType_Integer, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Implicit cast between integer and boolean not allowed" },
-			{ BaseType_Integer, BaseType_Boolean, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Implicit cast between integer and boolean not allowed" },
-			
-			// Integer|Real - cast up to real (except for bitwise)
-			// Real|Integer - cast up to real (except for bitwise)
-			{ BaseType_Integer, BaseType_Real, Operator::BitwiseOr, ImplicitCastSide::None, BaseType_Unknown, false, "Bitwise operation not allowed on real types" },
-			{ BaseType_Integer, BaseType_Real, Operator::BitwiseAnd, ImplicitCastSide::None, BaseType_Unknown, false, "Bitwise operation not allowed on real types" },
-			{ BaseType_Integer, BaseType_Real, Operator::BitwiseXor, ImplicitCastSide::None, BaseType_Unknown, false, "Bitwise operation not allowed on real types" },
-			{ BaseType_Real, BaseType_Integer, Operator::BitwiseOr, ImplicitCastSide::None, BaseType_Unknown, false, "Bitwise operation not allowed on real types" },
-			{ BaseType_Real, BaseType_Integer, Operator::BitwiseAnd, ImplicitCastSide::None, BaseType_Unknown, false, "Bitwise operation not allowed on real types" },
-			{ BaseType_Real, BaseType_Integer, Operator::BitwiseXor, ImplicitCastSide::None, BaseType_Unknown, false, "Bitwise operation not allowed on real types" },
-			{ BaseType_Integer, BaseType_Real, Operator::None, ImplicitCastSide::Left, BaseType_Real, true, nullptr },
-			{ BaseType_Real, BaseType_Integer, Operator::None, ImplicitCastSide::Right, BaseType_Real, true, nullptr },
-
-			// Boolean|Real - not allowed
-			// Real|Boolean - not allowed
-			{ BaseType_Boolean, BaseType_Integer, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Implicit cast between real and boolean not allowed" },
-			{ BaseType_Integer, BaseType_Boolean, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Implicit cast between real and boolean not allowed" },
-
-			// String|anything - not allowed
-			// anything|String - not allowed
-			{ BaseType_String, BaseType_Boolean, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Unable to implicitly cast type to string" },
-			{ BaseType_String, BaseType_Integer, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Unable to implicitly cast type to string" },
-			{ BaseType_String, BaseType_Real, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Unable to implicitly cast type to string" },
-			{ BaseType_Boolean, BaseType_String, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Unable to implicitly cast type to string" },
-			{ BaseType_Integer, BaseType_String, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Unable to implicitly cast type to string" },
-			{ BaseType_Real, BaseType_String, Operator::None, ImplicitCastSide::None, BaseType_Unknown, false, "Unable to implicitly cast type to string" },
-			
-			{ BaseType_Unknown, BaseType_Unknown, Operator::None, ImplicitCastSide::None, false, BaseType_Unknown, nullptr }
-		};
+			// String|anything & anything|String - not allowed
+			if (lhs == BaseType_String || rhs == BaseType_String)
+			{
+				return reject("Unable to implicitly cast type to string");
+			}
+
+			// Boolean|Integer & Integer|Boolean - not allowed
+			if (lhs == BaseType_Integer || rhs == BaseType_Integer)
+			{
+				if (lhs == BaseType_Boolean || rhs == BaseType_Boolean)
+				{
+					return reject("Implicit cast between integer and boolean not allowed");
+				}
+
+				// Integer|Real & Real|Integer - cast up to real (except for bitwise)
+				if (isBitwise(op))
+				{
+					return reject("Bitwise operation not allowed on real types");
+				}
+
+				return allow(op, BaseType_Real, lhs == BaseType_Integer ? ImplicitCastSide::Left : ImplicitCastSide::Right);
+			}
+
+			// Boolean|Real & Real|Boolean - not allowed
+			return reject("Implicit cast between real and boolean not allowed");
+		}
+
+		using OperationTable = std::array<std::array<std::array<Operation, BinaryExpressionNode::kOperatorCount>, kTypeSlotCount>, kTypeSlotCount>;
 
-		for (auto i = 0; operationTable[i].lhsBaseType != BaseType_Unknown; ++i)
+		constexpr OperationTable buildOperationTable()
 		{
-			if (lhsType.base == operationTable[i].lhsBaseType && rhsType.base == operationTable[i].rhsBaseType)
+			auto table = OperationTable{};
+			for (auto lhs = 0; lhs < kTypeSlotCount; ++lhs)
 			{
-				if (operationTable[i].op == m_op || operationTable[i].op == Operator::None)
+				for (auto rhs = 0; rhs < kTypeSlotCount; ++rhs)
 				{
-					if (operationTable[i].allowed)
+					for (auto op = 0; op < BinaryExpressionNode::kOperatorCount; ++op)
 					{
-						// casting to be done?
-						if (operationTable[i].castSide == ImplicitCastSide::Left)
-						{
-							m_lhs = std::make_unique<CastExpressionNode>(operationTable[i].castToType, std::move(m_lhs));
-						}
-						else if (operationTable[i].castSide == ImplicitCastSide::Right)
-						{
-							m_rhs = std::make_unique<CastExpressionNode>(operationTable[i].castToType, std::move(m_rhs));
-						}
-
-						// take on resulting type
-						if (m_op == Operator::Divide)
-						{
-							m_type = Type{ BaseType_Real };
-						}
-						else if (m_op == Operator::IntDivide)
-						{
-							m_type = Type{ BaseType_Integer };
-						}
-						else if (m_op >= Operator::Equals && m_op <= Operator::GreaterEquals)
-						{
-							m_type = Type{ BaseType_Boolean };
-						}
-						else
-						{
-							m_type = m_lhs->getType();
-						}
-
-						break;
-					}
-					else
-					{
-						throw Error::create(m_range, operationTable[i].errorMessage);
+						table[lhs][rhs][op] = describe(lhs, rhs, Operator(op));
 					}
 				}
 			}
+			return table;
 		}
+
+		// [lhs type][rhs type][operator] -> legality, implicit cast and result type
+		constexpr auto operationTable = buildOperationTable();
+
+	}
+
+	void BinaryExpressionNode::parse(IParser& parser)
+	{ 
+		m_location = m_lhs->getLocation();
+
+		const auto& operation = operationTable[getTypeSlot(m_lhs->getType().base)][getTypeSlot(m_rhs->getType().base)][int(m_op)];
+		if (operation.errorMessage)
+		{
+			throw Error::create(m_location, operation.errorMessage);
+		}
+
+		// casting to be done?
+		if (operation.castSide == ImplicitCastSide::Left)
+		{
+			m_lhs = parser.getNodeArena().create<CastExpressionNode>(operation.castToType, m_lhs);
+		}
+		else if (operation.castSide == ImplicitCastSide::Right)
+		{
+			m_rhs = parser.getNodeArena().create<CastExpressionNode>(operation.castToType, m_rhs);
+		}
+
+		// take on resulting type
+		m_type = Type{ operation.resultType };
 	}
 
 	void BinaryExpressionNode::translate(ITranslator& translator) const
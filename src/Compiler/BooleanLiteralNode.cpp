@@ -48,10 +48,10 @@ namespace ZeeBasic::Compiler::Nodes
 		}
 		else
 		{
-			throw Error::create(token.range, "Expected TRUE or FALSE boolean literal");
+			throw Error::create(token.location, "Expected TRUE or FALSE boolean literal");
 		}
 
-		m_range = token.range;
+		m_location = token.location;
 		parser.eatToken();
 
 		m_type = Type{ BaseType_Boolean };
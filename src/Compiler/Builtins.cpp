@@ -0,0 +1,115 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <array>
+
+#include "ZeeBasic/Compiler/Builtins.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	namespace
+	{
+
+		using Operand = Builtin::Operand;
+		using Lowering = Builtin::Lowering;
+
+		constexpr auto None = Operand::None;
+		constexpr auto Integer = Operand::Integer;
+		constexpr auto Real = Operand::Real;
+		constexpr auto Number = Operand::Number;
+		constexpr auto String = Operand::String;
+
+		constexpr Builtin builtins[] = {
+			// math, lowered to C
+			{ TokenId::Key_ABS, "ABS", Number, { Number }, 1, true, Lowering::Inline, "($0 < 0 ? -$0 : $0)", nullptr, nullptr },
+			{ TokenId::Key_ATN, "ATN", Real, { Real }, 1, true, Lowering::Inline, "atan($0)", nullptr, nullptr },
+			{ TokenId::Key_COS, "COS", Real, { Real }, 1, true, Lowering::Inline, "cos($0)", nullptr, nullptr },
+			{ TokenId::Key_EXP, "EXP", Real, { Real }, 1, true, Lowering::Inline, "exp($0)", nullptr, nullptr },
+			{ TokenId::Key_FIX, "FIX", Integer, { Number }, 1, true, Lowering::Inline, "$0", "(zrt_Int)$0", nullptr },
+			{ TokenId::Key_INT, "INT", Integer, { Number }, 1, true, Lowering::Inline, "$0", "(zrt_Int)floor($0)", nullptr },
+			{ TokenId::Key_LOG, "LOG", Real, { Real }, 1, true, Lowering::Inline, "log($0)", nullptr, nullptr },
+			{ TokenId::Key_SGN, "SGN", Integer, { Number }, 1, true, Lowering::Inline, "(zrt_Int)(($0 > 0) - ($0 < 0))", nullptr, nullptr },
+			{ TokenId::Key_SIN, "SIN", Real, { Real }, 1, true, Lowering::Inline, "sin($0)", nullptr, nullptr },
+			{ TokenId::Key_SQR, "SQR", Real, { Real }, 1, true, Lowering::Inline, "sqrt($0)", nullptr, nullptr },
+			{ TokenId::Key_TAN, "TAN", Real, { Real }, 1, true, Lowering::Inline, "tan($0)", nullptr, nullptr },
+
+			// strings
+			{ TokenId::Key_ASC, "ASC", Integer, { String }, 1, true, Lowering::Runtime, "zrt_str_asc($0)", nullptr, nullptr },
+			{ TokenId::Key_BIN_S, "BIN$", String, { Integer }, 1, true, Lowering::Runtime, "zrt_str_radix($0, 2)", nullptr, nullptr },
+			{ TokenId::Key_CHR_S, "CHR$", String, { Integer }, 1, true, Lowering::Runtime, "zrt_str_chr($0)", nullptr, nullptr },
+			{ TokenId::Key_HEX_S, "HEX$", String, { Integer }, 1, true, Lowering::Runtime, "zrt_str_radix($0, 16)", nullptr, nullptr },
+			{ TokenId::Key_INSTR, "INSTR", Integer, { String, String }, 2, true, Lowering::Runtime, "zrt_str_instr($0, $1)", nullptr, nullptr },
+			{ TokenId::Key_LCASE_S, "LCASE$", String, { String }, 1, true, Lowering::Runtime, "zrt_str_lcase($0)", nullptr, nullptr },
+			{ TokenId::Key_LEFT_S, "LEFT$", String, { String, Integer }, 2, true, Lowering::Runtime, "zrt_str_left($0, $1)", nullptr, nullptr },
+			{ TokenId::Key_LEN, "LEN", Integer, { String }, 1, true, Lowering::Inline, "$0->length", nullptr, nullptr },
+			{ TokenId::Key_LTRIM_S, "LTRIM$", String, { String }, 1, true, Lowering::Runtime, "zrt_str_ltrim($0)", nullptr, nullptr },
+			{ TokenId::Key_MID_S, "MID$", String, { String, Integer, Integer }, 2, true, Lowering::Runtime, "zrt_str_mid($0, $1, $2)", nullptr, "-1" },
+			{ TokenId::Key_OCT_S, "OCT$", String, { Integer }, 1, true, Lowering::Runtime, "zrt_str_radix($0, 8)", nullptr, nullptr },
+			{ TokenId::Key_RIGHT_S, "RIGHT$", String, { String, Integer }, 2, true, Lowering::Runtime, "zrt_str_right($0, $1)", nullptr, nullptr },
+			{ TokenId::Key_RTRIM_S, "RTRIM$", String, { String }, 1, true, Lowering::Runtime, "zrt_str_rtrim($0)", nullptr, nullptr },
+			{ TokenId::Key_SPACE_S, "SPACE$", String, { Integer }, 1, true, Lowering::Runtime, "zrt_str_space($0)", nullptr, nullptr },
+			{ TokenId::Key_STR_S, "STR$", String, { Number }, 1, true, Lowering::Runtime, "zrt_str_new_from_int($0)", "zrt_str_new_from_real($0)", nullptr },
+			{ TokenId::Key_STRING_S, "STRING$", String, { Integer, String }, 2, true, Lowering::Runtime, "zrt_str_repeat($0, $1)", nullptr, nullptr },
+			{ TokenId::Key_UCASE_S, "UCASE$", String, { String }, 1, true, Lowering::Runtime, "zrt_str_ucase($0)", nullptr, nullptr },
+			{ TokenId::Key_VAL, "VAL", Real, { String }, 1, true, Lowering::Runtime, "zrt_str_val($0)", nullptr, nullptr },
+
+			// environment
+			{ TokenId::Key_COMMAND_S, "COMMAND$", String, { None }, 0, false, Lowering::Runtime, "zrt_command()", nullptr, nullptr },
+			{ TokenId::Key_DATE_S, "DATE$", String, { None }, 0, false, Lowering::Runtime, "zrt_date()", nullptr, nullptr },
+			{ TokenId::Key_ENVIRON_S, "ENVIRON$", String, { String }, 1, false, Lowering::Runtime, "zrt_environ($0)", nullptr, nullptr },
+			{ TokenId::Key_INKEY_S, "INKEY$", String, { None }, 0, false, Lowering::Runtime, "zrt_inkey()", nullptr, nullptr },
+			{ TokenId::Key_RND, "RND", Real, { None }, 0, false, Lowering::Runtime, "zrt_rnd()", nullptr, nullptr },
+			{ TokenId::Key_TIME_S, "TIME$", String, { None }, 0, false, Lowering::Runtime, "zrt_time()", nullptr, nullptr },
+			{ TokenId::Key_TIMER, "TIMER", Real, { None }, 0, false, Lowering::Runtime, "zrt_timer()", nullptr, nullptr },
+		};
+
+		constexpr auto kBuiltinCount = int(sizeof(builtins) / sizeof(builtins[0]));
+
+		// builtins index + 1 for every token, with 0 marking a keyword that is not a built-in function
+		constexpr std::array<uint8_t, kTokenIdCount> buildBuiltinIndex()
+		{
+			auto index = std::array<uint8_t, kTokenIdCount>{};
+			for (auto i = 0; i < kBuiltinCount; ++i)
+			{
+				index[int(builtins[i].id)] = uint8_t(i + 1);
+			}
+			return index;
+		}
+
+		constexpr auto builtinIndex = buildBuiltinIndex();
+
+		static_assert(kBuiltinCount < 256, "builtin index does not fit in a byte");
+
+	}
+
+	const Builtin* getBuiltin(TokenId id)
+	{
+		auto slot = builtinIndex[int(id)];
+		return slot ? &builtins[slot - 1] : nullptr;
+	}
+
+}
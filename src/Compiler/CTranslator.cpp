@@ -24,30 +24,49 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
+#include <algorithm>
 #include <cassert>
+#include <cinttypes>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "ZeeBasic/Compiler/CTranslator.hpp"
 
-#include "ZeeBasic/Compiler/AssignmentStatementNode.hpp"
-#include "ZeeBasic/Compiler/BinaryExpressionNode.hpp"
-#include "ZeeBasic/Compiler/BooleanLiteralNode.hpp"
-#include "ZeeBasic/Compiler/CastExpressionNode.hpp"
-#include "ZeeBasic/Compiler/FunctionCallExpressionNode.hpp"
-#include "ZeeBasic/Compiler/IdentifierExpressionNode.hpp"
-#include "ZeeBasic/Compiler/IntegerLiteralNode.hpp"
-#include "ZeeBasic/Compiler/PrintStatementNode.hpp"
 #include "ZeeBasic/Compiler/Program.hpp"
-#include "ZeeBasic/Compiler/RealLiteralNode.hpp"
-#include "ZeeBasic/Compiler/StringLiteralNode.hpp"
-#include "ZeeBasic/Compiler/UnaryExpressionNode.hpp"
 
 namespace ZeeBasic::Compiler
 {
 
-	CTranslator::Writer::Writer(std::vector<VariableIndex>& variableIndices)
+	using Ir::Opcode;
+
+	// slots are numbered within their type, and b_ is taken by the block labels
+	static const char* getSlotPrefix(int base)
+	{
+		switch (base)
+		{
+
+		case BaseType_Boolean:
+			return "tb_";
+
+		case BaseType_Integer:
+			return "ti_";
+
+		case BaseType_Real:
+			return "tr_";
+
+		case BaseType_String:
+			return "ts_";
+
+		default:
+			assert(false);
+			return "t?_";
+
+		}
+	}
+
+	CTranslator::Writer::Writer(CTranslator& translator)
 		:
-		m_variableIndices(variableIndices)
+		m_translator(translator)
 	{ }
 
 	void CTranslator::Writer::setFile(FILE* file)
@@ -85,90 +104,102 @@ namespace ZeeBasic::Compiler
 		return *this;
 	}
 
-	CTranslator::Writer& CTranslator::Writer::operator<<(int64_t value)
+	CTranslator::Writer& CTranslator::Writer::operator<<(const ConstString& text)
 	{
-		fprintf(m_outFile, "%lld", value);
+		fwrite(text.getText(), sizeof(char), size_t(text.getLength()), m_outFile);
 		return *this;
 	}
 
-	CTranslator::Writer& CTranslator::Writer::operator<<(bool value)
+	CTranslator::Writer& CTranslator::Writer::operator<<(const Literal& literal)
 	{
-		if (value)
-		{
-			fputc('1', m_outFile);
-		}
-		else
+		// octal escapes stop after three digits, so unlike hex they cannot run into a digit that follows
+		fputc('"', m_outFile);
+		auto text = literal.text.getText();
+		for (auto i = 0; i < literal.text.getLength(); ++i)
 		{
-			fputc('0', m_outFile);
+			auto ch = (unsigned char)text[i];
+			if (ch == '"' || ch == '\\' || ch == '?')
+			{
+				fputc('\\', m_outFile);
+				fputc(ch, m_outFile);
+			}
+			else if (ch < 0x20 || ch >= 0x7f)
+			{
+				fprintf(m_outFile, "\\%03o", ch);
+			}
+			else
+			{
+				fputc(ch, m_outFile);
+			}
 		}
+		fputc('"', m_outFile);
 		return *this;
 	}
 
-	CTranslator::Writer& CTranslator::Writer::operator<<(int index)
+	CTranslator::Writer& CTranslator::Writer::operator<<(int64_t value)
 	{
-		return operator<<(m_variableIndices[index]);
+		fprintf(m_outFile, "%" PRId64, value);
+		return *this;
 	}
 
-	CTranslator::Writer& CTranslator::Writer::operator<<(const VariableIndex& index)
+	CTranslator::Writer& CTranslator::Writer::operator<<(Value value)
 	{
-		if (index.indexType == IndexType::Local)
+		const auto& function = m_translator.m_function;
+		const auto& instruction = function.getInstruction(value.index);
+		if (!m_translator.m_inlined[value.index])
 		{
-			return operator<<(*index.symbol);
+			fprintf(m_outFile, "%s%u", getSlotPrefix(instruction.type.base), m_translator.m_slots.getSlot(value.index));
+			return *this;
+		}
+
+		// parenthesized, unless it is a number that cannot be mistaken for part of something else; a literal's
+		// address is not, as "&lit_0->length" would take the address of the length
+		auto isNumber = instruction.opcode == Ir::Opcode::Constant
+			&& (instruction.type.base == BaseType_Real ? function.getText(value.index).getText()[0] != '-' : function.getInteger(value.index) >= 0);
+		if (isNumber)
+		{
+			m_translator.writeExpression(value.index);
 		}
 		else
 		{
-			fprintf(m_outFile, "t_%d", index.id);
+			*this << '(';
+			m_translator.writeExpression(value.index);
+			*this << ')';
 		}
-
 		return *this;
 	}
 
-	CTranslator::Writer& CTranslator::Writer::operator<<(const Symbol& symbol)
+	static const char* getCType(int base)
 	{
-		fputs("v_", m_outFile);
+		switch (base)
+		{
 
-		auto len = symbol.name.getLength();
-		auto lastChar = symbol.name.getText()[len - 1];
-		auto appendChar = char{ 0 };
+		case BaseType_Boolean:
+			return "zrt_Bool ";
 
-		if (lastChar == '$')
-		{
-			appendChar = 's';
-		}
-		else if (lastChar == '?')
-		{
-			appendChar = 'b';
-		}
-		else if (lastChar == '!')
-		{
-			appendChar = 'r';
-		}
-		else if (lastChar == '%')
-		{
-			appendChar = 'i';
-		}
+		case BaseType_Integer:
+			return "zrt_Int ";
 
-		if (appendChar == 0)
-		{
-			// just write out whole name
-			fputs(symbol.name.getText(), m_outFile);
-		}
-		else
-		{
-			fwrite(symbol.name.getText(), sizeof(char), size_t(len) - 1, m_outFile);
-			fputc('_', m_outFile);
-			fputc(appendChar, m_outFile);
-		}
+		case BaseType_Real:
+			return "zrt_Real ";
 
-		return *this;
-	}
+		case BaseType_String:
+			return "zrt_String* ";
 
+		default:
+			assert(false);
+			return "? ";
 
-	CTranslator::CTranslator(const std::string& path, const Program& program)
+		}
+	}
+
+	CTranslator::CTranslator(const std::string& path, const Program& program, Emission emission)
 		:
-		ITranslator(),
 		m_program(program),
-		m_writer(m_variableIndices)
+		m_function(program.ir),
+		m_emission(emission),
+		m_slots(program.ir, m_inlined),
+		m_writer(*this)
 	{
 #ifdef _WIN32
 		fopen_s(&m_file, path.c_str(), "w");
@@ -193,61 +224,46 @@ namespace ZeeBasic::Compiler
 
 	void CTranslator::run()
 	{
+		fprintf(m_file, "#include <math.h>\n");
 		fprintf(m_file, "#include <ZeeBasic/Runtime/ZeeRuntime.h>\n");
 		fprintf(m_file, "\n");
+
+		findInlinedValues();
+		findLiterals();
+		m_slots.run();
+
+		declareLiterals();
+
 		fprintf(m_file, "void program(void)\n");
 		fprintf(m_file, "{\n");
 
 		m_writer.pushIndent();
 
-		// initialize locals
-		const auto& symbols = m_program.symbols.getSymbols();
-		for (auto& symbol : symbols)
+		declareSlots();
+
+		// every block comes after the blocks that dominate it, so each value is assigned before the code that uses it
+		for (auto block : m_function.getReversePostorder())
 		{
-			m_writer.indent();
-			
-			switch (symbol->type.base)
+			if (block != 0)
 			{
-
-			case BaseType_Boolean:
-				m_writer << "zrt_Bool " << *symbol << " = 0;\n";
-				break;
-
-			case BaseType_Integer:
-				m_writer << "zrt_Int " << *symbol << " = 0;\n";
-				break;
-
-			case BaseType_Real:
-				m_writer << "zrt_Real " << *symbol << " = 0.0;\n";
-				break;
-
-			case BaseType_String:
-				m_writer << "zrt_String* " << *symbol << " = zrt_str_empty();\n";
-				break;
-
-			default:
-				assert(false);				
-
+				fprintf(m_file, "b_%u: ;\n", block);
 			}
-		}
 
-		for (const auto& stm : m_program.statements)
-		{
-			stm->translate(*this);
-		}
-
-		// cleanup locals (in reverse order)
-		for (auto it = symbols.rbegin(); it != symbols.rend(); ++it)
-		{
-			auto& symbol = *it;
-
-			if (symbol->type.base == BaseType_String)
+			for (auto index : m_function.getBlock(block).instructions)
 			{
-				m_writer.indent();
-				m_writer << "zrt_str_del(" << *symbol << ");\n";
+				translate(index);
+
+				// a string no longer used lets go of its text, so a string sharing that text can be written in place
+				for (auto value : m_slots.getReleases(index))
+				{
+					m_writer.indent();
+					m_writer << "zrt_str_release(" << Value{ value } << ");\n";
+				}
 			}
 		}
 
+		m_writer.popIndent();
+
 		fprintf(m_file, "}\n");
 		fprintf(m_file, "\n");
 		fprintf(m_file, "int main(int argc, char* argv[])\n");
@@ -260,391 +276,709 @@ namespace ZeeBasic::Compiler
 		fflush(m_file);
 	}
 
-	void CTranslator::translate(const Nodes::AssignmentStatementNode& node)
+	void CTranslator::findInlinedValues()
 	{
-		node.getExpression()->translate(*this);
-		
-		auto index = popIndex();
-		
-		m_writer.indent();
-		if (index.type.base == BaseType_String)
-		{
-			// TODO (copy string?)
-			m_writer << "zrt_str_copy(" << *node.getSymbol() << ", " << index << ");\n";
-		}
-		else
+		m_inlined.assign(m_function.getInstructionCount(), false);
+		if (m_emission == Emission::Temporaries)
 		{
-			m_writer << *node.getSymbol() << " = " << index << ";\n";
+			return;
 		}
 
-		destroyIndex(index);
-	}
-
-	void CTranslator::translate(const Nodes::BinaryExpressionNode& node)
-	{
-		node.getLeft().translate(*this);
-		node.getRight().translate(*this);
-
-		auto rhs = popIndex();
-		auto lhs = popIndex();
-
-		m_writer.indent();
-		if (node.getType().base == BaseType_Boolean || node.getType().base == BaseType_Integer || node.getType().base == BaseType_Real)
+		// how often each value is used, and by what when it is used once; releases write nothing, so do not count
+		auto useCounts = std::vector<uint32_t>(m_function.getInstructionCount(), 0);
+		auto users = std::vector<uint32_t>(m_function.getInstructionCount(), Ir::Function::kNone);
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
 		{
-			auto ix = pushIndex(node.getType());
-			auto op = node.getOperator();
-			if (op == Nodes::BinaryExpressionNode::Operator::Divide)
-			{
-				m_writer << "zrt_Real " << ix << " = (zrt_Real)" << lhs << " / (zrt_Real)" << rhs << ";\n";
-			}
-			else if (op == Nodes::BinaryExpressionNode::Operator::IntDivide)
-			{
-				m_writer << "zrt_Int " << ix << " = (zrt_Int)(" << lhs << " / " << rhs << ");\n";
-			}
-			else
+			for (auto index : m_function.getBlock(block).instructions)
 			{
-				const char* type = "? ";
-				switch (node.getType().base)
+				const auto& instruction = m_function.getInstruction(index);
+				if (instruction.opcode == Opcode::StringRelease)
 				{
-
-				case BaseType_Boolean:
-					type = "zrt_Bool ";
-					break;
-
-				case BaseType_Integer:
-					type = "zrt_Int ";
-					break;
-
-				case BaseType_Real:
-					type = "zrt_Real ";
-					break;
-
-				default:
-					assert(false);
-
+					continue;
 				}
 
-				const char* opStr = "?";
-				switch (node.getOperator())
+				for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
 				{
+					auto value = m_function.getOperand(index, operand);
+					useCounts[value]++;
+					users[value] = index;
+				}
+			}
+		}
 
-				case Nodes::BinaryExpressionNode::Operator::Add:
-					opStr = "+";
-					break;
-
-				case Nodes::BinaryExpressionNode::Operator::Subtract:
-					opStr = "-";
-					break;
-
-				case Nodes::BinaryExpressionNode::Operator::Multiply:
-					opStr = "*";
-					break;
-
-				case Nodes::BinaryExpressionNode::Operator::Modulus:
-					opStr = "%";
-					break;
+		auto isScalar = [](const Type& type) {
+			return type.base == BaseType_Boolean || type.base == BaseType_Integer || type.base == BaseType_Real;
+		};
+		auto isConcatenation = [&](uint32_t index) {
+			const auto& instruction = m_function.getInstruction(index);
+			return instruction.opcode == Opcode::Binary && instruction.type.base == BaseType_String;
+		};
 
-				case Nodes::BinaryExpressionNode::Operator::Equals:
-					opStr = "==";
-					break;
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			for (auto index : m_function.getBlock(block).instructions)
+			{
+				const auto& instruction = m_function.getInstruction(index);
 
-				case Nodes::BinaryExpressionNode::Operator::NotEquals:
-					opStr = "!=";
-					break;
+				// a literal is a static string, read wherever it is used
+				if (instruction.opcode == Opcode::StringLiteral || instruction.opcode == Opcode::StringEmpty)
+				{
+					m_inlined[index] = true;
+					continue;
+				}
 
-				case Nodes::BinaryExpressionNode::Operator::Less:
-					opStr = "<";
-					break;
+				// a concatenation only feeding another in the same block joins it, so the whole chain is one call
+				if (isConcatenation(index))
+				{
+					m_inlined[index] = useCounts[index] == 1 && isConcatenation(users[index])
+						&& m_function.getInstruction(users[index]).block == instruction.block;
+					continue;
+				}
 
-				case Nodes::BinaryExpressionNode::Operator::LessEquals:
-					opStr = "<=";
-					break;
+				if (!isScalar(instruction.type))
+				{
+					continue;
+				}
 
-				case Nodes::BinaryExpressionNode::Operator::Greater:
-					opStr = ">";
-					break;
+				if (instruction.opcode == Opcode::Constant)
+				{
+					m_inlined[index] = true;
+					continue;
+				}
 
-				case Nodes::BinaryExpressionNode::Operator::GreaterEquals:
-					opStr = ">=";
-					break;
+				auto isPure = instruction.opcode == Opcode::Unary || instruction.opcode == Opcode::Binary || instruction.opcode == Opcode::Cast
+					|| (instruction.opcode == Opcode::Call && m_function.getFunction(index).isPure);
+				if (!isPure || useCounts[index] != 1)
+				{
+					continue;
+				}
 
-				case Nodes::BinaryExpressionNode::Operator::BitwiseOr:
-					if (node.getType().base == BaseType_Boolean)
-					{
-						opStr = "||";
-					}
-					else
-					{
-						opStr = "|";
-					}
-					break;
+				// moving the operation to its use must not carry it past the release of a string it reads, or into
+				// another block, where it might run on a path it did not
+				const auto& user = m_function.getInstruction(users[index]);
+				auto isMovable = user.block == instruction.block && user.opcode != Opcode::Phi;
+				for (uint32_t operand = 0; operand < instruction.operandCount && isMovable; ++operand)
+				{
+					isMovable = isScalar(m_function.getInstruction(m_function.getOperand(index, operand)).type);
+				}
 
-				case Nodes::BinaryExpressionNode::Operator::BitwiseAnd:
-					if (node.getType().base == BaseType_Boolean)
-					{
-						opStr = "&&";
-					}
-					else
+				// nor be repeated by a builtin that uses an argument more than once
+				if (isMovable && user.opcode == Opcode::Call)
+				{
+					const auto& builtin = m_function.getFunction(users[index]);
+					for (uint32_t argument = 0; argument < user.operandCount; ++argument)
 					{
-						opStr = "&";
+						if (m_function.getOperand(users[index], argument) == index)
+						{
+							auto placeholder = std::string{ "$" } + char('0' + argument);
+							auto isRepeated = [&](const char* code) {
+								auto text = std::string{ code ? code : "" };
+								auto first = text.find(placeholder);
+								return first != std::string::npos && text.find(placeholder, first + 1) != std::string::npos;
+							};
+							isMovable = !isRepeated(builtin.code) && !isRepeated(builtin.realCode);
+						}
 					}
-					break;
+				}
 
-				case Nodes::BinaryExpressionNode::Operator::BitwiseXor:
-					opStr = "^";
-					break;
+				m_inlined[index] = isMovable;
+			}
+		}
+	}
 
-				default:
-					assert(false);
+	void CTranslator::findLiterals()
+	{
+		m_literals.assign(m_function.getInstructionCount(), Ir::Function::kNone);
+		m_literalTexts.clear();
 
+		auto empty = ConstString{};
+		auto ids = std::unordered_map<std::string, uint32_t>{};
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			for (auto index : m_function.getBlock(block).instructions)
+			{
+				auto opcode = m_function.getInstruction(index).opcode;
+				if (opcode != Opcode::StringLiteral && opcode != Opcode::StringEmpty)
+				{
+					continue;
 				}
 
-				m_writer << type << ix << " = " << lhs << " " << opStr << " " << rhs << ";\n";
+				const auto& text = opcode == Opcode::StringLiteral ? m_function.getText(index) : empty;
+				auto key = std::string{ text.getText(), size_t(text.getLength()) };
+				auto found = ids.emplace(key, uint32_t(m_literalTexts.size()));
+				if (found.second)
+				{
+					m_literalTexts.push_back(text);
+				}
+				m_literals[index] = found.first->second;
 			}
 		}
-		else if (node.getType().base == BaseType_String)
+	}
+
+	void CTranslator::declareLiterals()
+	{
+		if (m_literalTexts.empty())
 		{
-			assert(node.getOperator() == Nodes::BinaryExpressionNode::Operator::Add);
-			auto ix = pushIndex(BaseType_String);
-			m_writer << "zrt_String* " << ix << " = zrt_str_concat(" << lhs << ", " << rhs << ");\n";
+			return;
 		}
 
-		destroyIndex(rhs);
-		destroyIndex(lhs);	
+		// the text is read only, and the runtime never frees or grows an immortal string
+		for (size_t i = 0; i < m_literalTexts.size(); ++i)
+		{
+			m_writer << "static zrt_String lit_" << int64_t(i) << " = { " << int64_t(m_literalTexts[i].getLength())
+				<< ", ZRT_STR_IMMORTAL, (char*)" << Literal{ m_literalTexts[i] } << " };\n";
+		}
+		m_writer << "\n";
 	}
 
-	void CTranslator::translate(const Nodes::BooleanLiteralNode& node)
+	void CTranslator::declareSlots()
 	{
-		auto ix = pushIndex(BaseType_Boolean);
-		m_writer.indent();
-		m_writer << "zrt_Bool " << ix << " = " << node.getValue() << ";\n";
+		for (auto base : { BaseType_Boolean, BaseType_Integer, BaseType_Real, BaseType_String })
+		{
+			for (uint32_t slot = 0; slot < m_slots.getSlotCount(base); ++slot)
+			{
+				m_writer.indent();
+				if (base == BaseType_String)
+				{
+					// an array of one, so the name is the pointer every string function takes
+					m_writer << "zrt_String " << getSlotPrefix(base) << int64_t(slot) << "[1];\n";
+				}
+				else
+				{
+					m_writer << getCType(base) << getSlotPrefix(base) << int64_t(slot) << ";\n";
+				}
+			}
+		}
+
+		for (uint32_t slot = 0; slot < m_slots.getSlotCount(BaseType_String); ++slot)
+		{
+			m_writer.indent();
+			m_writer << "zrt_str_init(" << getSlotPrefix(BaseType_String) << int64_t(slot) << ");\n";
+		}
 	}
 
-	void CTranslator::translate(const Nodes::CastExpressionNode& node)
+	void CTranslator::assign(uint32_t index)
 	{
-		node.getExpression().translate(*this);
-		
-		auto index = popIndex();
-
 		m_writer.indent();
-		switch (node.getType().base)
+		m_writer << Value{ index } << " = ";
+	}
+
+	void CTranslator::translate(uint32_t index)
+	{
+		const auto& instruction = m_function.getInstruction(index);
+		switch (instruction.opcode)
 		{
 
-		case BaseType_Integer:
-			if (index.type.base == BaseType_Boolean)
+		case Opcode::Constant:
+		case Opcode::StringLiteral:
+		case Opcode::StringEmpty:
+		case Opcode::StringCopy:
+		case Opcode::Unary:
+		case Opcode::Binary:
+		case Opcode::Cast:
+		case Opcode::Call:
+			// a value written out where it is used needs no statement of its own
+			if (m_inlined[index])
 			{
-				auto ix = pushIndex(BaseType_Integer);
-				m_writer << "zrt_Int " << ix << " = " << index << " == 0 ? 0 : 1;\n";
+				break;
 			}
-			else if (index.type.base == BaseType_Real)
+
+			if (instruction.type.base == BaseType_String)
 			{
-				auto ix = pushIndex(BaseType_Integer);
-				m_writer << "zrt_Int " << ix << " = (zrt_Int)" << index << ";\n";
+				translateString(index);
 			}
 			else
 			{
-				assert(false);
-			}				
+				assign(index);
+				writeExpression(index);
+				m_writer << ";\n";
+			}
 			break;
 
-		case BaseType_Real:
-			if (index.type.base == BaseType_Integer)
+		case Opcode::StringRelease:
+			// released after its last use instead, as the slot may have been reused by now
+			break;
+
+		case Opcode::Phi:
+			// assigned on the edges
+			break;
+
+		case Opcode::Print:
+			translatePrint(index);
+			break;
+
+		case Opcode::Jump:
+			translateEdge(instruction.block, m_function.getBlock(instruction.block).successors[0]);
+			break;
+
+		case Opcode::Branch:
+		{
+			const auto& successors = m_function.getBlock(instruction.block).successors;
+			m_writer.indent();
+			m_writer << "if (" << getOperand(index, 0) << ")\n";
+			m_writer.indent();
+			m_writer << "{\n";
+			m_writer.pushIndent();
+			translateEdge(instruction.block, successors[0]);
+			m_writer.popIndent();
+			m_writer.indent();
+			m_writer << "}\n";
+			translateEdge(instruction.block, successors[1]);
+			break;
+		}
+
+		case Opcode::Return:
+			for (uint32_t slot = 0; slot < m_slots.getSlotCount(BaseType_String); ++slot)
+			{
+				m_writer.indent();
+				m_writer << "zrt_str_release(" << getSlotPrefix(BaseType_String) << int64_t(slot) << ");\n";
+			}
+			m_writer.indent();
+			m_writer << "return;\n";
+			break;
+
+		case Opcode::Removed:
+			break;
+
+		}
+	}
+
+	void CTranslator::writeExpression(uint32_t index)
+	{
+		const auto& instruction = m_function.getInstruction(index);
+		switch (instruction.opcode)
+		{
+
+		case Opcode::Constant:
+			if (instruction.type.base == BaseType_Real)
 			{
-				auto ix = pushIndex(BaseType_Real);
-				m_writer << "zrt_Real " << ix << " = (zrt_Real)" << index << ";\n";
+				m_writer << m_function.getText(index);
 			}
 			else
 			{
-				assert(false);
+				m_writer << m_function.getInteger(index);
 			}
 			break;
 
+		case Opcode::StringLiteral:
+		case Opcode::StringEmpty:
+			m_writer << "&lit_" << int64_t(m_literals[index]);
+			break;
+
+		case Opcode::Unary:
+			writeUnary(index);
+			break;
+
+		case Opcode::Binary:
+			writeBinary(index);
+			break;
+
+		case Opcode::Cast:
+			writeCast(index);
+			break;
+
+		case Opcode::Call:
+			writeCall(index);
+			break;
+
 		default:
 			assert(false);
+			break;
 
 		}
-
-		destroyIndex(index);
 	}
 
-	void CTranslator::translate(const Nodes::FunctionCallExpressionNode& node)
+	void CTranslator::translateEdge(uint32_t from, uint32_t to)
 	{
-		auto& args = node.getArguments();
-		for (auto& arg : args)
+		const auto& target = m_function.getBlock(to);
+		auto edge = uint32_t(std::find(target.predecessors.begin(), target.predecessors.end(), from) - target.predecessors.begin());
+
+		// phis take their values all at once, so a phi that feeds another on the same edge is read before it changes
+		auto phis = std::vector<uint32_t>{};
+		for (auto index : target.instructions)
 		{
-			arg->translate(*this);
+			if (m_function.getInstruction(index).opcode == Opcode::Phi)
+			{
+				phis.push_back(index);
+			}
 		}
 
-		// TODO : mapping
-		if (node.getName() == "STR$")
-		{
-			auto index = popIndex();
-			assert(index.type.base == BaseType_Integer);
+		// a phi whose operand is already in its slot needs no copy
+		phis.erase(std::remove_if(phis.begin(), phis.end(), [&](uint32_t phi) {
+			auto operand = m_function.getOperand(phi, edge);
+			return !m_inlined[operand] && m_slots.getSlot(operand) == m_slots.getSlot(phi);
+		}), phis.end());
 
-			auto ix = pushIndex(BaseType_String);
+		auto isString = [&](uint32_t phi) { return m_function.getInstruction(phi).type.base == BaseType_String; };
+		if (phis.size() == 1)
+		{
 			m_writer.indent();
-			m_writer << "zrt_String* " << ix << " = zrt_str_new_from_int(" << index << ");\n";
-
-			destroyIndex(index);
+			if (isString(phis[0]))
+			{
+				m_writer << "zrt_str_retain(" << Value{ phis[0] } << ", " << getOperand(phis[0], edge) << ");\n";
+			}
+			else
+			{
+				m_writer << Value{ phis[0] } << " = " << getOperand(phis[0], edge) << ";\n";
+			}
+		}
+		else if (!phis.empty())
+		{
+			m_writer.indent();
+			m_writer << "{\n";
+			m_writer.pushIndent();
+			for (size_t i = 0; i < phis.size(); ++i)
+			{
+				const auto& type = m_function.getInstruction(phis[i]).type;
+				m_writer.indent();
+				m_writer << getCType(type.base) << "p_" << int64_t(i) << " = ";
+				if (isString(phis[i]))
+				{
+					m_writer << "zrt_str_dup(" << getOperand(phis[i], edge) << ");\n";
+				}
+				else
+				{
+					m_writer << getOperand(phis[i], edge) << ";\n";
+				}
+			}
+			for (size_t i = 0; i < phis.size(); ++i)
+			{
+				m_writer.indent();
+				if (isString(phis[i]))
+				{
+					m_writer << "zrt_str_retain(" << Value{ phis[i] } << ", p_" << int64_t(i) << ");\n";
+					m_writer.indent();
+					m_writer << "zrt_str_del(p_" << int64_t(i) << ");\n";
+				}
+				else
+				{
+					m_writer << Value{ phis[i] } << " = p_" << int64_t(i) << ";\n";
+				}
+			}
+			m_writer.popIndent();
+			m_writer.indent();
+			m_writer << "}\n";
 		}
 
+		m_writer.indent();
+		fprintf(m_file, "goto b_%u;\n", to);
 	}
 
-	void CTranslator::translate(const Nodes::IdentifierExpressionNode& node)
+	void CTranslator::writeBinary(uint32_t index)
 	{
-		pushIndex(node.getSymbol());
-	}
+		using Operator = Nodes::BinaryExpressionNode::Operator;
 
-	void CTranslator::translate(const Nodes::IntegerLiteralNode& node)
-	{
-		auto ix = pushIndex(BaseType_Integer);
-		m_writer.indent();
-		m_writer << "zrt_Int " << ix << " = " << node.getValue() << ";\n";
-	}
+		const auto& type = m_function.getInstruction(index).type;
+		auto op = m_function.getBinaryOperator(index);
+		auto lhs = getOperand(index, 0);
+		auto rhs = getOperand(index, 1);
 
-	void CTranslator::translate(const Nodes::PrintStatementNode& node)
-	{
-		const auto expr = node.getExpression();
-		if (expr)
+		if (op == Operator::Divide)
 		{
-			expr->translate(*this);
-			auto index = popIndex();
+			m_writer << "(zrt_Real)" << lhs << " / (zrt_Real)" << rhs;
+			return;
+		}
 
-			m_writer.indent();
-			switch (index.type.base)
-			{
+		if (op == Operator::IntDivide)
+		{
+			m_writer << "(zrt_Int)(" << lhs << " / " << rhs << ")";
+			return;
+		}
 
-			case BaseType_Boolean:
-				m_writer << "zrt_println_bool(" << index << ");\n";
-				break;
+		if (op == Operator::Modulus && type.base == BaseType_Real)
+		{
+			m_writer << "fmod(" << lhs << ", " << rhs << ")";
+			return;
+		}
 
-			case BaseType_Integer:
-				m_writer << "zrt_println_int(" << index << ");\n";
-				break;
+		const char* opStr = "?";
+		switch (op)
+		{
 
-			case BaseType_String:
-				m_writer << "zrt_println_str(" << index << ");\n";
-				break;
+		case Operator::Add:
+			opStr = "+";
+			break;
 
-			case BaseType_Real:
-				m_writer << "zrt_println_real(" << index << ");\n";
-				break;
+		case Operator::Subtract:
+			opStr = "-";
+			break;
 
-			default:
-				assert(false);
-				break;
+		case Operator::Multiply:
+			opStr = "*";
+			break;
 
-			}
+		case Operator::Modulus:
+			opStr = "%";
+			break;
+
+		case Operator::Equals:
+			opStr = "==";
+			break;
+
+		case Operator::NotEquals:
+			opStr = "!=";
+			break;
+
+		case Operator::Less:
+			opStr = "<";
+			break;
+
+		case Operator::LessEquals:
+			opStr = "<=";
+			break;
+
+		case Operator::Greater:
+			opStr = ">";
+			break;
+
+		case Operator::GreaterEquals:
+			opStr = ">=";
+			break;
+
+		case Operator::BitwiseOr:
+			opStr = type.base == BaseType_Boolean ? "||" : "|";
+			break;
+
+		case Operator::BitwiseAnd:
+			opStr = type.base == BaseType_Boolean ? "&&" : "&";
+			break;
+
+		case Operator::BitwiseXor:
+			opStr = "^";
+			break;
+
+		default:
+			assert(false);
 
-			destroyIndex(index);
 		}
-		else
+
+		// two integer constants would otherwise be added or multiplied as C ints
+		auto isConstant = [&](Value value) { return m_inlined[value.index] && m_function.getInstruction(value.index).opcode == Opcode::Constant; };
+		if (type.base == BaseType_Integer && isConstant(lhs) && isConstant(rhs))
 		{
-			m_writer.indent();
-			m_writer << "zrt_println();\n";
+			m_writer << "(zrt_Int)";
 		}
-	}
-
-	void CTranslator::translate(const Nodes::RealLiteralNode& node)
-	{
-		auto ix = pushIndex(BaseType_Real);
-		m_writer.indent();
-		m_writer << "zrt_Real " << ix << " = " << node.getValue().getText() << ";\n";
-	}
 
-	void CTranslator::translate(const Nodes::StringLiteralNode& node)
-	{
-		auto ix = pushIndex(BaseType_String);
-		m_writer.indent();
-		m_writer << "zrt_String* " << ix << " = zrt_str_new(\"" << node.getValue().getText() << "\");\n";
+		m_writer << lhs << " " << opStr << " " << rhs;
 	}
 
-	void CTranslator::translate(const Nodes::UnaryExpressionNode& node)
+	void CTranslator::writeCall(uint32_t index)
 	{
-		node.getExpression().translate(*this);
+		const auto& builtin = m_function.getFunction(index);
+		auto argumentCount = m_function.getInstruction(index).operandCount;
 
-		auto index = popIndex();
-		m_writer.indent();
-		switch (node.getType().base)
+		// a Number argument picks between the integer and real lowerings
+		auto code = builtin.code;
+		for (uint32_t i = 0; i < argumentCount; ++i)
 		{
+			const auto& argument = m_function.getInstruction(m_function.getOperand(index, i));
+			if (builtin.arguments[i] == Builtin::Operand::Number && argument.type.base == BaseType_Real && builtin.realCode)
+			{
+				code = builtin.realCode;
+			}
+		}
 
-		case BaseType_Boolean:
-			if (node.getOperator() == Nodes::UnaryExpressionNode::Operator::BitwiseNot)
+		// expand $n to argument n
+		for (auto ch = code; *ch; ++ch)
+		{
+			if (*ch == '$' && ch[1] >= '0' && ch[1] <= '9')
 			{
-				auto ix = pushIndex(BaseType_Boolean);
-				m_writer << "zrt_Bool " << ix << " = !" << index << ";\n";
+				auto argument = uint32_t(*++ch - '0');
+				if (argument < argumentCount)
+				{
+					m_writer << getOperand(index, argument);
+				}
+				else
+				{
+					assert(builtin.defaultArgument);
+					m_writer << builtin.defaultArgument;
+				}
 			}
 			else
 			{
-				assert(false);
+				m_writer << *ch;
 			}
-			break;
+		}
+	}
+
+	void CTranslator::writeCast(uint32_t index)
+	{
+		auto operand = getOperand(index, 0);
+		const auto& from = m_function.getInstruction(operand.index).type;
+
+		switch (m_function.getInstruction(index).type.base)
+		{
 
 		case BaseType_Integer:
-			if (node.getOperator() == Nodes::UnaryExpressionNode::Operator::Negate)
-			{
-				auto ix = pushIndex(BaseType_Integer);
-				m_writer << "zrt_Int " << ix << " = -" << index << ";\n";
-			}
-			else if (node.getOperator() == Nodes::UnaryExpressionNode::Operator::BitwiseNot)
+			if (from.base == BaseType_Boolean)
 			{
-				auto ix = pushIndex(BaseType_Integer);
-				m_writer << "zrt_Int " << ix << " = ~" << index << ";\n";
+				m_writer << operand << " == 0 ? 0 : 1";
 			}
 			else
 			{
-				assert(false);
+				assert(from.base == BaseType_Real);
+				m_writer << "(zrt_Int)" << operand;
 			}
 			break;
 
 		case BaseType_Real:
-			if (node.getOperator() == Nodes::UnaryExpressionNode::Operator::Negate)
-			{
-				auto ix = pushIndex(BaseType_Real);
-				m_writer << "zrt_Real " << ix << " = -" << index << ";\n";
-			}
-			else
-			{
-				assert(false);
-			}
+			assert(from.base == BaseType_Integer);
+			m_writer << "(zrt_Real)" << operand;
 			break;
 
 		default:
 			assert(false);
-			break;
 
 		}
 	}
 
-	int CTranslator::pushIndex(const Symbol& symbol)
+	void CTranslator::translatePrint(uint32_t index)
 	{
-		m_variableIndices.emplace_back(symbol);
-		return int(m_variableIndices.size() - 1);
-	}
+		m_writer.indent();
+		if (m_function.getInstruction(index).operandCount == 0)
+		{
+			m_writer << "zrt_println();\n";
+			return;
+		}
 
-	int CTranslator::pushIndex(const Type& type)
-	{
-		m_variableIndices.emplace_back(type);
-		m_variableIndices.back().id = m_nextTempId++;
-		return int(m_variableIndices.size() - 1);
+		auto value = getOperand(index, 0);
+		switch (m_function.getInstruction(value.index).type.base)
+		{
+
+		case BaseType_Boolean:
+			m_writer << "zrt_println_bool(" << value << ");\n";
+			break;
+
+		case BaseType_Integer:
+			m_writer << "zrt_println_int(" << value << ");\n";
+			break;
+
+		case BaseType_Real:
+			m_writer << "zrt_println_real(" << value << ");\n";
+			break;
+
+		case BaseType_String:
+			m_writer << "zrt_println_str(" << value << ");\n";
+			break;
+
+		default:
+			assert(false);
+
+		}
 	}
 
-	CTranslator::VariableIndex CTranslator::popIndex()
+	void CTranslator::translateString(uint32_t index)
 	{
-		auto top = m_variableIndices.back();
-		m_variableIndices.pop_back();
-		return top;
+		const auto& instruction = m_function.getInstruction(index);
+		auto slot = Value{ index };
+
+		m_writer.indent();
+		switch (instruction.opcode)
+		{
+
+		case Opcode::StringLiteral:
+		case Opcode::StringEmpty:
+			// only when every value gets a variable of its own
+			m_writer << "zrt_str_copy(" << slot << ", ";
+			writeExpression(index);
+			m_writer << ");\n";
+			break;
+
+		case Opcode::StringCopy:
+			m_writer << "zrt_str_retain(" << slot << ", " << getOperand(index, 0) << ");\n";
+			break;
+
+		case Opcode::Binary:
+		{
+			auto parts = std::vector<Value>{};
+			findParts(index, parts);
+			// the first part of an append is already in the slot, and grows in place
+			auto isAppend = m_slots.isAppend(index);
+			if (parts.size() == 2)
+			{
+				if (isAppend)
+				{
+					m_writer << "zrt_str_append(" << slot << ", " << parts[1] << ");\n";
+				}
+				else
+				{
+					m_writer << "zrt_str_concat_into(" << slot << ", " << parts[0] << ", " << parts[1] << ");\n";
+				}
+				break;
+			}
+
+			auto first = size_t(isAppend ? 1 : 0);
+			m_writer << (isAppend ? "zrt_str_append_n(" : "zrt_str_concat_n(") << slot << ", " << int64_t(parts.size() - first);
+			m_writer << ", (zrt_String*[]){ ";
+			for (size_t i = first; i < parts.size(); ++i)
+			{
+				m_writer << (i == first ? "" : ", ") << parts[i];
+			}
+			m_writer << " });\n";
+			break;
+		}
+
+		case Opcode::Call:
+			// the builtins still return a new string, whose storage replaces the slot's
+			m_writer << "zrt_str_take(" << slot << ", ";
+			writeCall(index);
+			m_writer << ");\n";
+			break;
+
+		default:
+			assert(false);
+
+		}
 	}
 
-	void CTranslator::destroyIndex(const VariableIndex& index)
+	void CTranslator::findParts(uint32_t index, std::vector<Value>& parts)
 	{
-		if (index.indexType == IndexType::Temporary)
+		// a chain can run through many statements, so it is walked with a stack of its own rather than recursively
+		assert(m_function.getBinaryOperator(index) == Nodes::BinaryExpressionNode::Operator::Add);
+		auto pending = std::vector<Value>{ getOperand(index, 1), getOperand(index, 0) };
+		while (!pending.empty())
 		{
-			if (index.type.base == BaseType_String)
+			auto part = pending.back();
+			pending.pop_back();
+			if (m_inlined[part.index] && m_function.getInstruction(part.index).opcode == Opcode::Binary)
 			{
-				m_writer.indent();
-				m_writer << "zrt_str_del(" << index << ");\n";
+				assert(m_function.getBinaryOperator(part.index) == Nodes::BinaryExpressionNode::Operator::Add);
+				pending.push_back(getOperand(part.index, 1));
+				pending.push_back(getOperand(part.index, 0));
+			}
+			else
+			{
+				parts.push_back(part);
 			}
 		}
 	}
+
+	void CTranslator::writeUnary(uint32_t index)
+	{
+		auto operand = getOperand(index, 0);
+		auto op = m_function.getUnaryOperator(index);
+
+		switch (m_function.getInstruction(index).type.base)
+		{
+
+		case BaseType_Boolean:
+			assert(op == Nodes::UnaryExpressionNode::Operator::BitwiseNot);
+			m_writer << "!" << operand;
+			break;
+
+		case BaseType_Integer:
+			m_writer << (op == Nodes::UnaryExpressionNode::Operator::Negate ? "-" : "~") << operand;
+			break;
+
+		case BaseType_Real:
+			assert(op == Nodes::UnaryExpressionNode::Operator::Negate);
+			m_writer << "-" << operand;
+			break;
+
+		default:
+			assert(false);
+
+		}
+	}
+
 }
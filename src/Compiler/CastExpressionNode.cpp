@@ -32,10 +32,10 @@
 namespace ZeeBasic::Compiler::Nodes
 {
 
-	CastExpressionNode::CastExpressionNode(int castType, std::unique_ptr<ExpressionNode> expr)
+	CastExpressionNode::CastExpressionNode(int castType, ExpressionNode* expr)
 		:
 		ExpressionNode(),
-		m_expr(std::move(expr))
+		m_expr(expr)
 	{
 		m_type = castType;
 	}
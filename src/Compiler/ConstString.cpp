@@ -24,9 +24,14 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
+#include <cstring>
 #include <memory>
 #include <vector>
 
+#ifndef _WIN32
+#include <strings.h>
+#endif
+
 #include "ZeeBasic/Compiler/ConstString.hpp"
 
 namespace ZeeBasic::Compiler
@@ -76,27 +81,40 @@ namespace ZeeBasic::Compiler
         m_length(len > 0 ? len : 0)
     { }
 
+    ConstString::ConstString(ViewTag, const char* text, int len)
+        :
+        m_text(len > 0 ? text : kEmptyString),
+        m_length(len > 0 ? len : 0)
+    { }
+
     ConstString::~ConstString()
     { }
 
-    bool ConstString::operator==(const char* text) const
+    ConstString ConstString::view(const char* text, int length)
+    {
+        return { ViewTag{}, text, length };
+    }
+
+    static bool equalsIgnoreCase(const char* lhs, const char* rhs, int len)
     {
 #ifdef _WIN32
-        return _stricmp(m_text, text) == 0;
+        return _strnicmp(lhs, rhs, size_t(len)) == 0;
 #else
-        return strcasecmp(m_text, text) == 0;
+        return strncasecmp(lhs, rhs, size_t(len)) == 0;
 #endif
     }
 
+    bool ConstString::operator==(const char* text) const
+    {
+        // text may only be a prefix of ours, so confirm it ends where we do
+        return equalsIgnoreCase(m_text, text, m_length) && text[m_length] == 0;
+    }
+
     bool ConstString::operator==(const ConstString& str) const
     {
         if (m_length == str.m_length)
         {
-#ifdef _WIN32
-            return _stricmp(m_text, str.m_text) == 0;
-#else
-            return strcasecmp(m_text, str.m_text) == 0;
-#endif
+            return equalsIgnoreCase(m_text, str.m_text, m_length);
         }
 
         return false;
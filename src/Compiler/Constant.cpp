@@ -0,0 +1,302 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "ZeeBasic/Compiler/Constant.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	using UnaryOperator = Nodes::UnaryExpressionNode::Operator;
+	using BinaryOperator = Nodes::BinaryExpressionNode::Operator;
+
+	// integer results must fit a C literal, which rules out INT64_MIN as well as overflow
+	static bool isFoldable(int64_t value)
+	{
+		return value != INT64_MIN;
+	}
+
+	static bool addOverflows(int64_t a, int64_t b)
+	{
+		return b > 0 ? a > INT64_MAX - b : a < INT64_MIN - b;
+	}
+
+	static bool subtractOverflows(int64_t a, int64_t b)
+	{
+		return b < 0 ? a > INT64_MAX + b : a < INT64_MIN + b;
+	}
+
+	static bool multiplyOverflows(int64_t a, int64_t b)
+	{
+		if (a > 0)
+		{
+			return b > 0 ? a > INT64_MAX / b : b < INT64_MIN / a;
+		}
+		if (b > 0)
+		{
+			return a < INT64_MIN / b;
+		}
+		return a != 0 && b < INT64_MAX / a;
+	}
+
+	static bool fitsInteger(double value)
+	{
+		return value > -9223372036854775808.0 && value < 9223372036854775808.0;
+	}
+
+	template<typename T>
+	static bool compare(BinaryOperator op, T lhs, T rhs, int64_t& result)
+	{
+		switch (op)
+		{
+		case BinaryOperator::Equals: result = lhs == rhs; return true;
+		case BinaryOperator::NotEquals: result = lhs != rhs; return true;
+		case BinaryOperator::Less: result = lhs < rhs; return true;
+		case BinaryOperator::LessEquals: result = lhs <= rhs; return true;
+		case BinaryOperator::Greater: result = lhs > rhs; return true;
+		case BinaryOperator::GreaterEquals: result = lhs >= rhs; return true;
+		default: return false;
+		}
+	}
+
+	static bool evaluateBooleans(BinaryOperator op, int64_t lhs, int64_t rhs, int64_t& result)
+	{
+		switch (op)
+		{
+		case BinaryOperator::BitwiseAnd: result = lhs && rhs; return true;
+		case BinaryOperator::BitwiseOr: result = lhs || rhs; return true;
+		case BinaryOperator::BitwiseXor: result = lhs ^ rhs; return true;
+		default: return compare(op, lhs, rhs, result);
+		}
+	}
+
+	static bool evaluateIntegers(BinaryOperator op, int64_t lhs, int64_t rhs, int64_t& result)
+	{
+		switch (op)
+		{
+
+		case BinaryOperator::Add:
+			result = lhs + (addOverflows(lhs, rhs) ? 0 : rhs);
+			return !addOverflows(lhs, rhs) && isFoldable(result);
+
+		case BinaryOperator::Subtract:
+			result = lhs - (subtractOverflows(lhs, rhs) ? 0 : rhs);
+			return !subtractOverflows(lhs, rhs) && isFoldable(result);
+
+		case BinaryOperator::Multiply:
+			if (multiplyOverflows(lhs, rhs))
+			{
+				return false;
+			}
+			result = lhs * rhs;
+			return isFoldable(result);
+
+		case BinaryOperator::IntDivide:
+		case BinaryOperator::Modulus:
+			if (rhs == 0 || (lhs == INT64_MIN && rhs == -1))
+			{
+				return false;
+			}
+			result = op == BinaryOperator::IntDivide ? lhs / rhs : lhs % rhs;
+			return isFoldable(result);
+
+		case BinaryOperator::BitwiseAnd: result = lhs & rhs; return isFoldable(result);
+		case BinaryOperator::BitwiseOr: result = lhs | rhs; return isFoldable(result);
+		case BinaryOperator::BitwiseXor: result = lhs ^ rhs; return isFoldable(result);
+
+		default:
+			return compare(op, lhs, rhs, result);
+
+		}
+	}
+
+	static bool evaluateReals(BinaryOperator op, double lhs, double rhs, double& real, int64_t& integer)
+	{
+		switch (op)
+		{
+		case BinaryOperator::Add: real = lhs + rhs; break;
+		case BinaryOperator::Subtract: real = lhs - rhs; break;
+		case BinaryOperator::Multiply: real = lhs * rhs; break;
+		case BinaryOperator::Divide: real = lhs / rhs; break;
+		case BinaryOperator::Modulus: real = std::fmod(lhs, rhs); break;
+
+		case BinaryOperator::IntDivide:
+			real = lhs / rhs;
+			if (!std::isfinite(real) || !fitsInteger(real))
+			{
+				return false;
+			}
+			integer = int64_t(real);
+			return isFoldable(integer);
+
+		default:
+			return compare(op, lhs, rhs, integer);
+		}
+
+		return std::isfinite(real);
+	}
+
+	bool evaluateUnary(UnaryOperator op, const Type& type, const Constant& operand, Constant& result)
+	{
+		result = operand;
+		switch (type.base)
+		{
+
+		case BaseType_Boolean:
+			result.integer = !operand.integer;
+			return true;
+
+		case BaseType_Integer:
+			if (op == UnaryOperator::Negate)
+			{
+				result.integer = isFoldable(operand.integer) ? -operand.integer : 0;
+				return isFoldable(operand.integer);
+			}
+			result.integer = ~operand.integer;
+			return isFoldable(result.integer);
+
+		case BaseType_Real:
+			result.real = -operand.real;
+			result.text = formatReal(result.real);
+			return true;
+
+		default:
+			return false;
+
+		}
+	}
+
+	bool evaluateBinary(BinaryOperator op, const Type& type, const Constant& lhs, const Constant& rhs, Constant& result)
+	{
+		result = Constant{ type.base };
+		auto evaluated = false;
+		switch (lhs.base)
+		{
+
+		case BaseType_Boolean:
+			evaluated = evaluateBooleans(op, lhs.integer, rhs.integer, result.integer);
+			break;
+
+		case BaseType_Integer:
+			if (op == BinaryOperator::Divide)
+			{
+				result.real = double(lhs.integer) / double(rhs.integer);
+				evaluated = std::isfinite(result.real);
+			}
+			else
+			{
+				evaluated = evaluateIntegers(op, lhs.integer, rhs.integer, result.integer);
+			}
+			break;
+
+		case BaseType_Real:
+			evaluated = evaluateReals(op, lhs.real, rhs.real, result.real, result.integer);
+			break;
+
+		case BaseType_String:
+		{
+			if (op != BinaryOperator::Add)
+			{
+				return false;
+			}
+			auto text = std::string{ lhs.text.getText(), size_t(lhs.text.getLength()) };
+			text.append(rhs.text.getText(), size_t(rhs.text.getLength()));
+			result.text = ConstString{ text.c_str(), int(text.size()) };
+			return true;
+		}
+
+		default:
+			return false;
+
+		}
+
+		if (evaluated && result.base == BaseType_Real)
+		{
+			result.text = formatReal(result.real);
+		}
+		return evaluated;
+	}
+
+	bool evaluateCast(const Type& type, const Constant& operand, Constant& result)
+	{
+		result = Constant{ type.base };
+		if (type.base == BaseType_Integer && operand.base == BaseType_Boolean)
+		{
+			result.integer = operand.integer == 0 ? 0 : 1;
+			return true;
+		}
+
+		if (type.base == BaseType_Integer && operand.base == BaseType_Real)
+		{
+			// C truncates toward zero, and leaves values out of range undefined
+			if (!fitsInteger(operand.real) || !isFoldable(int64_t(operand.real)))
+			{
+				return false;
+			}
+			result.integer = int64_t(operand.real);
+			return true;
+		}
+
+		if (type.base == BaseType_Real && operand.base == BaseType_Integer)
+		{
+			result.real = double(operand.integer);
+			result.text = formatReal(result.real);
+			return true;
+		}
+
+		return false;
+	}
+
+	ConstString formatReal(double value)
+	{
+		char buf[32];
+		for (auto precision = 15; precision <= 17; ++precision)
+		{
+			snprintf(buf, sizeof(buf), "%.*g", precision, value);
+			if (strtod(buf, nullptr) == value)
+			{
+				break;
+			}
+		}
+
+		auto text = std::string{ buf };
+		if (text.find_first_of(".e") == std::string::npos)
+		{
+			text += ".0";
+		}
+		return ConstString{ text.c_str(), int(text.size()) };
+	}
+
+	double parseReal(const ConstString& text)
+	{
+		return strtod(std::string{ text.getText(), size_t(text.getLength()) }.c_str(), nullptr);
+	}
+
+}
@@ -0,0 +1,343 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <cassert>
+
+#include "ZeeBasic/Compiler/ConstantFolder.hpp"
+
+#include "ZeeBasic/Compiler/Constant.hpp"
+#include "ZeeBasic/Compiler/Error.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	using BinaryOperator = Nodes::BinaryExpressionNode::Operator;
+
+	static FlatAst::Kind getLiteralKind(int base)
+	{
+		switch (base)
+		{
+
+		case BaseType_Boolean:
+			return FlatAst::Kind::BooleanLiteral;
+
+		case BaseType_Integer:
+			return FlatAst::Kind::IntegerLiteral;
+
+		case BaseType_Real:
+			return FlatAst::Kind::RealLiteral;
+
+		default:
+			return FlatAst::Kind::StringLiteral;
+
+		}
+	}
+
+	ConstantFolder::ConstantFolder(const FlatAst& ast)
+		:
+		m_ast(ast)
+	{ }
+
+	ConstantFolder::~ConstantFolder()
+	{ }
+
+	FlatAst ConstantFolder::run()
+	{
+		m_map.resize(m_ast.getCount());
+		for (uint32_t index = 0; index < m_ast.getCount(); ++index)
+		{
+			m_map[index] = fold(index);
+		}
+
+		return std::move(m_folded);
+	}
+
+	uint32_t ConstantFolder::fold(uint32_t index)
+	{
+		auto location = m_ast.getLocation(index);
+		switch (m_ast.getKind(index))
+		{
+
+		case FlatAst::Kind::BooleanLiteral:
+			return added(m_folded.addBooleanLiteral(m_ast.getBoolean(index), location), kSelf, true);
+
+		case FlatAst::Kind::IntegerLiteral:
+			return added(m_folded.addIntegerLiteral(m_ast.getInteger(index), location), kSelf, true);
+
+		case FlatAst::Kind::RealLiteral:
+			return added(m_folded.addRealLiteral(m_ast.getText(index), location), kSelf, true);
+
+		case FlatAst::Kind::StringLiteral:
+			return added(m_folded.addStringLiteral(m_ast.getText(index), location), kSelf, true);
+
+		case FlatAst::Kind::Identifier:
+		{
+			const auto& symbol = m_ast.getSymbol(index);
+			if (symbol.isConstant)
+			{
+				// a constant is always declared before its uses, as the parser rejects a CONST for a name already in use
+				auto found = m_constants.find(&symbol);
+				assert(found != m_constants.end());
+				return addValue(found->second, location);
+			}
+			return added(m_folded.addIdentifier(symbol, location), kSelf, true);
+		}
+
+		case FlatAst::Kind::Unary:
+			return foldUnary(index);
+
+		case FlatAst::Kind::Binary:
+			return foldBinary(index);
+
+		case FlatAst::Kind::Cast:
+			return foldCast(index);
+
+		case FlatAst::Kind::FunctionCall:
+			return foldFunctionCall(index);
+
+		case FlatAst::Kind::Assignment:
+			return foldAssignment(index);
+
+		case FlatAst::Kind::Print:
+		{
+			auto value = m_ast.getFirst(index);
+			value = value == FlatAst::kNone ? value : m_map[value];
+			return added(m_folded.addPrint(value, location), kSelf, false);
+		}
+
+		}
+
+		assert(false);
+		return FlatAst::kNone;
+	}
+
+	uint32_t ConstantFolder::foldUnary(uint32_t index)
+	{
+		auto op = m_ast.getUnaryOperator(index);
+		const auto& type = m_ast.getType(index);
+		auto operand = m_map[m_ast.getFirst(index)];
+
+		auto value = Constant{};
+		auto result = Constant{};
+		if (getValue(operand, value) && evaluateUnary(op, type, value, result))
+		{
+			drop(operand);
+			return addValue(result, m_ast.getLocation(index));
+		}
+
+		return added(m_folded.addUnary(op, type, operand, m_ast.getLocation(index)), m_starts[operand], m_pure[operand]);
+	}
+
+	uint32_t ConstantFolder::foldBinary(uint32_t index)
+	{
+		auto op = m_ast.getBinaryOperator(index);
+		const auto& type = m_ast.getType(index);
+		auto location = m_ast.getLocation(index);
+		auto lhs = m_map[m_ast.getFirst(index)];
+		auto rhs = m_map[m_ast.getSecond(index)];
+
+		auto left = Constant{};
+		auto right = Constant{};
+		auto isLeftConstant = getValue(lhs, left);
+		auto isRightConstant = getValue(rhs, right);
+
+		if (isLeftConstant && isRightConstant)
+		{
+			auto result = Constant{};
+			if (evaluateBinary(op, type, left, right, result))
+			{
+				drop(lhs);
+				return addValue(result, location);
+			}
+		}
+		else if (isRightConstant && m_folded.getType(lhs).base == type.base)
+		{
+			// identities with a constant right-hand side, which is the last node of the copy; a constant left-hand side
+			// sits before the other operand, so it is left alone
+			auto isZero = right.base == BaseType_Real ? right.real == 0.0 : right.integer == 0;
+			auto isOne = right.base == BaseType_Real ? right.real == 1.0 : right.integer == 1;
+			auto isIdentity = false;
+			auto isAbsorbing = false;
+			switch (right.base)
+			{
+
+			case BaseType_Boolean:
+				isIdentity = (op == BinaryOperator::BitwiseAnd && isOne) || ((op == BinaryOperator::BitwiseOr || op == BinaryOperator::BitwiseXor) && isZero);
+				isAbsorbing = (op == BinaryOperator::BitwiseAnd && isZero) || (op == BinaryOperator::BitwiseOr && isOne);
+				break;
+
+			case BaseType_Integer:
+				isIdentity = ((op == BinaryOperator::Add || op == BinaryOperator::Subtract || op == BinaryOperator::BitwiseOr || op == BinaryOperator::BitwiseXor) && isZero)
+					|| ((op == BinaryOperator::Multiply || op == BinaryOperator::IntDivide) && isOne);
+				isAbsorbing = (op == BinaryOperator::Multiply || op == BinaryOperator::BitwiseAnd) && isZero;
+				break;
+
+			case BaseType_Real:
+				// x + 0.0 is not x when x is -0.0, and x * 0.0 is not 0.0 when x is negative, infinite or NaN
+				isIdentity = (op == BinaryOperator::Subtract && isZero) || ((op == BinaryOperator::Multiply || op == BinaryOperator::Divide) && isOne);
+				break;
+
+			case BaseType_String:
+				isIdentity = right.text.getLength() == 0;
+				break;
+
+			default:
+				break;
+
+			}
+
+			if (isIdentity)
+			{
+				drop(rhs);
+				return lhs;
+			}
+
+			if (isAbsorbing && m_pure[lhs])
+			{
+				drop(m_starts[lhs]);
+				return addValue(right, location);
+			}
+		}
+
+		return added(m_folded.addBinary(op, type, lhs, rhs, location), m_starts[lhs], m_pure[lhs] && m_pure[rhs]);
+	}
+
+	uint32_t ConstantFolder::foldCast(uint32_t index)
+	{
+		const auto& type = m_ast.getType(index);
+		auto operand = m_map[m_ast.getFirst(index)];
+
+		auto value = Constant{};
+		auto result = Constant{};
+		if (getValue(operand, value) && evaluateCast(type, value, result))
+		{
+			drop(operand);
+			return addValue(result, m_ast.getLocation(index));
+		}
+
+		return added(m_folded.addCast(type, operand, m_ast.getLocation(index)), m_starts[operand], m_pure[operand]);
+	}
+
+	uint32_t ConstantFolder::foldFunctionCall(uint32_t index)
+	{
+		const auto& builtin = m_ast.getFunction(index);
+
+		auto arguments = std::vector<uint32_t>{};
+		auto pure = builtin.isPure;
+		for (uint32_t i = 0; i < m_ast.getArgumentCount(index); ++i)
+		{
+			arguments.push_back(m_map[m_ast.getArgument(index, i)]);
+			pure = pure && m_pure[arguments.back()];
+		}
+
+		auto call = m_folded.addFunctionCall(builtin, m_ast.getType(index), arguments, m_ast.getLocation(index));
+		return added(call, arguments.empty() ? call : m_starts[arguments.front()], pure);
+	}
+
+	uint32_t ConstantFolder::foldAssignment(uint32_t index)
+	{
+		const auto& symbol = m_ast.getSymbol(index);
+		auto value = m_map[m_ast.getSecond(index)];
+
+		if (symbol.isConstant)
+		{
+			auto constant = Constant{};
+			if (!getValue(value, constant))
+			{
+				throw Error::create(m_ast.getLocation(index), "Expected constant value for CONST");
+			}
+
+			// the declaration itself leaves nothing to run
+			m_constants[&symbol] = constant;
+			drop(value);
+			return FlatAst::kNone;
+		}
+
+		return added(m_folded.addAssignment(symbol, value, m_ast.getLocation(index)), m_starts[value], false);
+	}
+
+	bool ConstantFolder::getValue(uint32_t folded, Constant& value) const
+	{
+		switch (m_folded.getKind(folded))
+		{
+
+		case FlatAst::Kind::BooleanLiteral:
+			value = Constant{ BaseType_Boolean, m_folded.getBoolean(folded) };
+			return true;
+
+		case FlatAst::Kind::IntegerLiteral:
+			value = Constant{ BaseType_Integer, m_folded.getInteger(folded) };
+			return true;
+
+		case FlatAst::Kind::RealLiteral:
+			value = Constant{ BaseType_Real, 0, parseReal(m_folded.getText(folded)), m_folded.getText(folded) };
+			return true;
+
+		case FlatAst::Kind::StringLiteral:
+			value = Constant{ BaseType_String, 0, 0.0, m_folded.getText(folded) };
+			return true;
+
+		default:
+			return false;
+
+		}
+	}
+
+	uint32_t ConstantFolder::addValue(const Constant& value, SourceLocation location)
+	{
+		switch (getLiteralKind(value.base))
+		{
+
+		case FlatAst::Kind::BooleanLiteral:
+			return added(m_folded.addBooleanLiteral(value.integer != 0, location), kSelf, true);
+
+		case FlatAst::Kind::IntegerLiteral:
+			return added(m_folded.addIntegerLiteral(value.integer, location), kSelf, true);
+
+		case FlatAst::Kind::RealLiteral:
+			return added(m_folded.addRealLiteral(value.text, location), kSelf, true);
+
+		default:
+			return added(m_folded.addStringLiteral(value.text, location), kSelf, true);
+
+		}
+	}
+
+	uint32_t ConstantFolder::added(uint32_t folded, uint32_t start, bool pure)
+	{
+		m_starts.push_back(start == kSelf ? folded : start);
+		m_pure.push_back(pure);
+		return folded;
+	}
+
+	void ConstantFolder::drop(uint32_t count)
+	{
+		m_folded.truncate(count);
+		m_starts.resize(count);
+		m_pure.resize(count);
+	}
+
+}
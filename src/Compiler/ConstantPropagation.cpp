@@ -0,0 +1,407 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <algorithm>
+#include <cassert>
+
+#include "ZeeBasic/Compiler/ConstantPropagation.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	using Ir::Opcode;
+
+	static bool isSameConstant(const Constant& a, const Constant& b)
+	{
+		if (a.base != b.base)
+		{
+			return false;
+		}
+
+		// reals compare by text, so that 0.0 and -0.0 stay apart
+		return a.base == BaseType_Real || a.base == BaseType_String ? a.text == b.text : a.integer == b.integer;
+	}
+
+	ConstantPropagation::ConstantPropagation(Ir::Function& function)
+		:
+		m_function(function)
+	{ }
+
+	ConstantPropagation::~ConstantPropagation()
+	{ }
+
+	void ConstantPropagation::run()
+	{
+		auto instructionCount = m_function.getInstructionCount();
+		m_states.assign(instructionCount, State::Unknown);
+		m_values.assign(instructionCount, Constant{});
+		m_users.assign(instructionCount, {});
+		for (uint32_t index = 0; index < instructionCount; ++index)
+		{
+			const auto& instruction = m_function.getInstruction(index);
+			for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
+			{
+				m_users[m_function.getOperand(index, operand)].push_back(index);
+			}
+		}
+
+		m_reached.assign(m_function.getBlockCount(), false);
+		m_taken.resize(m_function.getBlockCount());
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			m_taken[block].assign(m_function.getBlock(block).predecessors.size(), false);
+		}
+
+		// the entry block is reached without an edge
+		m_reached[0] = true;
+		for (auto index : m_function.getBlock(0).instructions)
+		{
+			visit(index);
+		}
+
+		while (!m_edgeWorklist.empty() || !m_valueWorklist.empty())
+		{
+			while (!m_edgeWorklist.empty())
+			{
+				auto edge = m_edgeWorklist.back();
+				m_edgeWorklist.pop_back();
+
+				// the first edge into a block visits all of it, later ones only what they can change
+				const auto& block = m_function.getBlock(edge.second);
+				auto isFirst = !m_reached[edge.second];
+				m_reached[edge.second] = true;
+				for (auto index : block.instructions)
+				{
+					if (isFirst || m_function.getInstruction(index).opcode == Opcode::Phi)
+					{
+						visit(index);
+					}
+				}
+			}
+
+			while (!m_valueWorklist.empty())
+			{
+				auto value = m_valueWorklist.back();
+				m_valueWorklist.pop_back();
+
+				for (auto user : m_users[value])
+				{
+					if (m_reached[m_function.getInstruction(user).block])
+					{
+						visit(user);
+					}
+				}
+			}
+		}
+
+		rewrite();
+	}
+
+	void ConstantPropagation::visit(uint32_t index)
+	{
+		const auto& instruction = m_function.getInstruction(index);
+		switch (instruction.opcode)
+		{
+
+		case Opcode::Constant:
+			if (instruction.type.base == BaseType_Real)
+			{
+				const auto& text = m_function.getText(index);
+				setState(index, State::Constant, Constant{ BaseType_Real, 0, parseReal(text), text });
+			}
+			else
+			{
+				setState(index, State::Constant, Constant{ instruction.type.base, m_function.getInteger(index) });
+			}
+			break;
+
+		case Opcode::StringLiteral:
+			setState(index, State::Constant, Constant{ BaseType_String, 0, 0.0, m_function.getText(index) });
+			break;
+
+		case Opcode::StringEmpty:
+			setState(index, State::Constant, Constant{ BaseType_String });
+			break;
+
+		case Opcode::StringCopy:
+		case Opcode::Unary:
+		case Opcode::Binary:
+		case Opcode::Cast:
+			visitOperation(index);
+			break;
+
+		case Opcode::Call:
+			// builtins are left to run time
+			setState(index, State::Varying);
+			break;
+
+		case Opcode::Phi:
+			visitPhi(index);
+			break;
+
+		case Opcode::Jump:
+			takeEdge(instruction.block, m_function.getBlock(instruction.block).successors[0]);
+			break;
+
+		case Opcode::Branch:
+			visitBranch(index);
+			break;
+
+		default:
+			break;
+
+		}
+	}
+
+	void ConstantPropagation::visitPhi(uint32_t index)
+	{
+		const auto& instruction = m_function.getInstruction(index);
+		const auto& taken = m_taken[instruction.block];
+
+		// only values arriving over edges that can be taken count
+		auto state = State::Unknown;
+		auto value = Constant{};
+		for (uint32_t edge = 0; edge < instruction.operandCount && state != State::Varying; ++edge)
+		{
+			auto operand = m_function.getOperand(index, edge);
+			if (!taken[edge] || m_states[operand] == State::Unknown)
+			{
+				continue;
+			}
+
+			if (m_states[operand] == State::Varying || (state == State::Constant && !isSameConstant(value, m_values[operand])))
+			{
+				state = State::Varying;
+			}
+			else
+			{
+				state = State::Constant;
+				value = m_values[operand];
+			}
+		}
+
+		setState(index, state, value);
+	}
+
+	void ConstantPropagation::visitOperation(uint32_t index)
+	{
+		const auto& instruction = m_function.getInstruction(index);
+		for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
+		{
+			auto state = m_states[m_function.getOperand(index, operand)];
+			if (state != State::Constant)
+			{
+				setState(index, state);
+				return;
+			}
+		}
+
+		const auto& first = m_values[m_function.getOperand(index, 0)];
+		auto value = Constant{};
+		auto evaluated = false;
+		switch (instruction.opcode)
+		{
+
+		case Opcode::StringCopy:
+			value = first;
+			evaluated = true;
+			break;
+
+		case Opcode::Unary:
+			evaluated = evaluateUnary(m_function.getUnaryOperator(index), instruction.type, first, value);
+			break;
+
+		case Opcode::Binary:
+			evaluated = evaluateBinary(m_function.getBinaryOperator(index), instruction.type, first, m_values[m_function.getOperand(index, 1)], value);
+			break;
+
+		case Opcode::Cast:
+			evaluated = evaluateCast(instruction.type, first, value);
+			break;
+
+		default:
+			break;
+
+		}
+
+		setState(index, evaluated ? State::Constant : State::Varying, value);
+	}
+
+	void ConstantPropagation::visitBranch(uint32_t index)
+	{
+		const auto& instruction = m_function.getInstruction(index);
+		const auto& successors = m_function.getBlock(instruction.block).successors;
+		auto condition = m_function.getOperand(index, 0);
+
+		switch (m_states[condition])
+		{
+
+		case State::Unknown:
+			break;
+
+		case State::Constant:
+			takeEdge(instruction.block, successors[m_values[condition].integer != 0 ? 0 : 1]);
+			break;
+
+		case State::Varying:
+			takeEdge(instruction.block, successors[0]);
+			takeEdge(instruction.block, successors[1]);
+			break;
+
+		}
+	}
+
+	void ConstantPropagation::takeEdge(uint32_t from, uint32_t to)
+	{
+		const auto& predecessors = m_function.getBlock(to).predecessors;
+		auto edge = size_t(std::find(predecessors.begin(), predecessors.end(), from) - predecessors.begin());
+		if (!m_taken[to][edge])
+		{
+			m_taken[to][edge] = true;
+			m_edgeWorklist.emplace_back(from, to);
+		}
+	}
+
+	void ConstantPropagation::setState(uint32_t index, State state, const Constant& value)
+	{
+		// states only ever move down, which bounds the work and guarantees an end
+		if (state == m_states[index])
+		{
+			return;
+		}
+		assert(state > m_states[index]);
+
+		m_states[index] = state;
+		m_values[index] = value;
+		m_valueWorklist.push_back(index);
+	}
+
+	void ConstantPropagation::rewrite()
+	{
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			if (!m_reached[block])
+			{
+				continue;
+			}
+
+			// copy, as a folded branch changes the block
+			auto instructions = m_function.getBlock(block).instructions;
+			for (auto index : instructions)
+			{
+				const auto& instruction = m_function.getInstruction(index);
+				switch (instruction.opcode)
+				{
+
+				case Opcode::Phi:
+					// a string phi takes over the strings flowing into it, which still have to be released
+					if (instruction.type.base == BaseType_String)
+					{
+						break;
+					}
+					[[fallthrough]];
+
+				case Opcode::StringCopy:
+				case Opcode::Unary:
+				case Opcode::Binary:
+				case Opcode::Cast:
+					if (m_states[index] == State::Constant)
+					{
+						m_function.replaceWithConstant(index, m_values[index]);
+					}
+					break;
+
+				case Opcode::Branch:
+				{
+					auto condition = m_function.getOperand(index, 0);
+					if (m_states[condition] == State::Constant)
+					{
+						const auto& successors = m_function.getBlock(block).successors;
+						m_function.replaceWithJump(index, successors[m_values[condition].integer != 0 ? 0 : 1]);
+					}
+					break;
+				}
+
+				default:
+					break;
+
+				}
+			}
+		}
+
+		// empty the blocks that cannot be reached and cut them off from the rest, and drop each phi left with a single
+		// edge in favour of its operand
+		auto removed = std::vector<bool>(m_function.getInstructionCount(), false);
+		auto replacements = std::vector<uint32_t>(m_function.getInstructionCount(), Ir::Function::kNone);
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			if (!m_reached[block])
+			{
+				for (auto index : m_function.getBlock(block).instructions)
+				{
+					removed[index] = true;
+				}
+
+				auto successors = m_function.getBlock(block).successors;
+				for (auto successor : successors)
+				{
+					m_function.removeEdge(block, successor);
+				}
+			}
+		}
+
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			for (auto index : m_function.getBlock(block).instructions)
+			{
+				const auto& instruction = m_function.getInstruction(index);
+				if (!removed[index] && instruction.opcode == Opcode::Phi && instruction.operandCount == 1)
+				{
+					replacements[index] = m_function.getOperand(index, 0);
+					removed[index] = true;
+				}
+			}
+		}
+
+		for (uint32_t index = 0; index < m_function.getInstructionCount(); ++index)
+		{
+			const auto& instruction = m_function.getInstruction(index);
+			for (uint32_t operand = 0; !removed[index] && operand < instruction.operandCount; ++operand)
+			{
+				// a phi may stand for another phi that went too
+				auto value = m_function.getOperand(index, operand);
+				while (replacements[value] != Ir::Function::kNone)
+				{
+					value = replacements[value];
+				}
+				m_function.setOperand(index, operand, value);
+			}
+		}
+
+		m_function.remove(removed);
+	}
+
+}
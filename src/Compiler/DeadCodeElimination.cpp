@@ -0,0 +1,114 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include "ZeeBasic/Compiler/DeadCodeElimination.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	using Ir::Opcode;
+
+	DeadCodeElimination::DeadCodeElimination(Ir::Function& function)
+		:
+		m_function(function)
+	{ }
+
+	DeadCodeElimination::~DeadCodeElimination()
+	{ }
+
+	void DeadCodeElimination::run()
+	{
+		m_live.assign(m_function.getInstructionCount(), false);
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			for (auto index : m_function.getBlock(block).instructions)
+			{
+				if (isNeeded(index))
+				{
+					markLive(index);
+				}
+			}
+		}
+
+		while (!m_worklist.empty())
+		{
+			auto index = m_worklist.back();
+			m_worklist.pop_back();
+
+			const auto& instruction = m_function.getInstruction(index);
+			for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
+			{
+				markLive(m_function.getOperand(index, operand));
+			}
+		}
+
+		auto removed = std::vector<bool>(m_function.getInstructionCount(), false);
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			for (auto index : m_function.getBlock(block).instructions)
+			{
+				// a release stays for as long as the string it frees does
+				auto isLive = m_live[index];
+				if (m_function.getInstruction(index).opcode == Opcode::StringRelease)
+				{
+					isLive = m_live[m_function.getOperand(index, 0)];
+				}
+				removed[index] = !isLive;
+			}
+		}
+		m_function.remove(removed);
+	}
+
+	bool DeadCodeElimination::isNeeded(uint32_t index) const
+	{
+		switch (m_function.getInstruction(index).opcode)
+		{
+
+		case Opcode::Print:
+		case Opcode::Jump:
+		case Opcode::Branch:
+		case Opcode::Return:
+			return true;
+
+		case Opcode::Call:
+			return !m_function.getFunction(index).isPure;
+
+		default:
+			return false;
+
+		}
+	}
+
+	void DeadCodeElimination::markLive(uint32_t index)
+	{
+		if (!m_live[index])
+		{
+			m_live[index] = true;
+			m_worklist.push_back(index);
+		}
+	}
+
+}
@@ -25,6 +25,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
 #include <cstdarg>
+#include <cstdio>
 
 #include "ZeeBasic/Compiler/Error.hpp"
 
@@ -35,27 +36,45 @@ namespace ZeeBasic::Compiler
 
     Error Error::create(const Range& range, const char* format, ...)
     {
-#ifdef _WIN32
-        auto len = snprintf(messageBuffer, sizeof(messageBuffer), "[%lld:%lld] ", range.startLine, range.startCol);
-#else
-        auto len = snprintf(messageBuffer, sizeof(messageBuffer), "[%d:%d] ", range.startLine, range.startCol);
-#endif
+        va_list ap;
+        va_start(ap, format);
+        vsnprintf(messageBuffer, sizeof(messageBuffer), format, ap);
+        va_end(ap);
 
+        return { SourceLocation{}, range, messageBuffer };
+    }
+
+    Error Error::create(SourceLocation location, const char* format, ...)
+    {
         va_list ap;
         va_start(ap, format);
-        vsnprintf(messageBuffer + len, sizeof(messageBuffer) - len, format, ap);
+        vsnprintf(messageBuffer, sizeof(messageBuffer), format, ap);
         va_end(ap);
 
-        return { range, messageBuffer };
+        return { location, {}, messageBuffer };
     }
 
-    Error::Error(const Range& range, const char* msg)
+    Error::Error(SourceLocation location, const Range& range, const char* text)
         :
-        std::runtime_error(msg),
-        m_range(range)
-    { }
+        std::runtime_error(text),
+        m_location(location),
+        m_range(),
+        m_text(text),
+        m_message(text)
+    {
+        if (range.startLine > 0)
+        {
+            resolve(range);
+        }
+    }
 
     Error::~Error()
     { }
 
+    void Error::resolve(const Range& range)
+    {
+        m_range = range;
+        m_message = "[" + std::to_string(range.startLine) + ":" + std::to_string(range.startCol) + "] " + m_text;
+    }
+
 }
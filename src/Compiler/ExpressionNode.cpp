@@ -30,10 +30,12 @@
 
 #include "ZeeBasic/Compiler/BinaryExpressionNode.hpp"
 #include "ZeeBasic/Compiler/BooleanLiteralNode.hpp"
+#include "ZeeBasic/Compiler/Builtins.hpp"
 #include "ZeeBasic/Compiler/Error.hpp"
 #include "ZeeBasic/Compiler/FunctionCallExpressionNode.hpp"
 #include "ZeeBasic/Compiler/IdentifierExpressionNode.hpp"
 #include "ZeeBasic/Compiler/IntegerLiteralNode.hpp"
+#include "ZeeBasic/Compiler/NodeArena.hpp"
 #include "ZeeBasic/Compiler/RealLiteralNode.hpp"
 #include "ZeeBasic/Compiler/StringLiteralNode.hpp"
 #include "ZeeBasic/Compiler/UnaryExpressionNode.hpp"
@@ -108,50 +110,34 @@ namespace ZeeBasic::Compiler::Nodes
 		return (BinaryExpressionNode::Operator)0;
 	}
 
-	static bool isBuiltinFunction(TokenId id)
-	{
-		switch (id)
-		{
-
-		case TokenId::Key_STR_S:
-			return true;
-
-		default:
-			break;
-
-		}
-
-		return false;
-	}
-
-	std::unique_ptr<ExpressionNode> ExpressionNode::parseExpression(IParser& parser, int prec)
+	ExpressionNode* ExpressionNode::parseExpression(IParser& parser, int prec)
 	{
 		auto& token = parser.getToken();
 
-		auto lhs = std::unique_ptr<ExpressionNode>{};
+		ExpressionNode* lhs = nullptr;
 		switch (token.id)
 		{
 
 		case TokenId::Key_TRUE:
 		case TokenId::Key_FALSE:
-			lhs = std::make_unique<BooleanLiteralNode>();
+			lhs = parser.getNodeArena().create<BooleanLiteralNode>();
 			break;
 
 		case TokenId::Integer:
-			lhs = std::make_unique<IntegerLiteralNode>();
+			lhs = parser.getNodeArena().create<IntegerLiteralNode>();
 			break;
 
 		case TokenId::String:
-			lhs = std::make_unique<StringLiteralNode>();
+			lhs = parser.getNodeArena().create<StringLiteralNode>();
 			break;
 
 		case TokenId::Real:
-			lhs = std::make_unique<RealLiteralNode>();
+			lhs = parser.getNodeArena().create<RealLiteralNode>();
 			break;
 
 		case TokenId::Sym_Subtract:
 		case TokenId::Key_NOT:
-			lhs = std::make_unique<UnaryExpressionNode>();
+			lhs = parser.getNodeArena().create<UnaryExpressionNode>();
 			break;
 
 		case TokenId::Sym_OpenParen:
@@ -164,17 +150,17 @@ namespace ZeeBasic::Compiler::Nodes
 		case TokenId::TypedName:
 		case TokenId::UntypedName:
 			// TODO : user-defined function
-			lhs = std::make_unique<IdentifierExpressionNode>();
+			lhs = parser.getNodeArena().create<IdentifierExpressionNode>();
 			break;
 
 		default:
-			if (isBuiltinFunction(token.id))
+			if (getBuiltin(token.id))
 			{
-				lhs = std::make_unique<FunctionCallExpressionNode>();
+				lhs = parser.getNodeArena().create<FunctionCallExpressionNode>();
 			}
 			else
 			{
-				return {};
+				return nullptr;
 			}
 
 		}
@@ -194,10 +180,10 @@ namespace ZeeBasic::Compiler::Nodes
 			auto rhs = parseExpression(parser, newPrec);
 			if (!rhs)
 			{
-				throw Error::create(parser.getToken().range, "Expected expression for right-hand side of operator");
+				throw Error::create(parser.getToken().location, "Expected expression for right-hand side of operator");
 			}
 
-			lhs = std::make_unique<BinaryExpressionNode>(mapBinaryOperator(id), std::move(lhs), std::move(rhs));
+			lhs = parser.getNodeArena().create<BinaryExpressionNode>(mapBinaryOperator(id), lhs, rhs);
 			lhs->parse(parser);
 		}
 
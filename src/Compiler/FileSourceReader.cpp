@@ -37,8 +37,7 @@ namespace ZeeBasic::Compiler
         m_size(0),
         m_data(),
         m_offset(0),
-        m_lineNo(1),
-        m_colNo(1)
+        m_lines()
     {
 #ifdef _WIN32
         FILE* file = nullptr;
@@ -65,6 +64,7 @@ namespace ZeeBasic::Compiler
 
         m_data = std::move(data);
         m_size = len;
+        m_lines = LineIndex{ m_data.get(), m_size };
     }
 
     FileSourceReader::~FileSourceReader()
@@ -77,19 +77,7 @@ namespace ZeeBasic::Compiler
             return 0;
         }
 
-        auto ch = m_data[m_offset++];
-
-        if (ch == '\n')
-        {
-            ++m_lineNo;
-            m_colNo = 1;
-        }
-        else
-        {
-            ++m_colNo;
-        }
-
-        return ch;
+        return m_data[m_offset++];
     }
 
 }
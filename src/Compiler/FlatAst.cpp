@@ -0,0 +1,278 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include "ZeeBasic/Compiler/FlatAst.hpp"
+
+#include "ZeeBasic/Compiler/AssignmentStatementNode.hpp"
+#include "ZeeBasic/Compiler/BooleanLiteralNode.hpp"
+#include "ZeeBasic/Compiler/CastExpressionNode.hpp"
+#include "ZeeBasic/Compiler/FunctionCallExpressionNode.hpp"
+#include "ZeeBasic/Compiler/IdentifierExpressionNode.hpp"
+#include "ZeeBasic/Compiler/IntegerLiteralNode.hpp"
+#include "ZeeBasic/Compiler/ITranslator.hpp"
+#include "ZeeBasic/Compiler/PrintStatementNode.hpp"
+#include "ZeeBasic/Compiler/RealLiteralNode.hpp"
+#include "ZeeBasic/Compiler/StringLiteralNode.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	static_assert(kTokenIdCount <= 256, "builtin tokens are kept in the one-byte operator slot");
+
+	FlatAst::FlatAst()
+	{ }
+
+	FlatAst::~FlatAst()
+	{ }
+
+	uint32_t FlatAst::add(Kind kind, uint8_t op, uint32_t first, uint32_t second, Type type, SourceLocation location)
+	{
+		m_kinds.push_back(kind);
+		m_operators.push_back(op);
+		m_first.push_back(first);
+		m_second.push_back(second);
+		m_types.push_back(type);
+		m_locations.push_back(location);
+		return uint32_t(m_kinds.size() - 1);
+	}
+
+	void FlatAst::truncate(uint32_t count)
+	{
+		// pool entries were added in node order, so the removed nodes own the ends of the pools
+		for (auto index = uint32_t(getCount()); index-- > count;)
+		{
+			switch (m_kinds[index])
+			{
+
+			case Kind::IntegerLiteral:
+				m_integers.pop_back();
+				break;
+
+			case Kind::RealLiteral:
+			case Kind::StringLiteral:
+				m_texts.pop_back();
+				break;
+
+			case Kind::Identifier:
+				m_symbols.pop_back();
+				break;
+
+			case Kind::FunctionCall:
+				m_arguments.resize(m_second[index]);
+				break;
+
+			case Kind::Assignment:
+				m_symbols.pop_back();
+				m_statements.pop_back();
+				break;
+
+			case Kind::Print:
+				m_statements.pop_back();
+				break;
+
+			default:
+				break;
+
+			}
+		}
+
+		m_kinds.resize(count);
+		m_operators.resize(count);
+		m_first.resize(count);
+		m_second.resize(count);
+		m_types.resize(count);
+		m_locations.resize(count);
+	}
+
+	uint32_t FlatAst::addBooleanLiteral(bool value, SourceLocation location)
+	{
+		return add(Kind::BooleanLiteral, 0, value ? 1 : 0, kNone, Type{ BaseType_Boolean }, location);
+	}
+
+	uint32_t FlatAst::addIntegerLiteral(int64_t value, SourceLocation location)
+	{
+		m_integers.push_back(value);
+		return add(Kind::IntegerLiteral, 0, uint32_t(m_integers.size() - 1), kNone, Type{ BaseType_Integer }, location);
+	}
+
+	uint32_t FlatAst::addRealLiteral(const ConstString& text, SourceLocation location)
+	{
+		m_texts.push_back(text);
+		return add(Kind::RealLiteral, 0, uint32_t(m_texts.size() - 1), kNone, Type{ BaseType_Real }, location);
+	}
+
+	uint32_t FlatAst::addStringLiteral(const ConstString& text, SourceLocation location)
+	{
+		m_texts.push_back(text);
+		return add(Kind::StringLiteral, 0, uint32_t(m_texts.size() - 1), kNone, Type{ BaseType_String }, location);
+	}
+
+	uint32_t FlatAst::addIdentifier(const Symbol& symbol, SourceLocation location)
+	{
+		m_symbols.push_back(&symbol);
+		return add(Kind::Identifier, 0, uint32_t(m_symbols.size() - 1), kNone, symbol.type, location);
+	}
+
+	uint32_t FlatAst::addUnary(Nodes::UnaryExpressionNode::Operator op, Type type, uint32_t operand, SourceLocation location)
+	{
+		return add(Kind::Unary, uint8_t(op), operand, kNone, type, location);
+	}
+
+	uint32_t FlatAst::addBinary(Nodes::BinaryExpressionNode::Operator op, Type type, uint32_t lhs, uint32_t rhs, SourceLocation location)
+	{
+		return add(Kind::Binary, uint8_t(op), lhs, rhs, type, location);
+	}
+
+	uint32_t FlatAst::addCast(Type type, uint32_t operand, SourceLocation location)
+	{
+		return add(Kind::Cast, 0, operand, kNone, type, location);
+	}
+
+	uint32_t FlatAst::addFunctionCall(const Builtin& builtin, Type type, const std::vector<uint32_t>& arguments, SourceLocation location)
+	{
+		auto start = uint32_t(m_arguments.size());
+		m_arguments.push_back(uint32_t(arguments.size()));
+		m_arguments.insert(m_arguments.end(), arguments.begin(), arguments.end());
+		return add(Kind::FunctionCall, uint8_t(builtin.id), kNone, start, type, location);
+	}
+
+	uint32_t FlatAst::addAssignment(const Symbol& symbol, uint32_t value, SourceLocation location)
+	{
+		m_symbols.push_back(&symbol);
+		auto index = add(Kind::Assignment, 0, uint32_t(m_symbols.size() - 1), value, symbol.type, location);
+		m_statements.push_back(index);
+		return index;
+	}
+
+	uint32_t FlatAst::addPrint(uint32_t value, SourceLocation location)
+	{
+		auto index = add(Kind::Print, 0, value, kNone, Type{}, location);
+		m_statements.push_back(index);
+		return index;
+	}
+
+	// Walks the parsed nodes once, adding each node after its children.
+	class Flattener
+		:
+		public ITranslator
+	{
+	public:
+		Flattener(const std::vector<Nodes::Node*>& statements, FlatAst& ast) : m_statements(statements), m_ast(ast) { }
+
+		void run() override
+		{
+			for (auto statement : m_statements)
+			{
+				statement->translate(*this);
+			}
+		}
+
+		void translate(const Nodes::AssignmentStatementNode& node) override
+		{
+			m_ast.addAssignment(*node.getSymbol(), flatten(*node.getExpression()), node.getLocation());
+		}
+
+		void translate(const Nodes::BinaryExpressionNode& node) override
+		{
+			auto lhs = flatten(node.getLeft());
+			auto rhs = flatten(node.getRight());
+			m_last = m_ast.addBinary(node.getOperator(), node.getType(), lhs, rhs, node.getLocation());
+		}
+
+		void translate(const Nodes::BooleanLiteralNode& node) override
+		{
+			m_last = m_ast.addBooleanLiteral(node.getValue(), node.getLocation());
+		}
+
+		void translate(const Nodes::CastExpressionNode& node) override
+		{
+			m_last = m_ast.addCast(node.getType(), flatten(node.getExpression()), node.getLocation());
+		}
+
+		void translate(const Nodes::FunctionCallExpressionNode& node) override
+		{
+			auto arguments = std::vector<uint32_t>{};
+			for (auto argument : node.getArguments())
+			{
+				arguments.push_back(flatten(*argument));
+			}
+			m_last = m_ast.addFunctionCall(node.getBuiltin(), node.getType(), arguments, node.getLocation());
+		}
+
+		void translate(const Nodes::IdentifierExpressionNode& node) override
+		{
+			m_last = m_ast.addIdentifier(node.getSymbol(), node.getLocation());
+		}
+
+		void translate(const Nodes::IntegerLiteralNode& node) override
+		{
+			m_last = m_ast.addIntegerLiteral(node.getValue(), node.getLocation());
+		}
+
+		void translate(const Nodes::PrintStatementNode& node) override
+		{
+			auto expr = node.getExpression();
+			m_ast.addPrint(expr ? flatten(*expr) : FlatAst::kNone, node.getLocation());
+		}
+
+		void translate(const Nodes::RealLiteralNode& node) override
+		{
+			m_last = m_ast.addRealLiteral(node.getValue(), node.getLocation());
+		}
+
+		void translate(const Nodes::StringLiteralNode& node) override
+		{
+			m_last = m_ast.addStringLiteral(node.getValue(), node.getLocation());
+		}
+
+		void translate(const Nodes::UnaryExpressionNode& node) override
+		{
+			auto operand = flatten(node.getExpression());
+			m_last = m_ast.addUnary(node.getOperator(), node.getType(), operand, node.getLocation());
+		}
+
+	private:
+		const std::vector<Nodes::Node*>& m_statements;
+		FlatAst& m_ast;
+
+		// index of the last expression added
+		uint32_t m_last = FlatAst::kNone;
+
+		uint32_t flatten(const Nodes::ExpressionNode& node)
+		{
+			node.translate(*this);
+			return m_last;
+		}
+	};
+
+	FlatAst FlatAst::build(const std::vector<Nodes::Node*>& statements)
+	{
+		auto ast = FlatAst{};
+		Flattener{ statements, ast }.run();
+		return ast;
+	}
+
+}
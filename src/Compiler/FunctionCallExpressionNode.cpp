@@ -29,17 +29,41 @@
 
 #include "ZeeBasic/Compiler/FunctionCallExpressionNode.hpp"
 
+#include "ZeeBasic/Compiler/CastExpressionNode.hpp"
 #include "ZeeBasic/Compiler/Error.hpp"
+#include "ZeeBasic/Compiler/NodeArena.hpp"
 
 namespace ZeeBasic::Compiler::Nodes
 {
 
+	static int getResultType(Builtin::Operand result)
+	{
+		switch (result)
+		{
+
+		case Builtin::Operand::Integer:
+			return BaseType_Integer;
+
+		case Builtin::Operand::Real:
+			return BaseType_Real;
+
+		case Builtin::Operand::String:
+			return BaseType_String;
+
+		default:
+			// a Number result takes the type of its argument
+			return BaseType_Unknown;
+
+		}
+	}
+
 	void FunctionCallExpressionNode::parse(IParser& parser)
 	{
 		auto& token = parser.getToken();
 		m_name = token.text;
-		// TODO
-		m_range = token.range;
+		m_builtin = Compiler::getBuiltin(token.id);
+		assert(m_builtin);
+		m_location = token.location;
 		parser.eatToken();
 
 		if (parser.getToken().id == TokenId::Sym_OpenParen)
@@ -51,10 +75,10 @@ namespace ZeeBasic::Compiler::Nodes
 				auto expr = parseExpression(parser);
 				if (!expr)
 				{
-					throw Error::create(parser.getToken().range, "Expected argument for function call");
+					throw Error::create(parser.getToken().location, "Expected argument for function call");
 				}
 
-				m_arguments.emplace_back(std::move(expr));
+				m_arguments.emplace_back(expr);
 
 				if (parser.getToken().id != TokenId::Sym_Comma)
 				{
@@ -68,24 +92,58 @@ namespace ZeeBasic::Compiler::Nodes
 			parser.eatToken();
 		}
 
-		// TODO : better lookup for built-in function types
-		if (m_name == "STR$")
+		auto argumentCount = int(m_arguments.size());
+		if (argumentCount < m_builtin->requiredArgumentCount || argumentCount > m_builtin->getArgumentCount())
 		{
-			m_type = Type{ BaseType_String };
-			if (m_arguments.size() != 1)
-			{
-				throw Error::create(m_range, "Bad arguments for built-in function");
-			}
+			throw Error::create(m_location, "Bad arguments for built-in function");
+		}
 
-			if (m_arguments[0]->getType().base != BaseType_Integer)
+		m_type = Type{ getResultType(m_builtin->result) };
+		for (auto i = 0; i < argumentCount; ++i)
+		{
+			auto base = m_arguments[i]->getType().base;
+			switch (m_builtin->arguments[i])
 			{
-				throw Error::create(m_range, "Expected integer argument for built-in function");
+
+			case Builtin::Operand::Integer:
+				if (base != BaseType_Integer)
+				{
+					throw Error::create(m_arguments[i]->getLocation(), "Expected integer argument for built-in function");
+				}
+				break;
+
+			case Builtin::Operand::Real:
+				if (base == BaseType_Integer)
+				{
+					m_arguments[i] = parser.getNodeArena().create<CastExpressionNode>(BaseType_Real, m_arguments[i]);
+				}
+				else if (base != BaseType_Real)
+				{
+					throw Error::create(m_arguments[i]->getLocation(), "Expected numeric argument for built-in function");
+				}
+				break;
+
+			case Builtin::Operand::Number:
+				if (base != BaseType_Integer && base != BaseType_Real)
+				{
+					throw Error::create(m_arguments[i]->getLocation(), "Expected numeric argument for built-in function");
+				}
+
+				if (m_builtin->result == Builtin::Operand::Number)
+				{
+					m_type = Type{ base };
+				}
+				break;
+
+			default:
+				if (base != BaseType_String)
+				{
+					throw Error::create(m_arguments[i]->getLocation(), "Expected string argument for built-in function");
+				}
+				break;
+
 			}
 		}
-		else
-		{
-			assert(false);
-		}
 	}
 
 	void FunctionCallExpressionNode::translate(ITranslator& translator) const
@@ -49,8 +49,8 @@ namespace ZeeBasic::Compiler::Nodes
 			type.base = BaseType_Integer;
 		}
 
-		m_symbol = parser.getSymbolTable().findOrCreateSymbol(name, token.range, type);
-		m_range = token.range;
+		m_symbol = parser.getSymbolTable().findOrCreateSymbol(name, token.location, type);
+		m_location = token.location;
 		parser.eatToken();
 
 		m_type = m_symbol->type;
@@ -0,0 +1,118 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include "ZeeBasic/Compiler/IdentifierTable.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	static constexpr size_t kInitialSlotCount = 64;
+
+	// FNV-1a over the upper case form of the name
+	static uint32_t hashName(const ConstString& name)
+	{
+		auto hash = uint32_t(2166136261);
+		auto text = name.getText();
+		for (auto i = 0; i < name.getLength(); ++i)
+		{
+			auto ch = uint8_t(text[i]);
+			if (ch >= 'a' && ch <= 'z')
+			{
+				ch = uint8_t(ch - 'a' + 'A');
+			}
+			hash = (hash ^ ch) * 16777619;
+		}
+		return hash;
+	}
+
+	IdentifierTable::IdentifierTable()
+		:
+		m_names(),
+		m_hashes(),
+		m_slots(kInitialSlotCount, 0)
+	{ }
+
+	IdentifierTable::~IdentifierTable()
+	{ }
+
+	size_t IdentifierTable::findSlot(const ConstString& name, uint32_t hash) const
+	{
+		auto mask = m_slots.size() - 1;
+		for (auto slot = size_t(hash) & mask; ; slot = (slot + 1) & mask)
+		{
+			auto entry = m_slots[slot];
+			if (entry == 0 || (m_hashes[entry - 1] == hash && m_names[entry - 1] == name))
+			{
+				return slot;
+			}
+		}
+	}
+
+	int IdentifierTable::intern(const ConstString& name)
+	{
+		auto hash = hashName(name);
+		auto slot = findSlot(name, hash);
+		if (m_slots[slot] != 0)
+		{
+			return m_slots[slot] - 1;
+		}
+
+		// keep at least half of the slots empty so that probe sequences stay short
+		if ((m_names.size() + 1) * 2 > m_slots.size())
+		{
+			grow();
+			slot = findSlot(name, hash);
+		}
+
+		auto id = int(m_names.size());
+		m_names.emplace_back(name.getText(), name.getLength());
+		m_hashes.push_back(hash);
+		m_slots[slot] = id + 1;
+		return id;
+	}
+
+	int IdentifierTable::find(const ConstString& name) const
+	{
+		return m_slots[findSlot(name, hashName(name))] - 1;
+	}
+
+	void IdentifierTable::grow()
+	{
+		m_slots.assign(m_slots.size() * 2, 0);
+
+		auto mask = m_slots.size() - 1;
+		for (auto id = 0; id < int(m_names.size()); ++id)
+		{
+			auto slot = size_t(m_hashes[id]) & mask;
+			while (m_slots[slot] != 0)
+			{
+				slot = (slot + 1) & mask;
+			}
+			m_slots[slot] = id + 1;
+		}
+	}
+
+}
@@ -44,7 +44,7 @@ namespace ZeeBasic::Compiler::Nodes
 	void IntegerLiteralNode::parse(IParser& parser)
 	{
 		auto& token = parser.expectToken(TokenId::Integer);
-		m_range = token.range;
+		m_location = token.location;
 		m_value = strtoll(token.text.getText(), nullptr, 10);
 		parser.eatToken();
 
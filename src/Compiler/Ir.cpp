@@ -0,0 +1,465 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <algorithm>
+#include <algorithm>
+#include <cassert>
+
+#include "ZeeBasic/Compiler/Ir.hpp"
+
+namespace ZeeBasic::Compiler::Ir
+{
+
+	Function::Function()
+	{ }
+
+	Function::~Function()
+	{ }
+
+	uint32_t Function::createBlock()
+	{
+		m_blocks.emplace_back();
+		return uint32_t(m_blocks.size() - 1);
+	}
+
+	void Function::addEdge(uint32_t from, uint32_t to)
+	{
+		m_blocks[from].successors.push_back(to);
+		m_blocks[to].predecessors.push_back(from);
+	}
+
+	void Function::removeEdge(uint32_t from, uint32_t to)
+	{
+		auto& successors = m_blocks[from].successors;
+		successors.erase(std::find(successors.begin(), successors.end(), to));
+
+		auto& predecessors = m_blocks[to].predecessors;
+		auto position = std::find(predecessors.begin(), predecessors.end(), from);
+		auto edge = uint32_t(position - predecessors.begin());
+		predecessors.erase(position);
+
+		for (auto index : m_blocks[to].instructions)
+		{
+			auto& instruction = m_instructions[index];
+			if (instruction.opcode == Opcode::Phi && edge < instruction.operandCount)
+			{
+				auto operands = m_operands.begin() + instruction.operands;
+				std::copy(operands + edge + 1, operands + instruction.operandCount, operands + edge);
+				instruction.operandCount--;
+			}
+		}
+	}
+
+	uint32_t Function::append(uint32_t block, Opcode opcode, uint8_t op, Type type, const uint32_t* operands, uint32_t operandCount, uint32_t payload)
+	{
+		auto index = uint32_t(m_instructions.size());
+		m_instructions.push_back({ opcode, op, type, block, uint32_t(m_operands.size()), operandCount, payload });
+		m_operands.insert(m_operands.end(), operands, operands + operandCount);
+
+		auto& instructions = m_blocks[block].instructions;
+		if (!instructions.empty() && isTerminator(instructions.back()))
+		{
+			instructions.insert(instructions.end() - 1, index);
+		}
+		else
+		{
+			instructions.push_back(index);
+		}
+		return index;
+	}
+
+	uint32_t Function::insertPhi(uint32_t block, Type type)
+	{
+		auto index = uint32_t(m_instructions.size());
+		m_instructions.push_back({ Opcode::Phi, 0, type, block, uint32_t(m_operands.size()), 0, kNone });
+
+		auto& instructions = m_blocks[block].instructions;
+		instructions.insert(instructions.begin(), index);
+		return index;
+	}
+
+	void Function::setPhiOperands(uint32_t phi, const std::vector<uint32_t>& operands)
+	{
+		auto& instruction = m_instructions[phi];
+		assert(instruction.opcode == Opcode::Phi);
+
+		instruction.operands = uint32_t(m_operands.size());
+		instruction.operandCount = uint32_t(operands.size());
+		m_operands.insert(m_operands.end(), operands.begin(), operands.end());
+	}
+
+	uint32_t Function::addInteger(int64_t value)
+	{
+		m_integers.push_back(value);
+		return uint32_t(m_integers.size() - 1);
+	}
+
+	uint32_t Function::addText(const ConstString& text)
+	{
+		m_texts.push_back(text);
+		return uint32_t(m_texts.size() - 1);
+	}
+
+	void Function::replaceAllUses(uint32_t from, uint32_t to)
+	{
+		for (const auto& instruction : m_instructions)
+		{
+			if (instruction.opcode == Opcode::Removed)
+			{
+				continue;
+			}
+
+			auto operands = m_operands.begin() + instruction.operands;
+			std::replace(operands, operands + instruction.operandCount, from, to);
+		}
+	}
+
+	void Function::remove(uint32_t instruction)
+	{
+		auto& instructions = m_blocks[m_instructions[instruction].block].instructions;
+		instructions.erase(std::find(instructions.begin(), instructions.end(), instruction));
+		m_instructions[instruction].opcode = Opcode::Removed;
+		m_instructions[instruction].operandCount = 0;
+	}
+
+	void Function::remove(const std::vector<bool>& removed)
+	{
+		for (auto& block : m_blocks)
+		{
+			auto end = std::remove_if(block.instructions.begin(), block.instructions.end(), [&](uint32_t index) { return removed[index]; });
+			block.instructions.erase(end, block.instructions.end());
+		}
+
+		for (uint32_t index = 0; index < m_instructions.size(); ++index)
+		{
+			if (removed[index])
+			{
+				m_instructions[index].opcode = Opcode::Removed;
+				m_instructions[index].operandCount = 0;
+			}
+		}
+	}
+
+	void Function::replaceWithConstant(uint32_t instruction, const Constant& value)
+	{
+		auto& target = m_instructions[instruction];
+		assert(target.type.base == value.base);
+
+		target.operandCount = 0;
+		switch (value.base)
+		{
+
+		case BaseType_Boolean:
+		case BaseType_Integer:
+			target.opcode = Opcode::Constant;
+			target.payload = addInteger(value.integer);
+			break;
+
+		case BaseType_Real:
+			target.opcode = Opcode::Constant;
+			target.payload = addText(value.text);
+			break;
+
+		default:
+			target.opcode = Opcode::StringLiteral;
+			target.payload = addText(value.text);
+			break;
+
+		}
+	}
+
+	void Function::replaceWithJump(uint32_t branch, uint32_t target)
+	{
+		auto& instruction = m_instructions[branch];
+		assert(instruction.opcode == Opcode::Branch);
+
+		const auto& successors = m_blocks[instruction.block].successors;
+		removeEdge(instruction.block, successors[0] == target ? successors[1] : successors[0]);
+
+		instruction.opcode = Opcode::Jump;
+		instruction.operandCount = 0;
+	}
+
+	bool Function::isTerminator(uint32_t instruction) const
+	{
+		auto opcode = m_instructions[instruction].opcode;
+		return opcode == Opcode::Jump || opcode == Opcode::Branch || opcode == Opcode::Return;
+	}
+
+	std::vector<uint32_t> Function::getReversePostorder() const
+	{
+		auto order = std::vector<uint32_t>{};
+		auto visited = std::vector<bool>(m_blocks.size(), false);
+		auto stack = std::vector<std::pair<uint32_t, size_t>>{ { 0, 0 } };
+		visited[0] = true;
+		while (!stack.empty())
+		{
+			auto& top = stack.back();
+			const auto& successors = m_blocks[top.first].successors;
+			if (top.second < successors.size())
+			{
+				auto next = successors[top.second++];
+				if (!visited[next])
+				{
+					visited[next] = true;
+					stack.emplace_back(next, 0);
+				}
+			}
+			else
+			{
+				order.push_back(top.first);
+				stack.pop_back();
+			}
+		}
+
+		std::reverse(order.begin(), order.end());
+		return order;
+	}
+
+	std::vector<uint32_t> Function::getImmediateDominators() const
+	{
+		// "A Simple, Fast Dominance Algorithm" (Cooper, Harvey and Kennedy): refine the dominators in reverse postorder
+		// until nothing changes, walking up from two predecessors to where their dominators meet
+		auto order = getReversePostorder();
+		auto rank = std::vector<uint32_t>(m_blocks.size(), kNone);
+		for (uint32_t i = 0; i < order.size(); ++i)
+		{
+			rank[order[i]] = i;
+		}
+
+		auto dominators = std::vector<uint32_t>(m_blocks.size(), kNone);
+		dominators[0] = 0;
+
+		auto changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (auto block : order)
+			{
+				if (block == 0)
+				{
+					continue;
+				}
+
+				auto dominator = kNone;
+				for (auto predecessor : m_blocks[block].predecessors)
+				{
+					if (dominators[predecessor] == kNone)
+					{
+						continue;
+					}
+
+					if (dominator == kNone)
+					{
+						dominator = predecessor;
+						continue;
+					}
+
+					auto other = predecessor;
+					while (dominator != other)
+					{
+						while (rank[dominator] > rank[other])
+						{
+							dominator = dominators[dominator];
+						}
+						while (rank[other] > rank[dominator])
+						{
+							other = dominators[other];
+						}
+					}
+				}
+
+				if (dominators[block] != dominator)
+				{
+					dominators[block] = dominator;
+					changed = true;
+				}
+			}
+		}
+
+		return dominators;
+	}
+
+	static const char* getTypeName(const Type& type)
+	{
+		switch (type.base)
+		{
+		case BaseType_Boolean: return "bool";
+		case BaseType_Integer: return "int";
+		case BaseType_Real: return "real";
+		case BaseType_String: return "string";
+		default: return "?";
+		}
+	}
+
+	static const char* getOperatorName(Nodes::UnaryExpressionNode::Operator op)
+	{
+		return op == Nodes::UnaryExpressionNode::Operator::Negate ? "neg" : "not";
+	}
+
+	static const char* getOperatorName(Nodes::BinaryExpressionNode::Operator op)
+	{
+		using Operator = Nodes::BinaryExpressionNode::Operator;
+		switch (op)
+		{
+		case Operator::Add: return "add";
+		case Operator::Subtract: return "sub";
+		case Operator::Multiply: return "mul";
+		case Operator::Divide: return "div";
+		case Operator::IntDivide: return "idiv";
+		case Operator::Modulus: return "mod";
+		case Operator::Equals: return "eq";
+		case Operator::NotEquals: return "ne";
+		case Operator::Less: return "lt";
+		case Operator::LessEquals: return "le";
+		case Operator::Greater: return "gt";
+		case Operator::GreaterEquals: return "ge";
+		case Operator::BitwiseOr: return "or";
+		case Operator::BitwiseAnd: return "and";
+		case Operator::BitwiseXor: return "xor";
+		default: return "?";
+		}
+	}
+
+	std::string Function::dump() const
+	{
+		auto text = std::string{};
+		auto value = [&](uint32_t index) { text += "%" + std::to_string(index); };
+		auto block = [&](uint32_t index) { text += "block" + std::to_string(index); };
+
+		for (uint32_t b = 0; b < m_blocks.size(); ++b)
+		{
+			block(b);
+			text += ":\n";
+
+			for (auto index : m_blocks[b].instructions)
+			{
+				const auto& instruction = m_instructions[index];
+
+				text += "  ";
+				if (instruction.type.base != BaseType_Unknown)
+				{
+					value(index);
+					text += " = ";
+				}
+
+				switch (instruction.opcode)
+				{
+
+				case Opcode::Constant:
+					text += std::string{ "const " } + getTypeName(instruction.type) + " ";
+					if (instruction.type.base == BaseType_Real)
+					{
+						text.append(getText(index).getText(), size_t(getText(index).getLength()));
+					}
+					else if (instruction.type.base == BaseType_Boolean)
+					{
+						text += getInteger(index) ? "true" : "false";
+					}
+					else
+					{
+						text += std::to_string(getInteger(index));
+					}
+					break;
+
+				case Opcode::StringLiteral:
+					text += "str.literal \"";
+					text.append(getText(index).getText(), size_t(getText(index).getLength()));
+					text += "\"";
+					break;
+
+				case Opcode::StringEmpty: text += "str.empty"; break;
+				case Opcode::StringCopy: text += "str.copy "; break;
+				case Opcode::StringRelease: text += "str.release "; break;
+
+				case Opcode::Unary:
+					text += std::string{ getOperatorName(getUnaryOperator(index)) } + " " + getTypeName(instruction.type) + " ";
+					break;
+
+				case Opcode::Binary:
+					text += std::string{ getOperatorName(getBinaryOperator(index)) } + " " + getTypeName(instruction.type) + " ";
+					break;
+
+				case Opcode::Cast:
+					text += std::string{ "cast " } + getTypeName(instruction.type) + " ";
+					break;
+
+				case Opcode::Call:
+					text += std::string{ "call " } + getTypeName(instruction.type) + " " + getFunction(index).name + " ";
+					break;
+
+				case Opcode::Phi:
+					text += std::string{ "phi " } + getTypeName(instruction.type) + " ";
+					break;
+
+				case Opcode::Print: text += "print "; break;
+				case Opcode::Jump: text += "jump "; break;
+				case Opcode::Branch: text += "branch "; break;
+				case Opcode::Return: text += "ret"; break;
+				case Opcode::Removed: break;
+
+				}
+
+				for (uint32_t i = 0; i < instruction.operandCount; ++i)
+				{
+					text += i ? ", " : "";
+					if (instruction.opcode == Opcode::Phi)
+					{
+						text += "[";
+						value(getOperand(index, i));
+						text += ", ";
+						block(m_blocks[b].predecessors[i]);
+						text += "]";
+					}
+					else
+					{
+						value(getOperand(index, i));
+					}
+				}
+
+				// targets follow the operands
+				if (instruction.opcode == Opcode::Jump || instruction.opcode == Opcode::Branch)
+				{
+					for (auto successor : m_blocks[b].successors)
+					{
+						text += instruction.opcode == Opcode::Branch || successor != m_blocks[b].successors.front() ? ", " : "";
+						block(successor);
+					}
+				}
+
+				// trailing spaces are left by operations without operands
+				while (text.back() == ' ')
+				{
+					text.pop_back();
+				}
+				text += "\n";
+			}
+		}
+
+		return text;
+	}
+
+}
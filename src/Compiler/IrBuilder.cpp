@@ -0,0 +1,350 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <cassert>
+
+#include "ZeeBasic/Compiler/IrBuilder.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	using Ir::Opcode;
+
+	static uint64_t getKey(uint32_t block, uint32_t variable)
+	{
+		return (uint64_t(block) << 32) | variable;
+	}
+
+	IrBuilder::IrBuilder(Ir::Function& function)
+		:
+		m_function(function)
+	{ }
+
+	IrBuilder::~IrBuilder()
+	{ }
+
+	void IrBuilder::sealBlock(uint32_t block)
+	{
+		// completing a phi can read through other unsealed blocks and add to the list, so take this block's phis out
+		// before completing any of them
+		auto pending = std::vector<IncompletePhi>{};
+		for (auto it = m_incompletePhis.begin(); it != m_incompletePhis.end();)
+		{
+			if (it->block == block)
+			{
+				pending.push_back(*it);
+				it = m_incompletePhis.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if (block >= m_sealed.size())
+		{
+			m_sealed.resize(size_t(block) + 1, false);
+		}
+		m_sealed[block] = true;
+
+		for (const auto& incomplete : pending)
+		{
+			addPhiOperands(incomplete.variable, incomplete.phi);
+		}
+	}
+
+	void IrBuilder::writeVariable(uint32_t variable, uint32_t value)
+	{
+		if (variable >= m_variableTypes.size())
+		{
+			m_variableTypes.resize(size_t(variable) + 1);
+		}
+		m_variableTypes[variable] = m_function.getInstruction(value).type;
+
+		writeVariable(variable, m_block, value);
+	}
+
+	uint32_t IrBuilder::readVariable(uint32_t variable, const Type& type)
+	{
+		if (variable >= m_variableTypes.size())
+		{
+			m_variableTypes.resize(size_t(variable) + 1);
+		}
+		m_variableTypes[variable] = type;
+
+		return readVariable(variable, m_block);
+	}
+
+	void IrBuilder::writeVariable(uint32_t variable, uint32_t block, uint32_t value)
+	{
+		m_definitions[getKey(block, variable)] = value;
+	}
+
+	uint32_t IrBuilder::readVariable(uint32_t variable, uint32_t block)
+	{
+		auto found = m_definitions.find(getKey(block, variable));
+		if (found != m_definitions.end())
+		{
+			return found->second;
+		}
+
+		return readVariableRecursive(variable, block);
+	}
+
+	uint32_t IrBuilder::readVariableRecursive(uint32_t variable, uint32_t block)
+	{
+		const auto& predecessors = m_function.getBlock(block).predecessors;
+
+		auto value = Ir::Function::kNone;
+		if (!isSealed(block))
+		{
+			// more predecessors may come, so leave a phi to complete when the block is sealed
+			value = m_function.insertPhi(block, m_variableTypes[variable]);
+			m_incompletePhis.push_back({ block, variable, value });
+		}
+		else if (predecessors.empty())
+		{
+			// read before any write
+			value = createDefault(variable, block);
+		}
+		else if (predecessors.size() == 1)
+		{
+			value = readVariable(variable, predecessors.front());
+		}
+		else
+		{
+			// the phi is written first, to break cycles through loops
+			auto phi = m_function.insertPhi(block, m_variableTypes[variable]);
+			writeVariable(variable, block, phi);
+			value = addPhiOperands(variable, phi);
+		}
+
+		writeVariable(variable, block, value);
+		return value;
+	}
+
+	uint32_t IrBuilder::addPhiOperands(uint32_t variable, uint32_t phi)
+	{
+		auto block = m_function.getInstruction(phi).block;
+
+		auto operands = std::vector<uint32_t>{};
+		for (auto predecessor : m_function.getBlock(block).predecessors)
+		{
+			operands.push_back(readVariable(variable, predecessor));
+		}
+		m_function.setPhiOperands(phi, operands);
+
+		return tryRemoveTrivialPhi(phi);
+	}
+
+	uint32_t IrBuilder::tryRemoveTrivialPhi(uint32_t phi)
+	{
+		auto same = Ir::Function::kNone;
+		const auto& instruction = m_function.getInstruction(phi);
+		for (uint32_t i = 0; i < instruction.operandCount; ++i)
+		{
+			auto operand = m_function.getOperand(phi, i);
+			if (operand == same || operand == phi)
+			{
+				continue;
+			}
+
+			if (same != Ir::Function::kNone)
+			{
+				// merges at least two values
+				return phi;
+			}
+			same = operand;
+		}
+
+		if (same == Ir::Function::kNone)
+		{
+			// only reachable through itself
+			return phi;
+		}
+
+		// phis that use this one may become trivial in turn
+		auto users = std::vector<uint32_t>{};
+		for (uint32_t index = 0; index < m_function.getInstructionCount(); ++index)
+		{
+			const auto& user = m_function.getInstruction(index);
+			if (index != phi && user.opcode == Opcode::Phi)
+			{
+				for (uint32_t i = 0; i < user.operandCount; ++i)
+				{
+					if (m_function.getOperand(index, i) == phi)
+					{
+						users.push_back(index);
+						break;
+					}
+				}
+			}
+		}
+
+		m_function.replaceAllUses(phi, same);
+		m_function.remove(phi);
+		for (auto& definition : m_definitions)
+		{
+			if (definition.second == phi)
+			{
+				definition.second = same;
+			}
+		}
+
+		for (auto user : users)
+		{
+			if (m_function.getInstruction(user).opcode == Opcode::Phi)
+			{
+				tryRemoveTrivialPhi(user);
+			}
+		}
+
+		return same;
+	}
+
+	uint32_t IrBuilder::createDefault(uint32_t variable, uint32_t block)
+	{
+		const auto& type = m_variableTypes[variable];
+		auto saved = m_block;
+		m_block = block;
+
+		auto value = Ir::Function::kNone;
+		switch (type.base)
+		{
+
+		case BaseType_Boolean:
+			value = constant(false);
+			break;
+
+		case BaseType_Real:
+			value = constantReal(ConstString{ "0.0", 3 });
+			break;
+
+		case BaseType_String:
+			value = stringEmpty();
+			break;
+
+		default:
+			value = constant(int64_t(0));
+			break;
+
+		}
+
+		m_block = saved;
+		return value;
+	}
+
+	uint32_t IrBuilder::append(Opcode opcode, uint8_t op, const Type& type, std::initializer_list<uint32_t> operands, uint32_t payload)
+	{
+		return m_function.append(m_block, opcode, op, type, operands.begin(), uint32_t(operands.size()), payload);
+	}
+
+	uint32_t IrBuilder::constant(bool value)
+	{
+		return append(Opcode::Constant, 0, BaseType_Boolean, {}, m_function.addInteger(value ? 1 : 0));
+	}
+
+	uint32_t IrBuilder::constant(int64_t value)
+	{
+		return append(Opcode::Constant, 0, BaseType_Integer, {}, m_function.addInteger(value));
+	}
+
+	uint32_t IrBuilder::constantReal(const ConstString& text)
+	{
+		return append(Opcode::Constant, 0, BaseType_Real, {}, m_function.addText(text));
+	}
+
+	uint32_t IrBuilder::stringLiteral(const ConstString& text)
+	{
+		return append(Opcode::StringLiteral, 0, BaseType_String, {}, m_function.addText(text));
+	}
+
+	uint32_t IrBuilder::stringEmpty()
+	{
+		return append(Opcode::StringEmpty, 0, BaseType_String, {});
+	}
+
+	uint32_t IrBuilder::stringCopy(uint32_t value)
+	{
+		return append(Opcode::StringCopy, 0, BaseType_String, { value });
+	}
+
+	void IrBuilder::stringRelease(uint32_t value)
+	{
+		append(Opcode::StringRelease, 0, Type{}, { value });
+	}
+
+	uint32_t IrBuilder::unary(Nodes::UnaryExpressionNode::Operator op, const Type& type, uint32_t operand)
+	{
+		return append(Opcode::Unary, uint8_t(op), type, { operand });
+	}
+
+	uint32_t IrBuilder::binary(Nodes::BinaryExpressionNode::Operator op, const Type& type, uint32_t lhs, uint32_t rhs)
+	{
+		return append(Opcode::Binary, uint8_t(op), type, { lhs, rhs });
+	}
+
+	uint32_t IrBuilder::cast(const Type& type, uint32_t operand)
+	{
+		return append(Opcode::Cast, 0, type, { operand });
+	}
+
+	uint32_t IrBuilder::call(const Builtin& builtin, const Type& type, const std::vector<uint32_t>& arguments)
+	{
+		return m_function.append(m_block, Opcode::Call, uint8_t(builtin.id), type, arguments.data(), uint32_t(arguments.size()));
+	}
+
+	void IrBuilder::print(uint32_t value)
+	{
+		if (value == Ir::Function::kNone)
+		{
+			append(Opcode::Print, 0, Type{}, {});
+		}
+		else
+		{
+			append(Opcode::Print, 0, Type{}, { value });
+		}
+	}
+
+	void IrBuilder::jump(uint32_t target)
+	{
+		append(Opcode::Jump, 0, Type{}, {});
+		m_function.addEdge(m_block, target);
+	}
+
+	void IrBuilder::branch(uint32_t condition, uint32_t whenTrue, uint32_t whenFalse)
+	{
+		append(Opcode::Branch, 0, Type{}, { condition });
+		m_function.addEdge(m_block, whenTrue);
+		m_function.addEdge(m_block, whenFalse);
+	}
+
+	void IrBuilder::ret()
+	{
+		append(Opcode::Return, 0, Type{}, {});
+	}
+
+}
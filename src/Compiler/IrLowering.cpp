@@ -0,0 +1,201 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <cassert>
+
+#include "ZeeBasic/Compiler/IrLowering.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	IrLowering::IrLowering(const FlatAst& ast, const SymbolTable& symbols)
+		:
+		m_ast(ast),
+		m_symbols(symbols),
+		m_function(),
+		m_builder(m_function)
+	{ }
+
+	IrLowering::~IrLowering()
+	{ }
+
+	Ir::Function IrLowering::run()
+	{
+		m_values.assign(m_ast.getCount(), Ir::Function::kNone);
+		m_owned.assign(m_ast.getCount(), false);
+		m_holdsString.assign(m_symbols.getSymbols().size(), false);
+
+		// the program is one block until control flow arrives
+		auto entry = m_builder.createBlock();
+		m_builder.setBlock(entry);
+		m_builder.sealBlock(entry);
+
+		for (uint32_t index = 0; index < m_ast.getCount(); ++index)
+		{
+			lower(index);
+		}
+
+		// release the strings still held by variables
+		for (const auto& symbol : m_symbols.getSymbols())
+		{
+			if (m_holdsString[symbol->index])
+			{
+				m_builder.stringRelease(m_builder.readVariable(uint32_t(symbol->index), symbol->type));
+			}
+		}
+		m_builder.ret();
+
+		return std::move(m_function);
+	}
+
+	void IrLowering::lower(uint32_t index)
+	{
+		const auto& type = m_ast.getType(index);
+		auto value = Ir::Function::kNone;
+
+		switch (m_ast.getKind(index))
+		{
+
+		case FlatAst::Kind::BooleanLiteral:
+			value = m_builder.constant(m_ast.getBoolean(index));
+			break;
+
+		case FlatAst::Kind::IntegerLiteral:
+			value = m_builder.constant(m_ast.getInteger(index));
+			break;
+
+		case FlatAst::Kind::RealLiteral:
+			value = m_builder.constantReal(m_ast.getText(index));
+			break;
+
+		case FlatAst::Kind::StringLiteral:
+			value = m_builder.stringLiteral(m_ast.getText(index));
+			m_owned[index] = true;
+			break;
+
+		case FlatAst::Kind::Identifier:
+		{
+			// the variable keeps its string, so the reader only borrows it
+			const auto& symbol = m_ast.getSymbol(index);
+			value = m_builder.readVariable(uint32_t(symbol.index), symbol.type);
+			m_holdsString[symbol.index] = symbol.type.base == BaseType_String;
+			break;
+		}
+
+		case FlatAst::Kind::Unary:
+			value = m_builder.unary(m_ast.getUnaryOperator(index), type, m_values[m_ast.getFirst(index)]);
+			break;
+
+		case FlatAst::Kind::Binary:
+		{
+			auto lhs = m_ast.getFirst(index);
+			auto rhs = m_ast.getSecond(index);
+			value = m_builder.binary(m_ast.getBinaryOperator(index), type, m_values[lhs], m_values[rhs]);
+			m_owned[index] = type.base == BaseType_String;
+			release(lhs);
+			release(rhs);
+			break;
+		}
+
+		case FlatAst::Kind::Cast:
+			value = m_builder.cast(type, m_values[m_ast.getFirst(index)]);
+			break;
+
+		case FlatAst::Kind::FunctionCall:
+		{
+			auto arguments = std::vector<uint32_t>{};
+			for (uint32_t i = 0; i < m_ast.getArgumentCount(index); ++i)
+			{
+				arguments.push_back(m_values[m_ast.getArgument(index, i)]);
+			}
+
+			value = m_builder.call(m_ast.getFunction(index), type, arguments);
+			m_owned[index] = type.base == BaseType_String;
+			for (uint32_t i = 0; i < m_ast.getArgumentCount(index); ++i)
+			{
+				release(m_ast.getArgument(index, i));
+			}
+			break;
+		}
+
+		case FlatAst::Kind::Assignment:
+			lowerAssignment(index);
+			break;
+
+		case FlatAst::Kind::Print:
+		{
+			auto node = m_ast.getFirst(index);
+			m_builder.print(node == FlatAst::kNone ? Ir::Function::kNone : m_values[node]);
+			if (node != FlatAst::kNone)
+			{
+				release(node);
+			}
+			break;
+		}
+
+		}
+
+		m_values[index] = value;
+	}
+
+	void IrLowering::lowerAssignment(uint32_t index)
+	{
+		const auto& symbol = m_ast.getSymbol(index);
+		auto variable = uint32_t(symbol.index);
+		auto node = m_ast.getSecond(index);
+		auto value = m_values[node];
+
+		if (symbol.type.base != BaseType_String)
+		{
+			m_builder.writeVariable(variable, value);
+			return;
+		}
+
+		// the variable takes over a new string, and copies one that belongs to another variable
+		if (!m_owned[node])
+		{
+			value = m_builder.stringCopy(value);
+		}
+
+		auto previous = m_holdsString[variable] ? m_builder.readVariable(variable, symbol.type) : Ir::Function::kNone;
+		m_builder.writeVariable(variable, value);
+		m_holdsString[variable] = true;
+
+		if (previous != Ir::Function::kNone)
+		{
+			m_builder.stringRelease(previous);
+		}
+	}
+
+	void IrLowering::release(uint32_t node)
+	{
+		if (m_owned[node])
+		{
+			m_builder.stringRelease(m_values[node]);
+		}
+	}
+
+}
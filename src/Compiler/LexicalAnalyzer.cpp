@@ -24,7 +24,10 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 
 #include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
 
@@ -35,13 +38,38 @@ namespace ZeeBasic::Compiler
 
     LexicalAnalyzer::LexicalAnalyzer(ISourceReader& sourceReader)
         :
-        m_sourceReader(&sourceReader),
+        LexicalAnalyzer(sourceReader.getData(), sourceReader.getSize())
+    {
+        if (!m_begin)
+        {
+            m_sourceReader = &sourceReader;
+        }
+    }
+
+    LexicalAnalyzer::LexicalAnalyzer(const char* data, size_t size)
+        :
+        LexicalAnalyzer(data, size, SourceScanner::getBestLevel())
+    { }
+
+    LexicalAnalyzer::LexicalAnalyzer(const char* data, size_t size, ScanLevel scanLevel)
+        :
+        LexicalAnalyzer(data, data, data ? data + size : nullptr, scanLevel)
+    { }
+
+    LexicalAnalyzer::LexicalAnalyzer(const char* source, const char* begin, const char* end, ScanLevel scanLevel)
+        :
+        m_sourceReader(nullptr),
         m_state(State::Begin),
         m_ch(0),
-        m_lineNo(1),
-        m_colNo(1),
-        m_range(),
-        m_text()
+        m_offset(0),
+        m_location(),
+        m_first(0),
+        m_length(0),
+        m_text(),
+        m_begin(source),
+        m_cursor(begin),
+        m_end(end),
+        m_scanner(&SourceScanner::get(scanLevel))
     { }
 
     LexicalAnalyzer::~LexicalAnalyzer()
@@ -49,40 +77,39 @@ namespace ZeeBasic::Compiler
 
     Token LexicalAnalyzer::parseNextToken()
     {
+        if (m_begin)
+        {
+            return parseNextBufferToken();
+        }
+
         // consume tokens until one should be kept
         m_state = State::Begin;
         do
         {
-            m_sourceReader->getReadPosition(m_lineNo, m_colNo);
             if (m_ch == 0)
             {
-                m_ch = m_sourceReader->readNextChar();
+                m_ch = readNextChar();
                 if (m_ch == 0)
                 {
-                    return { TokenId::EndOfCode, {}, {} };
+                    return { TokenId::EndOfCode, SourceLocation{ m_offset }, {} };
                 }
             }
-            else
-            {
-                // TODO : bad hack, find better way of doing this
-                // subtract one after initial character because we always look ahead one which increments
-                // the counts
-                m_colNo--;
-            }
 
             // prepare for new token
-            m_range = { m_lineNo, m_colNo };
+            m_location = SourceLocation{ m_offset - 1 };
+            m_first = m_ch;
+            m_length = 1;
             m_text.clear();
             m_text.push_back(m_ch);
             m_state = getTokenStartState(m_ch);
             
-            m_ch = m_sourceReader->readNextChar();
+            m_ch = readNextChar();
             auto result = consumeChar(m_ch);
             while (result == ConsumeState::Consume || result == ConsumeState::ConsumeAndComplete)
             {
                 m_text.push_back(m_ch);
-                ++m_range;
-                m_ch = m_sourceReader->readNextChar();
+                ++m_length;
+                m_ch = readNextChar();
 
                 if (result == ConsumeState::ConsumeAndComplete)
                 {
@@ -96,6 +123,16 @@ namespace ZeeBasic::Compiler
         return constructToken();
     }
 
+    char LexicalAnalyzer::readNextChar()
+    {
+        auto ch = m_sourceReader->readNextChar();
+        if (ch != 0)
+        {
+            ++m_offset;
+        }
+        return ch;
+    }
+
     static bool isSymbolStart(char ch)
     {
         auto symbols = "+-*/\\<>=:,;().";
@@ -137,7 +174,7 @@ namespace ZeeBasic::Compiler
             return State::Symbol;
         }
 
-        throw Error::create({ m_lineNo, m_colNo }, "Unexpected character encountered");
+        throw Error::create(m_location, "Unexpected character encountered");
     }
 
     LexicalAnalyzer::ConsumeState LexicalAnalyzer::consumeChar(char ch)
@@ -176,7 +213,7 @@ namespace ZeeBasic::Compiler
             {
                 return ConsumeState::Consume;
             }
-            else if (m_text[0] == '.' && m_text.length() == 1)
+            else if (m_first == '.' && m_length == 1)
             {
                 m_state = State::Symbol;
             }
@@ -185,7 +222,11 @@ namespace ZeeBasic::Compiler
         case State::String:
             if (m_ch == '\n')
             {
-                throw Error::create(m_range, "End-of-line not permitted in string literal.");
+                throw Error::create(m_location, "End-of-line not permitted in string literal.");
+            }
+            else if (m_ch == 0)
+            {
+                throw Error::create(m_location, "Unterminated string literal.");
             }
             else if (m_ch == '"')
             {
@@ -212,11 +253,11 @@ namespace ZeeBasic::Compiler
             break;
 
         case State::Symbol:
-            if (m_text[0] == '<' && (m_ch == '=' || m_ch == '>'))
+            if (m_first == '<' && (m_ch == '=' || m_ch == '>'))
             {
                 return ConsumeState::ConsumeAndComplete;
             }
-            else if (m_text[0] == '>' && m_ch == '=')
+            else if (m_first == '>' && m_ch == '=')
             {
                 return ConsumeState::ConsumeAndComplete;
             }
@@ -230,147 +271,263 @@ namespace ZeeBasic::Compiler
         return ConsumeState::Complete;
     }
 
-    static TokenId getKeywordId(const char* text, int length)
+    // keyword spellings, which must be listed in the same order as the keywords in TokenId
+    static constexpr struct {
+        const char* text;
+        int length;
+        TokenId id;
+    } kKeywords[] = {
+        { "ABS", 3, TokenId::Key_ABS },
+        { "AND", 3, TokenId::Key_AND },
+        { "AS", 2, TokenId::Key_AS },
+        { "ASC", 3, TokenId::Key_ASC },
+        { "ATN", 3, TokenId::Key_ATN },
+        { "BIN$", 4, TokenId::Key_BIN_S },
+        { "BOOLEAN", 7, TokenId::Key_BOOLEAN },
+        { "CALL", 4, TokenId::Key_CALL },
+        { "CASE", 4, TokenId::Key_CASE },
+        { "CHR$", 4, TokenId::Key_CHR_S },
+        { "COMMAND$", 8, TokenId::Key_COMMAND_S },
+        { "CONST", 5, TokenId::Key_CONST },
+        { "COS", 3, TokenId::Key_COS },
+        { "DATA", 4, TokenId::Key_DATA },
+        { "DATE$", 5, TokenId::Key_DATE_S },
+        { "DECLARE", 7, TokenId::Key_DECLARE },
+        { "DIM", 3, TokenId::Key_DIM },
+        { "DO", 2, TokenId::Key_DO },
+        { "ELSE", 4, TokenId::Key_ELSE },
+        { "ELSEIF", 6, TokenId::Key_ELSEIF },
+        { "END", 3, TokenId::Key_END },
+        { "ENVIRON$", 8, TokenId::Key_ENVIRON_S },
+        { "EXIT", 4, TokenId::Key_EXIT },
+        { "EXP", 3, TokenId::Key_EXP },
+        { "FALSE", 5, TokenId::Key_FALSE },
+        { "FIX", 3, TokenId::Key_FIX },
+        { "FOR", 3, TokenId::Key_FOR },
+        { "FUNCTION", 8, TokenId::Key_FUNCTION },
+        { "GOSUB", 5, TokenId::Key_GOSUB },
+        { "HEX$", 4, TokenId::Key_HEX_S },
+        { "IF", 2, TokenId::Key_IF },
+        { "INKEY$", 6, TokenId::Key_INKEY_S },
+        { "INPUT", 5, TokenId::Key_INPUT },
+        { "INSTR", 5, TokenId::Key_INSTR },
+        { "INT", 3, TokenId::Key_INT },
+        { "INTEGER", 7, TokenId::Key_INTEGER },
+        { "IS", 2, TokenId::Key_IS },
+        { "LBOUND", 6, TokenId::Key_LBOUND },
+        { "LCASE$", 6, TokenId::Key_LCASE_S },
+        { "LEFT$", 5, TokenId::Key_LEFT_S },
+        { "LEN", 3, TokenId::Key_LEN },
+        { "LOG", 3, TokenId::Key_LOG },
+        { "LOOP", 4, TokenId::Key_LOOP },
+        { "LTRIM$", 6, TokenId::Key_LTRIM_S },
+        { "MID$", 4, TokenId::Key_MID_S },
+        { "MOD", 3, TokenId::Key_MOD },
+        { "NEXT", 4, TokenId::Key_NEXT },
+        { "NOT", 3, TokenId::Key_NOT },
+        { "OCT$", 4, TokenId::Key_OCT_S },
+        { "OR", 2, TokenId::Key_OR },
+        { "PRINT", 5, TokenId::Key_PRINT },
+        { "RANDOMIZE", 9, TokenId::Key_RANDOMIZE },
+        { "READ", 4, TokenId::Key_READ },
+        { "REAL", 4, TokenId::Key_REAL },
+        { "REDIM", 5, TokenId::Key_REDIM },
+        { "RESTORE", 7, TokenId::Key_RESTORE },
+        { "RETURN", 6, TokenId::Key_RETURN },
+        { "RIGHT$", 6, TokenId::Key_RIGHT_S },
+        { "RND", 3, TokenId::Key_RND },
+        { "RTRIM$", 6, TokenId::Key_RTRIM_S },
+        { "SELECT", 6, TokenId::Key_SELECT },
+        { "SHARED", 6, TokenId::Key_SHARED },
+        { "SGN", 3, TokenId::Key_SGN },
+        { "SIN", 3, TokenId::Key_SIN },
+        { "SLEEP", 5, TokenId::Key_SLEEP },
+        { "SPACE$", 6, TokenId::Key_SPACE_S },
+        { "SQR", 3, TokenId::Key_SQR },
+        { "STATIC", 6, TokenId::Key_STATIC },
+        { "STEP", 4, TokenId::Key_STEP },
+        { "STR$", 4, TokenId::Key_STR_S },
+        { "STRING", 6, TokenId::Key_STRING },
+        { "STRING$", 7, TokenId::Key_STRING_S },
+        { "SUB", 3, TokenId::Key_SUB },
+        { "SWAP", 4, TokenId::Key_SWAP },
+        { "TAN", 3, TokenId::Key_TAN },
+        { "TIME$", 5, TokenId::Key_TIME_S },
+        { "TIMER", 5, TokenId::Key_TIMER },
+        { "THEN", 4, TokenId::Key_THEN },
+        { "TO", 2, TokenId::Key_TO },
+        { "TRUE", 4, TokenId::Key_TRUE },
+        { "TYPE", 4, TokenId::Key_TYPE },
+        { "UBOUND", 6, TokenId::Key_UBOUND },
+        { "UCASE$", 6, TokenId::Key_UCASE_S },
+        { "UNTIL", 5, TokenId::Key_UNTIL },
+        { "VAL", 3, TokenId::Key_VAL },
+        { "WHILE", 5, TokenId::Key_WHILE },
+        { "XOR", 3, TokenId::Key_XOR },
+    };
+
+    static constexpr auto kKeywordCount = int(sizeof(kKeywords) / sizeof(kKeywords[0]));
+
+    static constexpr bool keywordsMatchTokenIds()
     {
-        static struct {
-            const char* text;
-            int length;
-            TokenId id;
-        } keywords[] = {
-            { "ABS", 3, TokenId::Key_ABS },
-            { "AND", 3, TokenId::Key_AND },
-            { "AS", 2, TokenId::Key_AS },
-            { "ASC", 3, TokenId::Key_ASC },
-            { "ATN", 3, TokenId::Key_ATN },
-            { "BIN$", 4, TokenId::Key_BIN_S },
-            { "BOOLEAN", 7, TokenId::Key_BOOLEAN },
-            { "CALL", 4, TokenId::Key_CALL },
-            { "CASE", 4, TokenId::Key_CASE },
-            { "CHR$", 4, TokenId::Key_CHR_S },
-            { "COMMAND$", 8, TokenId::Key_COMMAND_S },
-            { "CONST", 5, TokenId::Key_CONST },
-            { "COS", 3, TokenId::Key_COS },
-            { "DATA", 4, TokenId::Key_DATA },
-            { "DATE$", 5, TokenId::Key_DATE_S },
-            { "DECLARE", 7, TokenId::Key_DECLARE },
-            { "DIM", 3, TokenId::Key_DIM },
-            { "DO", 2, TokenId::Key_DO },
-            { "ELSE", 4, TokenId::Key_ELSE },
-            { "ELSEIF", 6, TokenId::Key_ELSEIF },
-            { "END", 3, TokenId::Key_END },
-            { "ENVIRON$", 8, TokenId::Key_ENVIRON_S },
-            { "EXIT", 4, TokenId::Key_EXIT },
-            { "EXP", 3, TokenId::Key_EXP },
-            { "FALSE", 5, TokenId::Key_FALSE },
-            { "FIX", 3, TokenId::Key_FIX },
-            { "FOR", 3, TokenId::Key_FOR },
-            { "FUNCTION", 8, TokenId::Key_FUNCTION },
-            { "GOSUB", 5, TokenId::Key_GOSUB },
-            { "HEX$", 4, TokenId::Key_HEX_S },
-            { "IF", 2, TokenId::Key_IF },
-            { "INKEY$", 6, TokenId::Key_INKEY_S },
-            { "INPUT", 5, TokenId::Key_INPUT },
-            { "INSTR", 5, TokenId::Key_INSTR },
-            { "INT", 3, TokenId::Key_INT },
-            { "INTEGER", 7, TokenId::Key_INTEGER },
-            { "IS", 2, TokenId::Key_IS },
-            { "LBOUND", 6, TokenId::Key_LBOUND },
-            { "LCASE$", 6, TokenId::Key_LCASE_S },
-            { "LEFT$", 5, TokenId::Key_LEFT_S },
-            { "LEN", 3, TokenId::Key_LEN },
-            { "LOG", 3, TokenId::Key_LOG },
-            { "LOOP", 4, TokenId::Key_LOOP },
-            { "LTRIM$", 6, TokenId::Key_LTRIM_S },
-            { "MID$", 4, TokenId::Key_MID_S },
-            { "MOD", 3, TokenId::Key_MOD },
-            { "NEXT", 4, TokenId::Key_NEXT },
-            { "NOT", 3, TokenId::Key_NOT },
-            { "OCT$", 4, TokenId::Key_OCT_S },
-            { "OR", 2, TokenId::Key_OR },
-            { "PRINT", 5, TokenId::Key_PRINT },
-            { "RANDOMIZE", 9, TokenId::Key_RANDOMIZE },
-            { "READ", 4, TokenId::Key_READ },
-            { "REAL", 4, TokenId::Key_REAL },
-            { "REDIM", 5, TokenId::Key_REDIM },
-            { "RESTORE", 7, TokenId::Key_RESTORE },
-            { "RETURN", 6, TokenId::Key_RETURN },
-            { "RIGHT$", 6, TokenId::Key_RIGHT_S },
-            { "RND", 3, TokenId::Key_RND },
-            { "RTRIM$", 6, TokenId::Key_RTRIM_S },
-            { "SELECT", 6, TokenId::Key_SELECT },
-            { "SHARED", 6, TokenId::Key_SHARED },
-            { "SGN", 3, TokenId::Key_SGN },
-            { "SIN", 3, TokenId::Key_SIN },
-            { "SLEEP", 5, TokenId::Key_SLEEP },
-            { "SPACE$", 6, TokenId::Key_SPACE_S },
-            { "SQR", 3, TokenId::Key_SQR },
-            { "STATIC", 6, TokenId::Key_STATIC },
-            { "STEP", 4, TokenId::Key_STEP },
-            { "STR$", 4, TokenId::Key_STR_S },
-            { "STRING", 6, TokenId::Key_STRING },
-            { "STRING$", 7, TokenId::Key_STRING_S },
-            { "SUB", 3, TokenId::Key_SUB },
-            { "SWAP", 4, TokenId::Key_SWAP },
-            { "TAN", 3, TokenId::Key_TAN },
-            { "TIME$", 5, TokenId::Key_TIME_S },
-            { "TIMER", 5, TokenId::Key_TIMER },
-            { "THEN", 4, TokenId::Key_THEN },
-            { "TO", 2, TokenId::Key_TO },
-            { "TRUE", 4, TokenId::Key_TRUE },
-            { "TYPE", 4, TokenId::Key_TYPE },
-            { "UBOUND", 6, TokenId::Key_UBOUND },
-            { "UCASE$", 6, TokenId::Key_UCASE_S },
-            { "UNTIL", 5, TokenId::Key_UNTIL },
-            { "VAL", 3, TokenId::Key_VAL },
-            { "WHILE", 5, TokenId::Key_WHILE },
-            { "XOR", 3, TokenId::Key_XOR },
-            { nullptr, 0, TokenId::EndOfCode }
-        };
-        for (auto i = 0; keywords[i].text; ++i)
-        {
-#ifdef _WIN32
-            if (keywords[i].length == length && _stricmp(keywords[i].text, text) == 0)
-#else
-            if (keywords[i].length == length && strcasecmp(keywords[i].text, text) == 0)
-#endif
+        for (auto i = 0; i < kKeywordCount; ++i)
+        {
+            auto length = 0;
+            while (kKeywords[i].text[length])
+            {
+                ++length;
+            }
+
+            if (kKeywords[i].id != TokenId(int(TokenId::Key_ABS) + i) || kKeywords[i].length != length)
             {
-                return keywords[i].id;
+                return false;
             }
         }
+        return true;
+    }
+
+    static_assert(int(TokenId::Key_XOR) + 1 == int(TokenId::Sym_Add), "keywords must precede the symbols in TokenId");
+    static_assert(kKeywordCount == int(TokenId::Key_XOR) - int(TokenId::Key_ABS) + 1, "keyword table is out of sync with TokenId");
+    static_assert(keywordsMatchTokenIds(), "keyword table is out of sync with TokenId");
 
-        return TokenId::UntypedName;
+    // Keywords are found through a perfect hash of the length and the first, second and last characters. Folding
+    // with 0xDF upper cases letters and keeps every other character allowed in a name distinct from them.
+    static constexpr uint32_t foldKeywordChar(char ch)
+    {
+        return uint8_t(ch) & 0xDF;
     }
 
-    static TokenId matchSymbolId(const char* text)
+    static constexpr uint32_t getKeywordKey(const char* text, int length)
     {
-        static struct {
-            const char* symbol;
-            TokenId id;
-        } symbols[] = {
-            { "+", TokenId::Sym_Add },
-            { "-", TokenId::Sym_Subtract },
-            { "*", TokenId::Sym_Multiply },
-            { "/", TokenId::Sym_Divide },
-            { "\\", TokenId::Sym_IntDivide },
-            { "<", TokenId::Sym_Less },
-            { "<=", TokenId::Sym_LessEquals },
-            { ">", TokenId::Sym_Greater },
-            { ">=", TokenId::Sym_GreaterEquals },
-            { "=", TokenId::Sym_Equal },
-            { "<>", TokenId::Sym_NotEqual },
-            { ":", TokenId::Sym_Colon },
-            { ",", TokenId::Sym_Comma },
-            { ";", TokenId::Sym_Semicolon },
-            { "(", TokenId::Sym_OpenParen },
-            { ")", TokenId::Sym_CloseParen },
-            { ".", TokenId::Sym_Period},
-            { nullptr, TokenId::EndOfCode }
-        };
-        for (auto i = 0; symbols[i].symbol; ++i)
-        {
-            if (strcmp(symbols[i].symbol, text) == 0)
+        return (uint32_t(length) << 24) | (foldKeywordChar(text[0]) << 16) | (foldKeywordChar(text[1]) << 8) |
+            foldKeywordChar(text[length - 1]);
+    }
+
+    static constexpr auto kKeywordHashBits = 10;
+    static constexpr auto kKeywordSlotEmpty = uint8_t(0xFF);
+
+    struct KeywordHash
+    {
+        uint32_t multiplier;
+        std::array<uint8_t, 1 << kKeywordHashBits> slots;
+    };
+
+    static constexpr uint32_t getKeywordSlot(uint32_t key, uint32_t multiplier)
+    {
+        return (key * multiplier) >> (32 - kKeywordHashBits);
+    }
+
+    static constexpr bool isKeywordHashPerfect(uint32_t multiplier)
+    {
+        std::array<uint64_t, (1 << kKeywordHashBits) / 64> used = {};
+        for (auto i = 0; i < kKeywordCount; ++i)
+        {
+            auto slot = getKeywordSlot(getKeywordKey(kKeywords[i].text, kKeywords[i].length), multiplier);
+            auto bit = uint64_t(1) << (slot % 64);
+            if (used[slot / 64] & bit)
             {
-                return symbols[i].id;
+                return false;
+            }
+            used[slot / 64] |= bit;
+        }
+        return true;
+    }
+
+    // searches a fixed sequence of odd multipliers for the first one that places every keyword in its own slot
+    static constexpr KeywordHash buildKeywordHash()
+    {
+        KeywordHash hash = { 0, {} };
+        auto candidate = uint32_t(0x9E3779B9);
+        for (auto attempt = 0; attempt < 10000 && hash.multiplier == 0; ++attempt)
+        {
+            candidate = candidate * 1664525 + 1013904223;
+            if (isKeywordHashPerfect(candidate | 1))
+            {
+                hash.multiplier = candidate | 1;
+            }
+        }
+
+        for (auto& slot : hash.slots)
+        {
+            slot = kKeywordSlotEmpty;
+        }
+        for (auto i = 0; i < kKeywordCount && hash.multiplier != 0; ++i)
+        {
+            hash.slots[getKeywordSlot(getKeywordKey(kKeywords[i].text, kKeywords[i].length), hash.multiplier)] = uint8_t(i);
+        }
+        return hash;
+    }
+
+    static constexpr int getMaxKeywordLength()
+    {
+        auto result = 0;
+        for (auto& keyword : kKeywords)
+        {
+            result = keyword.length > result ? keyword.length : result;
+        }
+        return result;
+    }
+
+    static constexpr auto kKeywordHash = buildKeywordHash();
+    static constexpr auto kMaxKeywordLength = getMaxKeywordLength();
+
+    static_assert(kKeywordHash.multiplier != 0, "no perfect hash found for the keywords, increase kKeywordHashBits");
+    static_assert(kKeywordCount < kKeywordSlotEmpty);
+
+    static TokenId getKeywordId(const char* text, int length)
+    {
+        if (length < 2 || length > kMaxKeywordLength)
+        {
+            return TokenId::UntypedName;
+        }
+
+        auto index = kKeywordHash.slots[getKeywordSlot(getKeywordKey(text, length), kKeywordHash.multiplier)];
+        if (index == kKeywordSlotEmpty || kKeywords[index].length != length)
+        {
+            return TokenId::UntypedName;
+        }
+
+        auto keyword = kKeywords[index].text;
+        for (auto i = 0; i < length; ++i)
+        {
+            if (foldKeywordChar(text[i]) != foldKeywordChar(keyword[i]))
+            {
+                return TokenId::UntypedName;
+            }
+        }
+        return kKeywords[index].id;
+    }
+
+    static constexpr struct {
+        const char* symbol;
+        TokenId id;
+    } kSymbols[] = {
+        { "+", TokenId::Sym_Add },
+        { "-", TokenId::Sym_Subtract },
+        { "*", TokenId::Sym_Multiply },
+        { "/", TokenId::Sym_Divide },
+        { "\\", TokenId::Sym_IntDivide },
+        { "<", TokenId::Sym_Less },
+        { "<=", TokenId::Sym_LessEquals },
+        { ">", TokenId::Sym_Greater },
+        { ">=", TokenId::Sym_GreaterEquals },
+        { "=", TokenId::Sym_Equal },
+        { "<>", TokenId::Sym_NotEqual },
+        { ":", TokenId::Sym_Colon },
+        { ",", TokenId::Sym_Comma },
+        { ";", TokenId::Sym_Semicolon },
+        { "(", TokenId::Sym_OpenParen },
+        { ")", TokenId::Sym_CloseParen },
+        { ".", TokenId::Sym_Period},
+    };
+
+    static TokenId matchSymbolId(const char* text, int length)
+    {
+        for (const auto& symbol : kSymbols)
+        {
+            if (strncmp(symbol.symbol, text, size_t(length)) == 0 && symbol.symbol[length] == 0)
+            {
+                return symbol.id;
             }
         }
 
@@ -383,33 +540,33 @@ namespace ZeeBasic::Compiler
         {
 
         case State::Integer:
-            return { TokenId::Integer, m_range, { m_text.c_str(), int(m_text.length()) } };
+            return { TokenId::Integer, m_location, { m_text.c_str(), m_length } };
 
         case State::Real:
-            return { TokenId::Real, m_range, { m_text.c_str(), int(m_text.length()) } };
+            return { TokenId::Real, m_location, { m_text.c_str(), m_length } };
 
         case State::String:
-            return { TokenId::String, m_range, { m_text.c_str() + 1, int(m_text.length()) - 2 } };
+            return { TokenId::String, m_location, { m_text.c_str() + 1, m_length - 2 } };
 
         case State::Name:
             // check for keyword first
-            if (auto id = getKeywordId(m_text.c_str(), int(m_text.length())); id != TokenId::UntypedName)
+            if (auto id = getKeywordId(m_text.c_str(), m_length); id != TokenId::UntypedName)
             {
-                return { id, m_range, { m_text.c_str(), int(m_text.length()) } };
+                return { id, m_location, { m_text.c_str(), m_length } };
             }
 
-            if (auto ch = m_text[m_text.length() - 1]; ch == '?' || ch == '%' || ch == '!' || ch == '$')
+            if (auto ch = m_text[m_length - 1]; ch == '?' || ch == '%' || ch == '!' || ch == '$')
             {
-                return { TokenId::TypedName, m_range, { m_text.c_str(), int(m_text.length()) } };
+                return { TokenId::TypedName, m_location, { m_text.c_str(), m_length } };
             }
 
-            return { TokenId::UntypedName, m_range, { m_text.c_str(), int(m_text.length()) } };
+            return { TokenId::UntypedName, m_location, { m_text.c_str(), m_length } };
 
         case State::Symbol:
-            return { matchSymbolId(m_text.c_str()), m_range, { m_text.c_str(), int(m_text.length()) } };
+            return { matchSymbolId(m_text.c_str(), m_length), m_location, { m_text.c_str(), m_length } };
 
         case State::EndOfLine:
-            return { TokenId::EndOfLine, m_range, {} };
+            return { TokenId::EndOfLine, m_location, {} };
 
         default:
             break;
@@ -418,4 +575,321 @@ namespace ZeeBasic::Compiler
         throw std::runtime_error("Internal state error");
     }
 
+    //
+    // Table-driven lexing of contiguous buffers
+    //
+
+    // classes of characters that the state machine distinguishes between
+    enum CharClass : uint8_t
+    {
+        CharClass_End,          // end of source (an embedded null also ends the source)
+        CharClass_Space,
+        CharClass_Newline,
+        CharClass_Apostrophe,
+        CharClass_Quote,
+        CharClass_Letter,
+        CharClass_Digit,
+        CharClass_Underscore,
+        CharClass_Period,
+        CharClass_TypeSuffix,
+        CharClass_Less,
+        CharClass_Greater,
+        CharClass_Equal,
+        CharClass_Operator,
+        CharClass_Other,
+        CharClass_Count
+    };
+
+    // states of the state machine, every state from DfaState_Done on stops the current token
+    enum DfaState : uint8_t
+    {
+        DfaState_Start,
+        DfaState_Whitespace,
+        DfaState_Comment,
+        DfaState_Integer,
+        DfaState_Real,
+        DfaState_Period,            // lone period is a symbol, with digits it starts a real
+        DfaState_String,
+        DfaState_StringEnd,
+        DfaState_Name,
+        DfaState_TypedName,
+        DfaState_Less,
+        DfaState_Greater,
+        DfaState_Symbol,
+        DfaState_EndOfLine,
+
+        DfaState_Done,
+        DfaState_BadChar,
+        DfaState_StringNewline,
+        DfaState_StringUnterminated,
+    };
+
+    static constexpr std::array<uint8_t, 256> buildCharClasses()
+    {
+        auto classes = std::array<uint8_t, 256>{};
+        for (auto i = 0; i < 256; ++i)
+        {
+            classes[i] = CharClass_Other;
+        }
+
+        for (auto ch = 'a'; ch <= 'z'; ++ch)
+        {
+            classes[uint8_t(ch)] = CharClass_Letter;
+            classes[uint8_t(ch - 'a' + 'A')] = CharClass_Letter;
+        }
+
+        for (auto ch = '0'; ch <= '9'; ++ch)
+        {
+            classes[uint8_t(ch)] = CharClass_Digit;
+        }
+
+        for (auto ch : "+-*/\\:,;()")
+        {
+            classes[uint8_t(ch)] = CharClass_Operator;
+        }
+
+        for (auto ch : "?%!$")
+        {
+            classes[uint8_t(ch)] = CharClass_TypeSuffix;
+        }
+
+        classes[0] = CharClass_End;
+        classes[uint8_t(' ')] = CharClass_Space;
+        classes[uint8_t('\t')] = CharClass_Space;
+        classes[uint8_t('\n')] = CharClass_Newline;
+        classes[uint8_t('\'')] = CharClass_Apostrophe;
+        classes[uint8_t('"')] = CharClass_Quote;
+        classes[uint8_t('_')] = CharClass_Underscore;
+        classes[uint8_t('.')] = CharClass_Period;
+        classes[uint8_t('<')] = CharClass_Less;
+        classes[uint8_t('>')] = CharClass_Greater;
+        classes[uint8_t('=')] = CharClass_Equal;
+        return classes;
+    }
+
+    using DfaTable = std::array<std::array<uint8_t, CharClass_Count>, DfaState_Done>;
+
+    static constexpr DfaTable buildTransitions()
+    {
+        auto table = DfaTable{};
+        for (auto state = 0; state < DfaState_Done; ++state)
+        {
+            for (auto cls = 0; cls < CharClass_Count; ++cls)
+            {
+                table[state][cls] = DfaState_Done;
+            }
+        }
+
+        auto& start = table[DfaState_Start];
+        start[CharClass_Space] = DfaState_Whitespace;
+        start[CharClass_Newline] = DfaState_EndOfLine;
+        start[CharClass_Apostrophe] = DfaState_Comment;
+        start[CharClass_Quote] = DfaState_String;
+        start[CharClass_Letter] = DfaState_Name;
+        start[CharClass_Digit] = DfaState_Integer;
+        start[CharClass_Underscore] = DfaState_BadChar;
+        start[CharClass_Period] = DfaState_Period;
+        start[CharClass_TypeSuffix] = DfaState_BadChar;
+        start[CharClass_Less] = DfaState_Less;
+        start[CharClass_Greater] = DfaState_Greater;
+        start[CharClass_Equal] = DfaState_Symbol;
+        start[CharClass_Operator] = DfaState_Symbol;
+        start[CharClass_Other] = DfaState_BadChar;
+
+        table[DfaState_Whitespace][CharClass_Space] = DfaState_Whitespace;
+
+        for (auto cls = 0; cls < CharClass_Count; ++cls)
+        {
+            table[DfaState_Comment][cls] = DfaState_Comment;
+            table[DfaState_String][cls] = DfaState_String;
+        }
+        table[DfaState_Comment][CharClass_End] = DfaState_Done;
+        table[DfaState_Comment][CharClass_Newline] = DfaState_Done;
+        table[DfaState_String][CharClass_End] = DfaState_StringUnterminated;
+        table[DfaState_String][CharClass_Newline] = DfaState_StringNewline;
+        table[DfaState_String][CharClass_Quote] = DfaState_StringEnd;
+
+        table[DfaState_Integer][CharClass_Digit] = DfaState_Integer;
+        table[DfaState_Integer][CharClass_Period] = DfaState_Real;
+        table[DfaState_Real][CharClass_Digit] = DfaState_Real;
+        table[DfaState_Period][CharClass_Digit] = DfaState_Real;
+
+        table[DfaState_Name][CharClass_Letter] = DfaState_Name;
+        table[DfaState_Name][CharClass_Digit] = DfaState_Name;
+        table[DfaState_Name][CharClass_Underscore] = DfaState_Name;
+        table[DfaState_Name][CharClass_TypeSuffix] = DfaState_TypedName;
+
+        table[DfaState_Less][CharClass_Equal] = DfaState_Symbol;
+        table[DfaState_Less][CharClass_Greater] = DfaState_Symbol;
+        table[DfaState_Greater][CharClass_Equal] = DfaState_Symbol;
+
+        return table;
+    }
+
+    static constexpr std::array<TokenId, 256> buildSymbolIds()
+    {
+        auto ids = std::array<TokenId, 256>{};
+        for (const auto& symbol : kSymbols)
+        {
+            if (symbol.symbol[1] == 0)
+            {
+                ids[uint8_t(symbol.symbol[0])] = symbol.id;
+            }
+        }
+        return ids;
+    }
+
+    static constexpr auto kCharClasses = buildCharClasses();
+    static constexpr auto kTransitions = buildTransitions();
+    static constexpr auto kSymbolIds = buildSymbolIds();
+
+    static_assert(kTransitions[DfaState_Start][CharClass_Letter] == DfaState_Name);
+    static_assert(kSymbolIds[uint8_t('+')] == TokenId::Sym_Add);
+
+    // advance the cursor until the state machine completes a token, leaving the final state behind
+    static inline void runStateMachine(const char*& cursor, uint8_t& state, const char* end)
+    {
+        while (true)
+        {
+            auto cls = cursor != end ? kCharClasses[uint8_t(*cursor)] : uint8_t(CharClass_End);
+            auto next = kTransitions[state][cls];
+            if (next >= DfaState_Done)
+            {
+                if (next != DfaState_Done || state == DfaState_Start)
+                {
+                    state = next;
+                }
+                break;
+            }
+
+            state = next;
+            ++cursor;
+        }
+    }
+
+    Token LexicalAnalyzer::parseNextBufferToken()
+    {
+        while (true)
+        {
+            auto start = m_cursor;
+            if (start == m_end || kCharClasses[uint8_t(*start)] == CharClass_End)
+            {
+                return { TokenId::EndOfCode, SourceLocation{ uint32_t(start - m_begin) }, {} };
+            }
+
+            // whitespace and comments are skipped, and strings found, by the scanner; everything else runs the state
+            // machine until the token is complete
+            auto cursor = start;
+            auto state = uint8_t(DfaState_Start);
+            switch (kCharClasses[uint8_t(*start)])
+            {
+
+            case CharClass_Space:
+                m_cursor = m_scanner->skipBlanks(start + 1, m_end);
+                continue;
+
+            case CharClass_Apostrophe:
+                m_cursor = m_scanner->findLineEnd(start + 1, m_end);
+                continue;
+
+            case CharClass_Quote:
+                cursor = m_scanner->findStringEnd(start + 1, m_end);
+                if (cursor == m_end || *cursor == 0)
+                {
+                    state = DfaState_StringUnterminated;
+                }
+                else if (*cursor == '\n')
+                {
+                    state = DfaState_StringNewline;
+                }
+                else
+                {
+                    state = DfaState_StringEnd;
+                    ++cursor;
+                }
+                break;
+
+            default:
+                runStateMachine(cursor, state, m_end);
+                break;
+
+            }
+
+            auto length = int(cursor - start);
+            auto location = SourceLocation{ uint32_t(start - m_begin) };
+
+            switch (state)
+            {
+
+            case DfaState_Whitespace:
+            case DfaState_Comment:
+                m_cursor = cursor;
+                continue;
+
+            case DfaState_Integer:
+                m_cursor = cursor;
+                return { TokenId::Integer, location, ConstString::view(start, length) };
+
+            case DfaState_Real:
+                m_cursor = cursor;
+                return { TokenId::Real, location, ConstString::view(start, length) };
+
+            case DfaState_Period:
+                m_cursor = cursor;
+                return { TokenId::Sym_Period, location, ConstString::view(start, length) };
+
+            case DfaState_StringEnd:
+                m_cursor = cursor;
+                return { TokenId::String, location, ConstString::view(start + 1, length - 2) };
+
+            case DfaState_Name:
+            case DfaState_TypedName:
+                m_cursor = cursor;
+                if (auto id = getKeywordId(start, length); id != TokenId::UntypedName)
+                {
+                    return { id, location, ConstString::view(start, length) };
+                }
+                return { state == DfaState_TypedName ? TokenId::TypedName : TokenId::UntypedName, location, ConstString::view(start, length) };
+
+            case DfaState_Less:
+                m_cursor = cursor;
+                return { TokenId::Sym_Less, location, ConstString::view(start, length) };
+
+            case DfaState_Greater:
+                m_cursor = cursor;
+                return { TokenId::Sym_Greater, location, ConstString::view(start, length) };
+
+            case DfaState_Symbol:
+            {
+                m_cursor = cursor;
+                auto id = kSymbolIds[uint8_t(start[0])];
+                if (length == 2)
+                {
+                    id = start[1] == '>' ? TokenId::Sym_NotEqual : start[0] == '<' ? TokenId::Sym_LessEquals : TokenId::Sym_GreaterEquals;
+                }
+                return { id, location, ConstString::view(start, length) };
+            }
+
+            case DfaState_EndOfLine:
+                m_cursor = cursor;
+                return { TokenId::EndOfLine, location, {} };
+
+            case DfaState_BadChar:
+                throw Error::create(location, "Unexpected character encountered");
+
+            case DfaState_StringNewline:
+                throw Error::create(location, "End-of-line not permitted in string literal.");
+
+            case DfaState_StringUnterminated:
+                throw Error::create(location, "Unterminated string literal.");
+
+            default:
+                break;
+
+            }
+
+            throw std::runtime_error("Internal state error");
+        }
+    }
+
 }
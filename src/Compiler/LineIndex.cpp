@@ -0,0 +1,97 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <algorithm>
+
+#include "ZeeBasic/Compiler/LineIndex.hpp"
+
+#include "ZeeBasic/Compiler/SourceScanner.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    LineIndex::LineIndex()
+        :
+        LineIndex(nullptr, 0)
+    { }
+
+    LineIndex::LineIndex(const char* data, size_t size)
+        :
+        m_data(data),
+        m_size(size),
+        m_lineStarts()
+    { }
+
+    LineIndex::~LineIndex()
+    { }
+
+    void LineIndex::build() const
+    {
+        m_lineStarts.push_back(0);
+        if (!m_data)
+        {
+            return;
+        }
+
+        // the lexer stops at a null character, so nothing after one can be reported
+        auto& scanner = SourceScanner::get();
+        auto end = m_data + m_size;
+        auto cursor = scanner.findLineEnd(m_data, end);
+        while (cursor != end && *cursor == '\n')
+        {
+            ++cursor;
+            m_lineStarts.push_back(uint32_t(cursor - m_data));
+            cursor = scanner.findLineEnd(cursor, end);
+        }
+    }
+
+    Range LineIndex::getRange(SourceLocation location) const
+    {
+        if (m_lineStarts.empty())
+        {
+            build();
+        }
+
+        // a location past the end, as reading on after the end gives, is where the source ends
+        auto offset = m_data ? uint32_t(std::min(size_t(location.offset), m_size)) : location.offset;
+
+        // the line is the last one starting at or before the location
+        auto next = std::upper_bound(m_lineStarts.begin(), m_lineStarts.end(), offset);
+        auto lineNo = int(next - m_lineStarts.begin());
+        return { lineNo, int(offset - *(next - 1)) + 1 };
+    }
+
+    int LineIndex::getLineCount() const
+    {
+        if (m_lineStarts.empty())
+        {
+            build();
+        }
+
+        return int(m_lineStarts.size());
+    }
+
+}
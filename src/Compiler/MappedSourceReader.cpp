@@ -0,0 +1,185 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ZeeBasic/Compiler/MappedSourceReader.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    static constexpr auto kEmptySource = "";
+
+    MappedSourceReader::MappedSourceReader(const std::string& path)
+        :
+        m_size(0),
+        m_data(kEmptySource),
+#ifdef _WIN32
+        m_mapping(nullptr),
+#endif
+        m_offset(0),
+        m_lines()
+    {
+#ifdef _WIN32
+        auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error(std::string{"Failed to open source file : "} + path);
+        }
+
+        LARGE_INTEGER len;
+        if (!GetFileSizeEx(file, &len))
+        {
+            CloseHandle(file);
+            throw std::runtime_error(std::string{"Failed to read source file : "} + path);
+        }
+
+        if (len.QuadPart > 0)
+        {
+            m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            auto view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            CloseHandle(file);
+            if (!view)
+            {
+                unmap();
+                throw std::runtime_error(std::string{"Failed to map source file : "} + path);
+            }
+
+            m_data = static_cast<const char*>(view);
+            m_size = size_t(len.QuadPart);
+        }
+        else
+        {
+            CloseHandle(file);
+        }
+#else
+        auto fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error(std::string{"Failed to open source file : "} + path);
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            close(fd);
+            throw std::runtime_error(std::string{"Failed to read source file : "} + path);
+        }
+
+        if (info.st_size > 0)
+        {
+            auto view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (view == MAP_FAILED)
+            {
+                throw std::runtime_error(std::string{"Failed to map source file : "} + path);
+            }
+
+            // the lexer reads the source front to back; the line index scans it again, also front to back, but
+            // only to report an error, when pages that were already dropped can be read back in
+            madvise(view, size_t(info.st_size), MADV_SEQUENTIAL);
+
+            m_data = static_cast<const char*>(view);
+            m_size = size_t(info.st_size);
+        }
+        else
+        {
+            close(fd);
+        }
+#endif
+
+        m_lines = LineIndex{ m_data, m_size };
+    }
+
+    MappedSourceReader::MappedSourceReader(MappedSourceReader&& other)
+        :
+        m_size(other.m_size),
+        m_data(other.m_data),
+#ifdef _WIN32
+        m_mapping(other.m_mapping),
+#endif
+        m_offset(other.m_offset),
+        m_lines(std::move(other.m_lines))
+    {
+        other.m_size = 0;
+        other.m_data = kEmptySource;
+#ifdef _WIN32
+        other.m_mapping = nullptr;
+#endif
+        other.m_lines = LineIndex{};
+    }
+
+    MappedSourceReader::~MappedSourceReader()
+    {
+        unmap();
+    }
+
+    void MappedSourceReader::unmap()
+    {
+#ifdef _WIN32
+        if (m_size > 0)
+        {
+            UnmapViewOfFile(m_data);
+        }
+
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        }
+#else
+        if (m_size > 0)
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+#endif
+
+        m_size = 0;
+        m_data = kEmptySource;
+    }
+
+    char MappedSourceReader::readNextChar()
+    {
+        if (m_offset >= m_size)
+        {
+            return 0;
+        }
+
+        return m_data[m_offset++];
+    }
+
+}
@@ -0,0 +1,75 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <algorithm>
+
+#include "ZeeBasic/Compiler/NodeArena.hpp"
+
+namespace ZeeBasic::Compiler::Nodes
+{
+
+	NodeArena::NodeArena()
+		:
+		m_blocks(),
+		m_cursor(nullptr),
+		m_end(nullptr),
+		m_nodes()
+	{ }
+
+	NodeArena::~NodeArena()
+	{
+		clear();
+	}
+
+	void NodeArena::clear()
+	{
+		// destroy in reverse so that a node goes before the nodes it was built from
+		for (auto node = m_nodes.rbegin(); node != m_nodes.rend(); ++node)
+		{
+			(*node)->~Node();
+		}
+		m_nodes.clear();
+
+		if (!m_blocks.empty())
+		{
+			m_blocks.resize(1);
+			m_cursor = m_blocks[0].get();
+			m_end = m_cursor + kBlockSize;
+		}
+	}
+
+	void* NodeArena::allocateBlock(size_t size, size_t alignment)
+	{
+		// new[] aligns for any fundamental type, which covers every node
+		auto blockSize = std::max(kBlockSize, size + alignment);
+		m_blocks.emplace_back(new char[blockSize]);
+		m_cursor = m_blocks.back().get();
+		m_end = m_cursor + blockSize;
+
+		return allocate(size, alignment);
+	}
+
+}
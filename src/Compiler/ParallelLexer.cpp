@@ -0,0 +1,158 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include <utility>
+
+#include "ZeeBasic/Compiler/ParallelLexer.hpp"
+
+#include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    ParallelLexer::ParallelLexer(const char* data, size_t size, unsigned threadCount, size_t chunkSize)
+        :
+        m_data(data),
+        m_size(size),
+        m_threadCount(threadCount ? threadCount : std::max(std::thread::hardware_concurrency(), 1u)),
+        m_chunkSize(std::max(chunkSize, size_t(1))),
+        m_scanLevel(SourceScanner::getBestLevel())
+    { }
+
+    ParallelLexer::~ParallelLexer()
+    { }
+
+    struct LexerChunk
+    {
+        const char* begin;
+        const char* end;
+        TokenBuffer tokens;
+        std::exception_ptr error;
+    };
+
+    // call work(index) for every index in [0, count), spreading the calls over the threads
+    template<typename Work>
+    static void runOnThreads(size_t count, unsigned threadCount, const Work& work)
+    {
+        auto next = std::atomic<size_t>{ 0 };
+        auto worker = [&] {
+            for (auto index = next++; index < count; index = next++)
+            {
+                work(index);
+            }
+        };
+
+        auto threads = std::vector<std::thread>{};
+        for (auto i = 1u; i < threadCount && i < count; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    TokenBuffer ParallelLexer::run()
+    {
+        // an embedded null ends the source for the sequential lexer, so nothing after it may be lexed here either
+        auto size = m_size;
+        if (auto null = m_data ? static_cast<const char*>(memchr(m_data, 0, m_size)) : nullptr)
+        {
+            size = size_t(null - m_data);
+        }
+
+        // split into chunks of roughly the requested size that each end just after a newline
+        auto chunks = std::vector<LexerChunk>{};
+        auto end = m_data + size;
+        for (auto begin = m_data; begin != end;)
+        {
+            auto chunkEnd = begin + std::min(m_chunkSize, size_t(end - begin));
+            if (chunkEnd != end)
+            {
+                auto newline = static_cast<const char*>(memchr(chunkEnd - 1, '\n', size_t(end - chunkEnd + 1)));
+                chunkEnd = newline ? newline + 1 : end;
+            }
+
+            chunks.push_back({ begin, chunkEnd, { m_data, size }, nullptr });
+            begin = chunkEnd;
+        }
+
+        runOnThreads(chunks.size(), m_threadCount, [&](size_t index) {
+            auto& chunk = chunks[index];
+            try
+            {
+                auto lexer = LexicalAnalyzer{ m_data, chunk.begin, chunk.end, m_scanLevel };
+                chunk.tokens.reserve(size_t(chunk.end - chunk.begin) / 4);
+                for (auto token = lexer.parseNextToken(); token.id != TokenId::EndOfCode; token = lexer.parseNextToken())
+                {
+                    chunk.tokens.append(token);
+                }
+            }
+            catch (...)
+            {
+                chunk.error = std::current_exception();
+            }
+        });
+
+        // join the chunks in source order
+        auto count = size_t(1);
+        for (auto& chunk : chunks)
+        {
+            if (chunk.error)
+            {
+                std::rethrow_exception(chunk.error);
+            }
+            count += chunk.tokens.getCount();
+        }
+
+        auto tokens = TokenBuffer{ m_data, size };
+        if (chunks.size() == 1)
+        {
+            tokens = std::move(chunks[0].tokens);
+        }
+        else
+        {
+            tokens.reserve(count);
+            for (auto& chunk : chunks)
+            {
+                tokens.append(chunk.tokens);
+            }
+        }
+
+        tokens.append({ TokenId::EndOfCode, SourceLocation{ uint32_t(size) }, {} });
+        return tokens;
+    }
+
+}
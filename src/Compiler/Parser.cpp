@@ -31,6 +31,7 @@
 #include "ZeeBasic/Compiler/Error.hpp"
 #include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
 #include "ZeeBasic/Compiler/Node.hpp"
+#include "ZeeBasic/Compiler/ParallelLexer.hpp"
 #include "ZeeBasic/Compiler/Program.hpp"
 #include "ZeeBasic/Compiler/StatementNode.hpp"
 
@@ -39,8 +40,13 @@ namespace ZeeBasic::Compiler
 
 	Parser::Parser(ISourceReader& source, Program& program)
 		:
+		m_source(source),
 		m_lexicalAnalyzer(source),
 		m_program(program),
+		m_tokenBuffer(),
+		m_isPreTokenized(false),
+		m_cursor(0),
+		m_produced(0),
 		m_tokens()
 	{ }
 
@@ -49,27 +55,66 @@ namespace ZeeBasic::Compiler
 
 	void Parser::run()
 	{
-		auto stm = Nodes::parseStatement(*this);
-		while (stm)
+		try
 		{
-			m_program.statements.push_back(std::move(stm));
-			stm = Nodes::parseStatement(*this);
-		}
+			if (auto data = m_source.getData(); data && m_cursor == 0 && m_produced == 0)
+			{
+				m_tokenBuffer = ParallelLexer{ data, m_source.getSize() }.run();
+				m_isPreTokenized = true;
+			}
+
+			auto stm = Nodes::parseStatement(*this);
+			while (stm)
+			{
+				m_program.statements.push_back(stm);
+				stm = Nodes::parseStatement(*this);
+			}
+
+			if (getToken().id != TokenId::EndOfCode)
+			{
+				throw Error::create(getToken().location, "Expected statement");
+			}
 
-		if (getToken().id != TokenId::EndOfCode)
+		}
+		catch (Error& error)
 		{
-			throw Error::create(getToken().range, "Expected statement");
+			// errors only carry a source location, which is turned into a line and column once for the report, if
+			// the reader can still tell
+			if (!error.isResolved())
+			{
+				if (auto range = m_source.getRange(error.getLocation()); range.startLine > 0)
+				{
+					error.resolve(range);
+				}
+			}
+			throw;
 		}
 	}
 
 	const Token& Parser::getToken(int lookAhead)
 	{
-		while (m_tokens.size() < size_t(lookAhead) + 1)
+		assert(lookAhead >= 0 && lookAhead < kMaxLookAhead);
+
+		auto index = m_cursor + size_t(lookAhead);
+		while (m_produced <= index)
 		{
-			m_tokens.push_back(m_lexicalAnalyzer.parseNextToken());
+			m_tokens[m_produced % kMaxLookAhead] = produceToken(m_produced);
+			++m_produced;
 		}
 
-		return m_tokens[lookAhead];
+		return m_tokens[index % kMaxLookAhead];
+	}
+
+	Token Parser::produceToken(size_t index)
+	{
+		if (m_isPreTokenized)
+		{
+			// the buffer ends with the end of code token, which repeats when reading past it
+			auto last = m_tokenBuffer.getCount() - 1;
+			return m_tokenBuffer.getToken(index < last ? index : last);
+		}
+
+		return m_lexicalAnalyzer.parseNextToken();
 	}
 
 	static const char* getExpectedTokenString(TokenId id)
@@ -90,7 +135,7 @@ namespace ZeeBasic::Compiler
 		auto& token = getToken();
 		if (token.id != id)
 		{
-			throw Error::create(token.range, "Expected %s", getExpectedTokenString(id));
+			throw Error::create(token.location, "Expected %s", getExpectedTokenString(id));
 		}
 
 		return token;
@@ -98,13 +143,8 @@ namespace ZeeBasic::Compiler
 
 	void Parser::eatToken()
 	{
-		if (m_tokens.size() > 1)
-		{
-			m_tokens.erase(m_tokens.begin());
-			return;
-		}
-
-		m_tokens[0] = m_lexicalAnalyzer.parseNextToken();
+		(void)getToken();
+		++m_cursor;
 	}
 
 	void Parser::eatEndOfLine()
@@ -112,7 +152,7 @@ namespace ZeeBasic::Compiler
 		auto& token = getToken();
 		if (token.id != TokenId::EndOfLine && token.id != TokenId::Sym_Colon)
 		{
-			throw Error::create(token.range, "Expected end-of-line");
+			throw Error::create(token.location, "Expected end-of-line");
 		}
 
 		eatToken();
@@ -122,4 +162,9 @@ namespace ZeeBasic::Compiler
 	{
 		return m_program.symbols;
 	}
+
+	Nodes::NodeArena& Parser::getNodeArena()
+	{
+		return m_program.nodes;
+	}
 }
@@ -0,0 +1,67 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include "ZeeBasic/Compiler/Pipeline.hpp"
+
+#include "ZeeBasic/Compiler/ConstantFolder.hpp"
+#include "ZeeBasic/Compiler/ConstantPropagation.hpp"
+#include "ZeeBasic/Compiler/DeadCodeElimination.hpp"
+#include "ZeeBasic/Compiler/IrLowering.hpp"
+#include "ZeeBasic/Compiler/Program.hpp"
+#include "ZeeBasic/Compiler/ValueNumbering.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	Pipeline::Pipeline(Program& program, uint32_t passes)
+		:
+		m_program(program),
+		m_passes(passes)
+	{ }
+
+	Pipeline::~Pipeline()
+	{ }
+
+	void Pipeline::run()
+	{
+		m_program.ast = ConstantFolder{ FlatAst::build(m_program.statements) }.run();
+		m_program.ir = IrLowering{ m_program.ast, m_program.symbols }.run();
+
+		if (m_passes & Pass_ConstantPropagation)
+		{
+			ConstantPropagation{ m_program.ir }.run();
+		}
+		if (m_passes & Pass_ValueNumbering)
+		{
+			ValueNumbering{ m_program.ir }.run();
+		}
+		if (m_passes & Pass_DeadCodeElimination)
+		{
+			DeadCodeElimination{ m_program.ir }.run();
+		}
+	}
+
+}
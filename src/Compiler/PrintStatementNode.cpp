@@ -43,7 +43,7 @@ namespace ZeeBasic::Compiler::Nodes
 	void PrintStatementNode::parse(IParser& parser)
 	{
 		auto& token = parser.expectToken(TokenId::Key_PRINT);
-		m_range = token.range;
+		m_location = token.location;
 		parser.eatToken();
 
 		m_expr = ExpressionNode::parseExpression(parser);
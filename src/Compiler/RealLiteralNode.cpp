@@ -35,7 +35,7 @@ namespace ZeeBasic::Compiler::Nodes
 	void RealLiteralNode::parse(IParser& parser)
 	{
 		auto& token = parser.expectToken(TokenId::Real);
-		m_range = token.range;
+		m_location = token.location;
 		m_value = token.text;
 		parser.eatToken();
 
@@ -0,0 +1,369 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <algorithm>
+#include <iterator>
+
+#include "ZeeBasic/Compiler/SlotAllocator.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	using Ir::Opcode;
+
+	SlotAllocator::SlotAllocator(const Ir::Function& function, const std::vector<bool>& inlined)
+		:
+		m_function(function),
+		m_inlined(inlined)
+	{ }
+
+	SlotAllocator::~SlotAllocator()
+	{ }
+
+	void SlotAllocator::run()
+	{
+		m_slots.assign(m_function.getInstructionCount(), kNone);
+		m_appends.assign(m_function.getInstructionCount(), false);
+		m_releases.clear();
+		findAnchors();
+		computeLiveness();
+
+		// each block after the blocks that dominate it, so the values live on entry already have their slots
+		auto used = std::vector<std::vector<bool>>(BaseType_Udt);
+		for (auto block : m_function.getReversePostorder())
+		{
+			assignSlots(block, used);
+		}
+	}
+
+	const std::vector<uint32_t>& SlotAllocator::getReleases(uint32_t index) const
+	{
+		static const std::vector<uint32_t> none;
+		auto found = m_releases.find(index);
+		return found == m_releases.end() ? none : found->second;
+	}
+
+	bool SlotAllocator::needsSlot(uint32_t value) const
+	{
+		const auto& instruction = m_function.getInstruction(value);
+		return instruction.type.base > BaseType_Unknown && instruction.type.base < BaseType_Udt
+			&& instruction.opcode != Opcode::Removed && !m_inlined[value];
+	}
+
+	uint32_t SlotAllocator::findAppendedPart(uint32_t value) const
+	{
+		auto isConcatenation = [&](uint32_t index) {
+			const auto& instruction = m_function.getInstruction(index);
+			return instruction.opcode == Opcode::Binary && instruction.type.base == BaseType_String;
+		};
+		if (!isConcatenation(value))
+		{
+			return kNone;
+		}
+
+		// the first part of the chain, which must not be read again once the others are appended to it
+		auto first = m_function.getOperand(value, 0);
+		while (m_inlined[first] && isConcatenation(first))
+		{
+			first = m_function.getOperand(first, 0);
+		}
+
+		auto uses = 0;
+		auto pending = std::vector<uint32_t>{ value };
+		while (!pending.empty())
+		{
+			auto index = pending.back();
+			pending.pop_back();
+			for (uint32_t operand = 0; operand < 2; ++operand)
+			{
+				auto part = m_function.getOperand(index, operand);
+				if (m_inlined[part] && isConcatenation(part))
+				{
+					pending.push_back(part);
+				}
+				else
+				{
+					uses += part == first;
+				}
+			}
+		}
+
+		return uses == 1 && needsSlot(first) ? first : kNone;
+	}
+
+	void SlotAllocator::findAnchors()
+	{
+		m_anchors.resize(m_function.getInstructionCount());
+		for (uint32_t index = 0; index < m_anchors.size(); ++index)
+		{
+			m_anchors[index] = index;
+		}
+
+		// an inlined value comes before its only user in the same block, so walking backwards settles the user first
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			const auto& instructions = m_function.getBlock(block).instructions;
+			for (auto it = instructions.rbegin(); it != instructions.rend(); ++it)
+			{
+				const auto& instruction = m_function.getInstruction(*it);
+				for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
+				{
+					auto value = m_function.getOperand(*it, operand);
+					if (m_inlined[value] && m_function.getInstruction(value).opcode != Opcode::Constant)
+					{
+						m_anchors[value] = m_anchors[*it];
+					}
+				}
+			}
+		}
+	}
+
+	void SlotAllocator::computeLiveness()
+	{
+		auto blockCount = m_function.getBlockCount();
+		m_liveIn.assign(blockCount, {});
+		m_liveOut.assign(blockCount, {});
+
+		// values each block uses that are defined elsewhere, and the phi operands each block passes to its successors
+		auto used = std::vector<std::vector<uint32_t>>(blockCount);
+		auto passed = std::vector<std::vector<uint32_t>>(blockCount);
+		for (uint32_t block = 0; block < blockCount; ++block)
+		{
+			const auto& predecessors = m_function.getBlock(block).predecessors;
+			for (auto index : m_function.getBlock(block).instructions)
+			{
+				// a release writes nothing, as a string stays in its slot until the slot is reused
+				const auto& instruction = m_function.getInstruction(index);
+				if (instruction.opcode == Opcode::StringRelease)
+				{
+					continue;
+				}
+
+				for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
+				{
+					auto value = m_function.getOperand(index, operand);
+					if (!needsSlot(value))
+					{
+						continue;
+					}
+
+					if (instruction.opcode == Opcode::Phi)
+					{
+						passed[predecessors[operand]].push_back(value);
+					}
+					else if (m_function.getInstruction(value).block != block)
+					{
+						used[block].push_back(value);
+					}
+				}
+			}
+		}
+
+		for (uint32_t block = 0; block < blockCount; ++block)
+		{
+			std::sort(used[block].begin(), used[block].end());
+			used[block].erase(std::unique(used[block].begin(), used[block].end()), used[block].end());
+			std::sort(passed[block].begin(), passed[block].end());
+			passed[block].erase(std::unique(passed[block].begin(), passed[block].end()), passed[block].end());
+		}
+
+		// successors before predecessors where there are no loops, so this settles in a pass or two
+		auto order = m_function.getReversePostorder();
+		auto changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (auto it = order.rbegin(); it != order.rend(); ++it)
+			{
+				auto block = *it;
+
+				auto liveOut = passed[block];
+				for (auto successor : m_function.getBlock(block).successors)
+				{
+					auto merged = std::vector<uint32_t>{};
+					std::set_union(liveOut.begin(), liveOut.end(), m_liveIn[successor].begin(), m_liveIn[successor].end(), std::back_inserter(merged));
+					liveOut = std::move(merged);
+				}
+
+				auto liveIn = std::vector<uint32_t>{};
+				for (auto value : liveOut)
+				{
+					if (m_function.getInstruction(value).block != block)
+					{
+						liveIn.push_back(value);
+					}
+				}
+				auto merged = std::vector<uint32_t>{};
+				std::set_union(liveIn.begin(), liveIn.end(), used[block].begin(), used[block].end(), std::back_inserter(merged));
+
+				if (merged != m_liveIn[block] || liveOut != m_liveOut[block])
+				{
+					m_liveIn[block] = std::move(merged);
+					m_liveOut[block] = std::move(liveOut);
+					changed = true;
+				}
+			}
+		}
+	}
+
+	void SlotAllocator::assignSlots(uint32_t block, std::vector<std::vector<bool>>& used)
+	{
+		for (auto& slots : used)
+		{
+			slots.assign(slots.size(), false);
+		}
+
+		auto allocate = [&](uint32_t value) {
+			auto base = m_function.getInstruction(value).type.base;
+			auto& slots = used[base];
+			auto slot = uint32_t(std::find(slots.begin(), slots.end(), false) - slots.begin());
+			if (slot == slots.size())
+			{
+				slots.push_back(false);
+				m_slotCounts[base] = uint32_t(slots.size());
+			}
+			slots[slot] = true;
+			m_slots[value] = slot;
+		};
+		auto release = [&](uint32_t value) {
+			used[m_function.getInstruction(value).type.base][m_slots[value]] = false;
+		};
+
+		for (auto value : m_liveIn[block])
+		{
+			used[m_function.getInstruction(value).type.base][m_slots[value]] = true;
+		}
+
+		// where in the block each value is last used; values still live on exit are never released here
+		const auto& instructions = m_function.getBlock(block).instructions;
+		const auto& liveOut = m_liveOut[block];
+		auto positions = std::unordered_map<uint32_t, uint32_t>{};
+		for (uint32_t position = 0; position < instructions.size(); ++position)
+		{
+			positions[instructions[position]] = position;
+		}
+
+		auto lastUses = std::unordered_map<uint32_t, uint32_t>{};
+		for (auto index : instructions)
+		{
+			const auto& instruction = m_function.getInstruction(index);
+			if (instruction.opcode == Opcode::Phi || instruction.opcode == Opcode::StringRelease)
+			{
+				continue;
+			}
+
+			auto position = positions[m_anchors[index]];
+			for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
+			{
+				auto value = m_function.getOperand(index, operand);
+				if (needsSlot(value) && !std::binary_search(liveOut.begin(), liveOut.end(), value))
+				{
+					auto& last = lastUses[value];
+					last = std::max(last, position);
+				}
+			}
+		}
+
+		auto dying = std::vector<std::vector<uint32_t>>(instructions.size());
+		for (const auto& lastUse : lastUses)
+		{
+			dying[lastUse.second].push_back(lastUse.first);
+		}
+
+		auto isDead = [&](uint32_t value) {
+			return lastUses.find(value) == lastUses.end() && !std::binary_search(liveOut.begin(), liveOut.end(), value);
+		};
+
+		// phis all take their values on entry, together
+		for (auto index : instructions)
+		{
+			if (m_function.getInstruction(index).opcode == Opcode::Phi && needsSlot(index))
+			{
+				allocate(index);
+			}
+		}
+		for (auto index : instructions)
+		{
+			if (m_function.getInstruction(index).opcode == Opcode::Phi && needsSlot(index) && isDead(index))
+			{
+				release(index);
+			}
+		}
+
+		for (uint32_t position = 0; position < instructions.size(); ++position)
+		{
+			auto index = instructions[position];
+			if (m_function.getInstruction(index).opcode == Opcode::Phi)
+			{
+				continue;
+			}
+
+			// a scalar may take over the slot of an operand used for the last time, a string only by appending to it
+			for (auto value : dying[position])
+			{
+				if (m_function.getInstruction(value).type.base != BaseType_String)
+				{
+					release(value);
+				}
+			}
+
+			auto appended = kNone;
+			if (needsSlot(index))
+			{
+				appended = findAppendedPart(index);
+				if (appended != kNone && std::find(dying[position].begin(), dying[position].end(), appended) != dying[position].end())
+				{
+					m_slots[index] = m_slots[appended];
+					m_appends[index] = true;
+				}
+				else
+				{
+					appended = kNone;
+					allocate(index);
+				}
+
+				if (isDead(index))
+				{
+					release(index);
+					if (m_function.getInstruction(index).type.base == BaseType_String)
+					{
+						m_releases[index].push_back(index);
+					}
+				}
+			}
+
+			for (auto value : dying[position])
+			{
+				if (m_function.getInstruction(value).type.base == BaseType_String && value != appended)
+				{
+					release(value);
+					m_releases[index].push_back(value);
+				}
+			}
+		}
+	}
+
+}
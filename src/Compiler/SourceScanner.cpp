@@ -0,0 +1,271 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ZEEBASIC_SCAN_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#include "ZeeBasic/Compiler/SourceScanner.hpp"
+
+#if defined(ZEEBASIC_SCAN_X86) && defined(__GNUC__)
+#define ZEEBASIC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ZEEBASIC_TARGET_AVX2
+#endif
+
+namespace ZeeBasic::Compiler
+{
+
+    //
+    // Scalar
+    //
+
+    static const char* skipBlanksScalar(const char* cursor, const char* end)
+    {
+        while (cursor != end && (*cursor == ' ' || *cursor == '\t'))
+        {
+            ++cursor;
+        }
+        return cursor;
+    }
+
+    static const char* findLineEndScalar(const char* cursor, const char* end)
+    {
+        while (cursor != end && *cursor != '\n' && *cursor != 0)
+        {
+            ++cursor;
+        }
+        return cursor;
+    }
+
+    static const char* findStringEndScalar(const char* cursor, const char* end)
+    {
+        while (cursor != end && *cursor != '"' && *cursor != '\n' && *cursor != 0)
+        {
+            ++cursor;
+        }
+        return cursor;
+    }
+
+#ifdef ZEEBASIC_SCAN_X86
+
+    static int countTrailingZeros(uint32_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return int(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    //
+    // SSE2 (always available on x86-64), 16 characters per block
+    //
+
+    static const char* skipBlanksSse2(const char* cursor, const char* end)
+    {
+        const auto space = _mm_set1_epi8(' ');
+        const auto tab = _mm_set1_epi8('\t');
+        while (end - cursor >= 16)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+            auto blanks = _mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab));
+            auto mask = ~uint32_t(_mm_movemask_epi8(blanks)) & 0xFFFF;
+            if (mask)
+            {
+                return cursor + countTrailingZeros(mask);
+            }
+            cursor += 16;
+        }
+        return skipBlanksScalar(cursor, end);
+    }
+
+    static const char* findLineEndSse2(const char* cursor, const char* end)
+    {
+        const auto newline = _mm_set1_epi8('\n');
+        const auto zero = _mm_setzero_si128();
+        while (end - cursor >= 16)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+            auto stops = _mm_or_si128(_mm_cmpeq_epi8(block, newline), _mm_cmpeq_epi8(block, zero));
+            auto mask = uint32_t(_mm_movemask_epi8(stops));
+            if (mask)
+            {
+                return cursor + countTrailingZeros(mask);
+            }
+            cursor += 16;
+        }
+        return findLineEndScalar(cursor, end);
+    }
+
+    static const char* findStringEndSse2(const char* cursor, const char* end)
+    {
+        const auto quote = _mm_set1_epi8('"');
+        const auto newline = _mm_set1_epi8('\n');
+        const auto zero = _mm_setzero_si128();
+        while (end - cursor >= 16)
+        {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+            auto stops = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, newline)),
+                _mm_cmpeq_epi8(block, zero));
+            auto mask = uint32_t(_mm_movemask_epi8(stops));
+            if (mask)
+            {
+                return cursor + countTrailingZeros(mask);
+            }
+            cursor += 16;
+        }
+        return findStringEndScalar(cursor, end);
+    }
+
+    //
+    // AVX2, 32 characters per block with the SSE2 routines finishing any remainder
+    //
+
+    ZEEBASIC_TARGET_AVX2 static const char* skipBlanksAvx2(const char* cursor, const char* end)
+    {
+        const auto space = _mm256_set1_epi8(' ');
+        const auto tab = _mm256_set1_epi8('\t');
+        while (end - cursor >= 32)
+        {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cursor));
+            auto blanks = _mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, tab));
+            auto mask = ~uint32_t(_mm256_movemask_epi8(blanks));
+            if (mask)
+            {
+                return cursor + countTrailingZeros(mask);
+            }
+            cursor += 32;
+        }
+        return skipBlanksSse2(cursor, end);
+    }
+
+    ZEEBASIC_TARGET_AVX2 static const char* findLineEndAvx2(const char* cursor, const char* end)
+    {
+        const auto newline = _mm256_set1_epi8('\n');
+        const auto zero = _mm256_setzero_si256();
+        while (end - cursor >= 32)
+        {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cursor));
+            auto stops = _mm256_or_si256(_mm256_cmpeq_epi8(block, newline), _mm256_cmpeq_epi8(block, zero));
+            auto mask = uint32_t(_mm256_movemask_epi8(stops));
+            if (mask)
+            {
+                return cursor + countTrailingZeros(mask);
+            }
+            cursor += 32;
+        }
+        return findLineEndSse2(cursor, end);
+    }
+
+    ZEEBASIC_TARGET_AVX2 static const char* findStringEndAvx2(const char* cursor, const char* end)
+    {
+        const auto quote = _mm256_set1_epi8('"');
+        const auto newline = _mm256_set1_epi8('\n');
+        const auto zero = _mm256_setzero_si256();
+        while (end - cursor >= 32)
+        {
+            auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cursor));
+            auto stops = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(block, quote), _mm256_cmpeq_epi8(block, newline)),
+                _mm256_cmpeq_epi8(block, zero));
+            auto mask = uint32_t(_mm256_movemask_epi8(stops));
+            if (mask)
+            {
+                return cursor + countTrailingZeros(mask);
+            }
+            cursor += 32;
+        }
+        return findStringEndSse2(cursor, end);
+    }
+
+    static bool isAvx2Supported()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+
+        // AVX2 also needs the operating system to save the upper halves of the ymm registers
+        __cpuid(info, 1);
+        auto osxsave = (info[2] & (1 << 27)) != 0;
+        auto avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+        {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif
+
+    static const SourceScanner kScanners[] = {
+        { ScanLevel::Scalar, skipBlanksScalar, findLineEndScalar, findStringEndScalar },
+#ifdef ZEEBASIC_SCAN_X86
+        { ScanLevel::SSE2, skipBlanksSse2, findLineEndSse2, findStringEndSse2 },
+        { ScanLevel::AVX2, skipBlanksAvx2, findLineEndAvx2, findStringEndAvx2 },
+#endif
+    };
+
+    ScanLevel SourceScanner::getBestLevel()
+    {
+#ifdef ZEEBASIC_SCAN_X86
+        static const auto level = isAvx2Supported() ? ScanLevel::AVX2 : ScanLevel::SSE2;
+        return level;
+#else
+        return ScanLevel::Scalar;
+#endif
+    }
+
+    const SourceScanner& SourceScanner::get()
+    {
+        return get(getBestLevel());
+    }
+
+    const SourceScanner& SourceScanner::get(ScanLevel level)
+    {
+        auto best = getBestLevel();
+        return kScanners[int(level < best ? level : best)];
+    }
+
+}
@@ -30,31 +30,33 @@
 
 #include "ZeeBasic/Compiler/AssignmentStatementNode.hpp"
 #include "ZeeBasic/Compiler/IParser.hpp"
+#include "ZeeBasic/Compiler/NodeArena.hpp"
 #include "ZeeBasic/Compiler/PrintStatementNode.hpp"
 
 namespace ZeeBasic::Compiler::Nodes
 {
 
-	std::unique_ptr<Node> parseStatement(IParser& parser)
+	Node* parseStatement(IParser& parser)
 	{
 		auto& token = parser.getToken();
 
-		auto node = std::unique_ptr<Node>{};
+		Node* node = nullptr;
 		switch (token.id)
 		{
 
+		case TokenId::Key_CONST:
 		case TokenId::UntypedName:
 		case TokenId::TypedName:
 			// TODO : check for user function call
-			node = std::make_unique<AssignmentStatementNode>();
+			node = parser.getNodeArena().create<AssignmentStatementNode>();
 			break;
 
 		case TokenId::Key_PRINT:
-			node = std::make_unique<PrintStatementNode>();
+			node = parser.getNodeArena().create<PrintStatementNode>();
 			break;
 
 		default:
-			return {};
+			return nullptr;
 
 		}
 
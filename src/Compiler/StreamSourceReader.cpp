@@ -0,0 +1,152 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ZeeBasic/Compiler/StreamSourceReader.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    StreamSourceReader::StreamSourceReader(int fd, size_t chunkSize)
+        :
+        m_fd(fd),
+        m_chunkSize(std::max(chunkSize, size_t(1))),
+        m_chunks(),
+        m_current(0),
+        m_isEnd(false),
+        m_cursor(nullptr),
+        m_end(nullptr)
+    {
+        for (auto& chunk : m_chunks)
+        {
+            chunk = { std::make_unique<char[]>(m_chunkSize), 0, 0, 1, 1 };
+        }
+    }
+
+    StreamSourceReader::~StreamSourceReader()
+    { }
+
+    char StreamSourceReader::readNextChar()
+    {
+        if (m_cursor == m_end && !refill())
+        {
+            return 0;
+        }
+
+        return *m_cursor++;
+    }
+
+    bool StreamSourceReader::refill()
+    {
+        if (m_isEnd)
+        {
+            return false;
+        }
+
+        auto& current = m_chunks[m_current];
+        auto& next = m_chunks[1 - m_current];
+
+#ifdef _WIN32
+        auto count = _read(m_fd, next.data.get(), unsigned(std::min(m_chunkSize, size_t(INT32_MAX))));
+#else
+        auto count = read(m_fd, next.data.get(), m_chunkSize);
+        while (count < 0 && errno == EINTR)
+        {
+            count = read(m_fd, next.data.get(), m_chunkSize);
+        }
+#endif
+        if (count < 0)
+        {
+            throw std::runtime_error("Failed to read source stream");
+        }
+
+        if (count == 0)
+        {
+            m_isEnd = true;
+            return false;
+        }
+
+        // the next chunk starts where the current one ends, which is found once per chunk rather than by counting
+        // every character as it is read
+        auto begin = current.data.get();
+        auto end = begin + current.size;
+        auto newlines = int(std::count(begin, end, '\n'));
+        next.offset = current.offset + current.size;
+        next.lineNo = current.lineNo + newlines;
+        if (newlines > 0)
+        {
+            auto lastNewline = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(begin), '\n');
+            next.colNo = int(lastNewline - std::make_reverse_iterator(end)) + 1;
+        }
+        else
+        {
+            next.colNo = current.colNo + int(current.size);
+        }
+        next.size = size_t(count);
+
+        m_current = 1 - m_current;
+        m_cursor = next.data.get();
+        m_end = m_cursor + next.size;
+        return true;
+    }
+
+    Range StreamSourceReader::getRange(SourceLocation location) const
+    {
+        for (auto& chunk : m_chunks)
+        {
+            // locations are 32-bit, so compare them with the low bits of the stream offset of the chunk
+            auto index = size_t(uint32_t(location.offset - uint32_t(chunk.offset)));
+            if (chunk.size == 0 || index > chunk.size || (index == chunk.size && &chunk != &m_chunks[m_current]))
+            {
+                continue;
+            }
+
+            auto begin = chunk.data.get();
+            auto end = begin + index;
+            auto newlines = int(std::count(begin, end, '\n'));
+            if (newlines == 0)
+            {
+                return { chunk.lineNo, chunk.colNo + int(index) };
+            }
+
+            auto lastNewline = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(begin), '\n');
+            return { chunk.lineNo + newlines, int(lastNewline - std::make_reverse_iterator(end)) + 1 };
+        }
+
+        return {};
+    }
+
+}
@@ -44,7 +44,7 @@ namespace ZeeBasic::Compiler::Nodes
 	void StringLiteralNode::parse(IParser& parser)
 	{
 		auto& token = parser.expectToken(TokenId::String);
-		m_range = token.range;
+		m_location = token.location;
 		m_value = token.text;
 		parser.eatToken();
 
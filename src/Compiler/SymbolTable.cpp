@@ -24,38 +24,97 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
+#include <cassert>
+
 #include "ZeeBasic/Compiler/SymbolTable.hpp"
 
 namespace ZeeBasic::Compiler
 {
 
+	SymbolTable::SymbolTable()
+		:
+		m_symbols(),
+		m_identifiers(),
+		m_visible(),
+		m_hidden(),
+		m_scopes()
+	{ }
+
+	SymbolTable::~SymbolTable()
+	{ }
+
 	Symbol* SymbolTable::findSymbol(const ConstString& name) const
 	{
-		for (auto& symbol : m_symbols)
+		auto identifier = m_identifiers.find(name);
+		if (identifier < 0 || identifier >= int(m_visible.size()))
+		{
+			return nullptr;
+		}
+
+		return m_visible[identifier];
+	}
+
+	Symbol* SymbolTable::findOrCreateSymbol(const ConstString& name, SourceLocation location, const Type& type)
+	{
+		auto identifier = m_identifiers.intern(name);
+		if (identifier < int(m_visible.size()) && m_visible[identifier])
+		{
+			return m_visible[identifier];
+		}
+
+		return declare(identifier, location, type);
+	}
+
+	Symbol* SymbolTable::createSymbol(const ConstString& name, SourceLocation location, const Type& type)
+	{
+		auto identifier = m_identifiers.intern(name);
+		if (identifier < int(m_visible.size()) && m_visible[identifier] && m_visible[identifier]->scope == getScope())
 		{
-			if (symbol->name == name)
-			{
-				return symbol.get();
-			}
+			return nullptr;
 		}
 
-		return nullptr;
+		return declare(identifier, location, type);
 	}
 
-	Symbol* SymbolTable::findOrCreateSymbol(const ConstString& name, const Range& range, const Type& type)
+	Symbol* SymbolTable::declare(int identifier, SourceLocation location, const Type& type)
 	{
-		for (auto& symbol : m_symbols)
+		if (identifier >= int(m_visible.size()))
+		{
+			m_visible.resize(size_t(identifier) + 1, nullptr);
+		}
+
+		// program level symbols never need restoring, as that scope never exits
+		if (!m_scopes.empty())
 		{
-			if (symbol->name == name)
-			{
-				return symbol.get();
-			}
+			m_hidden.push_back({ identifier, m_visible[identifier] });
 		}
 
-		auto symbol = std::make_unique<Symbol>(int(m_symbols.size()), name, range, type);
+		auto symbol = std::make_unique<Symbol>(int(m_symbols.size()), identifier, getScope(), m_identifiers.getName(identifier), location, type);
 		auto ptr = symbol.get();
 		m_symbols.emplace_back(std::move(symbol));
+		m_visible[identifier] = ptr;
 		return ptr;
 	}
 
+	void SymbolTable::enterScope()
+	{
+		m_scopes.push_back(m_hidden.size());
+	}
+
+	void SymbolTable::exitScope()
+	{
+		assert(!m_scopes.empty());
+
+		// undo the declarations made in this scope, newest first
+		auto begin = m_scopes.back();
+		for (auto i = m_hidden.size(); i > begin; --i)
+		{
+			auto& hidden = m_hidden[i - 1];
+			m_visible[hidden.identifier] = hidden.symbol;
+		}
+
+		m_hidden.resize(begin);
+		m_scopes.pop_back();
+	}
+
 }
@@ -0,0 +1,99 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <cassert>
+#include <stdexcept>
+
+#include "ZeeBasic/Compiler/TokenBuffer.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+    static_assert(int(TokenId::Sym_Period) < 256, "token ids must fit in a byte");
+
+    TokenBuffer::TokenBuffer()
+        :
+        m_source(nullptr),
+        m_ids(),
+        m_locations(),
+        m_lengths()
+    { }
+
+    TokenBuffer::TokenBuffer(const char* source, size_t size)
+        :
+        m_source(source),
+        m_ids(),
+        m_locations(),
+        m_lengths()
+    {
+        if (uint64_t(size) > UINT32_MAX)
+        {
+            throw std::runtime_error("Source is too large to tokenize");
+        }
+    }
+
+    TokenBuffer::~TokenBuffer()
+    { }
+
+    void TokenBuffer::reserve(size_t count)
+    {
+        m_ids.reserve(count);
+        m_locations.reserve(count);
+        m_lengths.reserve(count);
+    }
+
+    void TokenBuffer::append(const Token& token)
+    {
+        auto length = token.text.getLength();
+        m_ids.push_back(uint8_t(token.id));
+        m_locations.push_back(token.location.offset);
+        m_lengths.push_back(uint32_t(length));
+
+        assert(length == 0 || getText(getCount() - 1).getText() == token.text.getText());
+    }
+
+    void TokenBuffer::append(const TokenBuffer& other)
+    {
+        assert(other.m_source == m_source || other.getCount() == 0);
+
+        m_ids.insert(m_ids.end(), other.m_ids.begin(), other.m_ids.end());
+        m_locations.insert(m_locations.end(), other.m_locations.begin(), other.m_locations.end());
+        m_lengths.insert(m_lengths.end(), other.m_lengths.begin(), other.m_lengths.end());
+    }
+
+    ConstString TokenBuffer::getText(size_t index) const
+    {
+        // string literals start with the quote that their text excludes
+        auto offset = m_locations[index] + (getId(index) == TokenId::String ? 1 : 0);
+        return ConstString::view(m_source + offset, int(m_lengths[index]));
+    }
+
+    Token TokenBuffer::getToken(size_t index) const
+    {
+        return { getId(index), getLocation(index), getText(index) };
+    }
+
+}
@@ -45,14 +45,14 @@ namespace ZeeBasic::Compiler::Nodes
 		{
 			m_op = Operator::BitwiseNot;
 		}
-		m_range = token.range;
+		m_location = token.location;
 
 		parser.eatToken();
 
 		m_expr = ExpressionNode::parseExpression(parser, 10);
 		if (!m_expr)
 		{
-			throw Error::create(parser.getToken().range, "Expected expression after unary operator");
+			throw Error::create(parser.getToken().location, "Expected expression after unary operator");
 		}
 
 		switch (m_expr->getType().base)
@@ -61,7 +61,7 @@ namespace ZeeBasic::Compiler::Nodes
 		case BaseType_Boolean:
 			if (m_op == Operator::Negate)
 			{
-				throw Error::create(m_range, "Operator not allowed for boolean type.");
+				throw Error::create(m_location, "Operator not allowed for boolean type.");
 			}
 			break;
 
@@ -72,12 +72,12 @@ namespace ZeeBasic::Compiler::Nodes
 		case BaseType_Real:
 			if (m_op == Operator::BitwiseNot)
 			{
-				throw Error::create(m_range, "Operator not allowed for real type.");
+				throw Error::create(m_location, "Operator not allowed for real type.");
 			}
 			break;
 
 		case BaseType_String:
-			throw Error::create(m_range, "Operator not allowed for string type.");
+			throw Error::create(m_location, "Operator not allowed for string type.");
 
 		default:
 			assert(false);
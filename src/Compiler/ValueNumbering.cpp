@@ -0,0 +1,263 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <utility>
+
+#include "ZeeBasic/Compiler/ValueNumbering.hpp"
+
+namespace ZeeBasic::Compiler
+{
+
+	using Ir::Opcode;
+	using BinaryOperator = Nodes::BinaryExpressionNode::Operator;
+
+	static bool isCommutative(BinaryOperator op)
+	{
+		switch (op)
+		{
+		case BinaryOperator::Add:
+		case BinaryOperator::Multiply:
+		case BinaryOperator::Equals:
+		case BinaryOperator::NotEquals:
+		case BinaryOperator::BitwiseAnd:
+		case BinaryOperator::BitwiseOr:
+		case BinaryOperator::BitwiseXor:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	template<typename T>
+	static void appendKey(std::string& key, const T& value)
+	{
+		key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	ValueNumbering::ValueNumbering(Ir::Function& function)
+		:
+		m_function(function)
+	{ }
+
+	ValueNumbering::~ValueNumbering()
+	{ }
+
+	void ValueNumbering::run()
+	{
+		auto instructionCount = uint32_t(m_function.getInstructionCount());
+		m_leaders.resize(instructionCount);
+		m_removed.assign(instructionCount, false);
+		m_releases.assign(instructionCount, {});
+		m_positions.assign(instructionCount, 0);
+		for (uint32_t index = 0; index < instructionCount; ++index)
+		{
+			m_leaders[index] = index;
+			if (m_function.getInstruction(index).opcode == Opcode::StringRelease)
+			{
+				m_releases[m_function.getOperand(index, 0)].push_back(index);
+			}
+		}
+
+		auto dominators = m_function.getImmediateDominators();
+		auto children = std::vector<std::vector<uint32_t>>(m_function.getBlockCount());
+		for (uint32_t block = 0; block < m_function.getBlockCount(); ++block)
+		{
+			const auto& instructions = m_function.getBlock(block).instructions;
+			for (uint32_t position = 0; position < instructions.size(); ++position)
+			{
+				m_positions[instructions[position]] = position;
+			}
+
+			if (block != 0 && dominators[block] != Ir::Function::kNone)
+			{
+				children[dominators[block]].push_back(block);
+			}
+		}
+
+		// walk the dominator tree, so the values available in a block are those of the blocks that dominate it
+		struct Scope
+		{
+			uint32_t block;
+			size_t child;
+			size_t added;
+		};
+		auto scopes = std::vector<Scope>{ { 0, 0, 0 } };
+		number(0);
+		while (!scopes.empty())
+		{
+			auto& scope = scopes.back();
+			if (scope.child < children[scope.block].size())
+			{
+				auto child = children[scope.block][scope.child++];
+				scopes.push_back({ child, 0, m_added.size() });
+				number(child);
+				continue;
+			}
+
+			while (m_added.size() > scope.added)
+			{
+				m_available.erase(m_added.back());
+				m_added.pop_back();
+			}
+			scopes.pop_back();
+		}
+
+		for (uint32_t index = 0; index < instructionCount; ++index)
+		{
+			const auto& instruction = m_function.getInstruction(index);
+			for (uint32_t operand = 0; !m_removed[index] && operand < instruction.operandCount; ++operand)
+			{
+				m_function.setOperand(index, operand, m_leaders[m_function.getOperand(index, operand)]);
+			}
+		}
+		m_function.remove(m_removed);
+	}
+
+	void ValueNumbering::number(uint32_t block)
+	{
+		auto key = std::string{};
+		for (auto index : m_function.getBlock(block).instructions)
+		{
+			if (m_removed[index] || !getKey(index, key))
+			{
+				continue;
+			}
+
+			auto found = m_available.find(key);
+			if (found == m_available.end())
+			{
+				m_available.emplace(key, index);
+				m_added.push_back(key);
+				continue;
+			}
+
+			auto earlier = found->second;
+			if (m_function.getInstruction(index).type.base != BaseType_String || reuseString(earlier, index))
+			{
+				m_leaders[index] = earlier;
+				m_removed[index] = true;
+			}
+		}
+	}
+
+	bool ValueNumbering::getKey(uint32_t index, std::string& key) const
+	{
+		const auto& instruction = m_function.getInstruction(index);
+		switch (instruction.opcode)
+		{
+
+		case Opcode::Call:
+			if (!m_function.getFunction(index).isPure)
+			{
+				return false;
+			}
+			break;
+
+		case Opcode::Constant:
+		case Opcode::StringLiteral:
+		case Opcode::StringEmpty:
+		case Opcode::StringCopy:
+		case Opcode::Unary:
+		case Opcode::Binary:
+		case Opcode::Cast:
+			break;
+
+		default:
+			return false;
+
+		}
+
+		key.clear();
+		appendKey(key, instruction.opcode);
+		appendKey(key, instruction.op);
+		appendKey(key, instruction.type.base);
+
+		// calls have the most operands of anything numbered
+		uint32_t operands[Builtin::kMaxArguments];
+		for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
+		{
+			operands[operand] = m_leaders[m_function.getOperand(index, operand)];
+		}
+		if (instruction.opcode == Opcode::Binary && instruction.type.base != BaseType_String
+			&& isCommutative(m_function.getBinaryOperator(index)) && operands[0] > operands[1])
+		{
+			std::swap(operands[0], operands[1]);
+		}
+		for (uint32_t operand = 0; operand < instruction.operandCount; ++operand)
+		{
+			appendKey(key, operands[operand]);
+		}
+
+		if (instruction.opcode == Opcode::StringLiteral || (instruction.opcode == Opcode::Constant && instruction.type.base == BaseType_Real))
+		{
+			const auto& text = m_function.getText(index);
+			key.append(text.getText(), size_t(text.getLength()));
+		}
+		else if (instruction.opcode == Opcode::Constant)
+		{
+			appendKey(key, m_function.getInteger(index));
+		}
+		return true;
+	}
+
+	bool ValueNumbering::reuseString(uint32_t earlier, uint32_t later)
+	{
+		auto block = m_function.getInstruction(later).block;
+		auto& releases = m_releases[earlier];
+		if (releases.size() != 1 || m_function.getInstruction(releases[0]).block != block)
+		{
+			return false;
+		}
+
+		// released before the later string is made: keep it alive instead, and release it where the later one was
+		auto release = releases[0];
+		if (m_positions[release] < m_positions[later])
+		{
+			m_removed[release] = true;
+			releases = m_releases[later];
+			return true;
+		}
+
+		// both alive at once: release it once, when the last of the two is done
+		const auto& laterReleases = m_releases[later];
+		if (laterReleases.size() != 1 || m_function.getInstruction(laterReleases[0]).block != block)
+		{
+			return false;
+		}
+
+		if (m_positions[laterReleases[0]] < m_positions[release])
+		{
+			m_removed[laterReleases[0]] = true;
+		}
+		else
+		{
+			m_removed[release] = true;
+			releases = laterReleases;
+		}
+		return true;
+	}
+
+}
@@ -26,102 +26,569 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
  */
 
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <ctype.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <conio.h>
+#else
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
 
 #include "ZeeBasic/Runtime/ZeeRuntime.h"
 
+static int zrt_argc = 0;
+static char** zrt_argv = NULL;
+
 void zrt_init(int argc, char* argv[])
 {
-	/* TODO */
+	zrt_argc = argc;
+	zrt_argv = argv;
 }
 
-zrt_String* zrt_str_empty()
+/* a string keeps its text in its own small buffer while the text fits, and otherwise in a heap buffer that starts with
+   a count of the strings sharing it; a shared buffer is never written, but copied before a write */
+static int zrt_str_is_heap(zrt_String* str)
 {
-	zrt_String* str = malloc(sizeof(zrt_String));
-	if (!str) abort();
+	return str->data != str->small && str->capacity != ZRT_STR_IMMORTAL;
+}
 
-	str->capacity = 16;
-	str->length = 0;
-	str->data = malloc(sizeof(char) * str->capacity);
-	if (!str->data) abort();
-	
-	return str;
+static zrt_Int* zrt_str_refs(zrt_String* str)
+{
+	return (zrt_Int*)str->data - 1;
 }
 
-zrt_String* zrt_str_new(const char* text)
+static int zrt_str_is_shared(zrt_String* str)
 {
-	zrt_String* str = malloc(sizeof(zrt_String));
-	if (!str) abort();
+	return zrt_str_is_heap(str) && *zrt_str_refs(str) > 1;
+}
 
-	zrt_Int cap = 16;
-	zrt_Int len = strlen(text);
+/* text that is not the string's own to write, being shared or static, so the string detaches before a write */
+static int zrt_str_is_borrowed(zrt_String* str)
+{
+	return str->capacity == ZRT_STR_IMMORTAL || zrt_str_is_shared(str);
+}
+
+static char* zrt_str_alloc_data(zrt_Int cap)
+{
+	zrt_Int* refs = malloc(sizeof(zrt_Int) + sizeof(char) * cap);
+	if (!refs) abort();
+
+	*refs = 1;
+	return (char*)(refs + 1);
+}
+
+static void zrt_str_free_data(zrt_String* str)
+{
+	if (zrt_str_is_heap(str) && --*zrt_str_refs(str) == 0)
+	{
+		free(zrt_str_refs(str));
+	}
+}
+
+static zrt_Int zrt_str_capacity_for(zrt_Int cap, zrt_Int len)
+{
+	if (cap < ZRT_STR_SMALL)
+	{
+		cap = ZRT_STR_SMALL;
+	}
 	while (cap < len)
 	{
 		cap *= 2;
 	}
+	return cap;
+}
+
+/* room to write len characters, without keeping the text */
+static void zrt_str_reserve(zrt_String* str, zrt_Int len)
+{
+	if (str->capacity < len || zrt_str_is_borrowed(str))
+	{
+		zrt_Int cap = zrt_str_capacity_for(ZRT_STR_SMALL, len);
+		zrt_str_free_data(str);
+		str->capacity = cap;
+		str->data = cap == ZRT_STR_SMALL ? str->small : zrt_str_alloc_data(cap);
+	}
+}
+
+/* room to write len characters, keeping the text; capacity doubles, so a run of appends copies each character a
+   constant number of times */
+static void zrt_str_grow(zrt_String* str, zrt_Int len)
+{
+	if (str->capacity < len || zrt_str_is_borrowed(str))
+	{
+		zrt_Int cap = zrt_str_capacity_for(str->capacity, len);
+		if (cap == ZRT_STR_SMALL)
+		{
+			/* only static text can be short enough to fit without already being there */
+			memcpy(str->small, str->data, str->length);
+			str->data = str->small;
+		}
+		else if (str->data == str->small || zrt_str_is_borrowed(str))
+		{
+			char* data = zrt_str_alloc_data(cap);
+			memcpy(data, str->data, str->length);
+			zrt_str_free_data(str);
+			str->data = data;
+		}
+		else
+		{
+			zrt_Int* refs = realloc(zrt_str_refs(str), sizeof(zrt_Int) + sizeof(char) * cap);
+			if (!refs) abort();
+			str->data = (char*)(refs + 1);
+		}
+		str->capacity = cap;
+	}
+}
 
-	str->capacity = cap;
+static zrt_String* zrt_str_alloc(zrt_Int len)
+{
+	zrt_String* str = malloc(sizeof(zrt_String));
+	if (!str) abort();
+
+	zrt_str_init(str);
+	zrt_str_reserve(str, len);
 	str->length = len;
-	str->data = malloc(sizeof(char) * str->capacity);
-	if (!str->data) abort();
+
+	return str;
+}
+
+static zrt_String* zrt_str_new_len(const char* text, zrt_Int len)
+{
+	zrt_String* str = zrt_str_alloc(len);
 	memcpy(str->data, text, len);
+	return str;
+}
 
+zrt_String* zrt_str_init(zrt_String* str)
+{
+	str->length = 0;
+	str->capacity = ZRT_STR_SMALL;
+	str->data = str->small;
 	return str;
 }
 
+void zrt_str_retain(zrt_String* dst, zrt_String* src)
+{
+	if (!zrt_str_is_heap(src))
+	{
+		zrt_str_copy(dst, src);
+		return;
+	}
+
+	if (dst->data != src->data)
+	{
+		zrt_str_free_data(dst);
+		++*zrt_str_refs(src);
+		dst->capacity = src->capacity;
+		dst->data = src->data;
+		dst->length = src->length;
+	}
+}
+
+void zrt_str_release(zrt_String* str)
+{
+	/* a static string keeps its text for the next use */
+	if (str->capacity == ZRT_STR_IMMORTAL)
+	{
+		return;
+	}
+
+	zrt_str_free_data(str);
+	zrt_str_init(str);
+}
+
+zrt_String* zrt_str_empty()
+{
+	return zrt_str_alloc(0);
+}
+
+zrt_String* zrt_str_new(const char* text)
+{
+	return zrt_str_new_len(text, strlen(text));
+}
+
 zrt_String* zrt_str_new_from_int(zrt_Int value)
 {
-	char buf[16];
-	snprintf(buf, sizeof(buf), "%lld", value);
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%" PRId64, value);
 	return zrt_str_new(buf);
 }
 
 zrt_String* zrt_str_concat(zrt_String* lhs, zrt_String* rhs)
 {
-	zrt_String* str = malloc(sizeof(zrt_String));
-	if (!str) abort();
+	zrt_String* str = zrt_str_alloc(lhs->length + rhs->length);
+	memcpy(str->data, lhs->data, lhs->length);
+	memcpy(str->data + lhs->length, rhs->data, rhs->length);
+	return str;
+}
 
-	zrt_Int cap = 16;
-	zrt_Int len = lhs->length + rhs->length;
-	while (cap < len)
+void zrt_str_copy(zrt_String* dst, zrt_String* src)
+{
+	if (dst == src)
 	{
-		cap *= 2;
+		return;
 	}
 
-	str->capacity = cap;
-	str->length = len;
-	str->data = malloc(sizeof(char) * str->capacity);
-	if (!str->data) abort();
-	memcpy(str->data, lhs->data, lhs->length);
-	memcpy(str->data + lhs->length, rhs->data, rhs->length);
+	zrt_str_reserve(dst, src->length);
+	memcpy(dst->data, src->data, src->length);
+	dst->length = src->length;
+}
+
+void zrt_str_del(zrt_String* str)
+{
+	if (str->capacity == ZRT_STR_IMMORTAL)
+	{
+		return;
+	}
+
+	zrt_str_free_data(str);
+	free(str);
+}
+
+zrt_String* zrt_str_dup(zrt_String* str)
+{
+	zrt_String* dup = malloc(sizeof(zrt_String));
+	if (!dup) abort();
+
+	zrt_str_retain(zrt_str_init(dup), str);
+	return dup;
+}
+
+void zrt_str_concat_into(zrt_String* dst, zrt_String* lhs, zrt_String* rhs)
+{
+	/* dst may be reallocated before lhs and rhs are read, so it must be neither */
+	zrt_str_reserve(dst, lhs->length + rhs->length);
+	memcpy(dst->data, lhs->data, lhs->length);
+	memcpy(dst->data + lhs->length, rhs->data, rhs->length);
+	dst->length = lhs->length + rhs->length;
+}
+
+void zrt_str_concat_n(zrt_String* dst, int count, zrt_String** parts)
+{
+	/* sized once, then each part copied once, so dst must not be a part either */
+	zrt_Int len = 0;
+	int i;
+	for (i = 0; i < count; ++i)
+	{
+		len += parts[i]->length;
+	}
+
+	zrt_str_reserve(dst, len);
+	dst->length = 0;
+	for (i = 0; i < count; ++i)
+	{
+		memcpy(dst->data + dst->length, parts[i]->data, parts[i]->length);
+		dst->length += parts[i]->length;
+	}
+}
+
+void zrt_str_append(zrt_String* dst, zrt_String* src)
+{
+	zrt_Int len = src->length;
+	zrt_str_grow(dst, dst->length + len);
+	memcpy(dst->data + dst->length, src->data, len);
+	dst->length += len;
+}
 
+void zrt_str_append_n(zrt_String* dst, int count, zrt_String** parts)
+{
+	/* dst may also be a part, which adds its text as it was before the append */
+	zrt_Int start = dst->length;
+	zrt_Int len = start;
+	int i;
+	for (i = 0; i < count; ++i)
+	{
+		len += parts[i]->length;
+	}
+
+	zrt_str_grow(dst, len);
+	for (i = 0; i < count; ++i)
+	{
+		zrt_Int partLen = parts[i] == dst ? start : parts[i]->length;
+		memcpy(dst->data + dst->length, parts[i]->data, partLen);
+		dst->length += partLen;
+	}
+}
+
+void zrt_str_take(zrt_String* dst, zrt_String* src)
+{
+	/* text in the small buffer of src has to move with it */
+	zrt_str_free_data(dst);
+	if (src->data == src->small)
+	{
+		zrt_str_init(dst);
+		memcpy(dst->small, src->small, src->length);
+	}
+	else
+	{
+		dst->capacity = src->capacity;
+		dst->data = src->data;
+	}
+	dst->length = src->length;
+	free(src);
+}
+
+static zrt_Int zrt_clamp(zrt_Int value, zrt_Int lo, zrt_Int hi)
+{
+	return value < lo ? lo : (value > hi ? hi : value);
+}
+
+static zrt_String* zrt_str_fill(zrt_Int count, char ch)
+{
+	zrt_String* str = zrt_str_alloc(count > 0 ? count : 0);
+	memset(str->data, ch, str->length);
 	return str;
 }
 
-void zrt_str_copy(zrt_String* dst, zrt_String* src)
+zrt_String* zrt_str_new_from_real(zrt_Real value)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "%g", value);
+	return zrt_str_new(buf);
+}
+
+zrt_Int zrt_str_asc(zrt_String* str)
+{
+	return str->length > 0 ? (unsigned char)str->data[0] : 0;
+}
+
+zrt_String* zrt_str_chr(zrt_Int code)
+{
+	char ch = (char)code;
+	return zrt_str_new_len(&ch, 1);
+}
+
+zrt_Int zrt_str_instr(zrt_String* str, zrt_String* find)
 {
-	if (dst->capacity < src->length)
+	zrt_Int i;
+	for (i = 0; i + find->length <= str->length; ++i)
 	{
-		while (dst->capacity < src->length)
+		if (memcmp(str->data + i, find->data, find->length) == 0)
 		{
-			dst->capacity *= 2;
+			return i + 1;
 		}
+	}
+
+	return 0;
+}
 
-		free(dst->data);
-		dst->data = malloc(sizeof(char) * dst->capacity);
-		if (!dst->data) abort();
+zrt_String* zrt_str_lcase(zrt_String* str)
+{
+	zrt_String* result = zrt_str_new_len(str->data, str->length);
+	zrt_Int i;
+	for (i = 0; i < result->length; ++i)
+	{
+		result->data[i] = (char)tolower((unsigned char)result->data[i]);
 	}
 
-	memcpy(dst->data, src->data, src->length);
-	dst->length = src->length;
+	return result;
 }
 
-void zrt_str_del(zrt_String* str)
+zrt_String* zrt_str_left(zrt_String* str, zrt_Int count)
 {
-	free(str->data);
-	free(str);
+	return zrt_str_new_len(str->data, zrt_clamp(count, 0, str->length));
+}
+
+zrt_String* zrt_str_ltrim(zrt_String* str)
+{
+	zrt_Int start = 0;
+	while (start < str->length && str->data[start] == ' ')
+	{
+		++start;
+	}
+
+	return zrt_str_new_len(str->data + start, str->length - start);
+}
+
+zrt_String* zrt_str_mid(zrt_String* str, zrt_Int start, zrt_Int count)
+{
+	/* start is 1-based, and a negative count takes the rest of the string */
+	zrt_Int first = zrt_clamp(start - 1, 0, str->length);
+	zrt_Int rest = str->length - first;
+	return zrt_str_new_len(str->data + first, count < 0 ? rest : zrt_clamp(count, 0, rest));
+}
+
+zrt_String* zrt_str_radix(zrt_Int value, int radix)
+{
+	static const char digits[] = "0123456789ABCDEF";
+	char buf[64];
+	int pos = sizeof(buf);
+	uint64_t bits = (uint64_t)value;
+	do
+	{
+		buf[--pos] = digits[bits % radix];
+		bits /= radix;
+	} while (bits);
+
+	return zrt_str_new_len(buf + pos, sizeof(buf) - pos);
+}
+
+zrt_String* zrt_str_repeat(zrt_Int count, zrt_String* str)
+{
+	return zrt_str_fill(count, str->length > 0 ? str->data[0] : ' ');
+}
+
+zrt_String* zrt_str_right(zrt_String* str, zrt_Int count)
+{
+	count = zrt_clamp(count, 0, str->length);
+	return zrt_str_new_len(str->data + str->length - count, count);
+}
+
+zrt_String* zrt_str_rtrim(zrt_String* str)
+{
+	zrt_Int end = str->length;
+	while (end > 0 && str->data[end - 1] == ' ')
+	{
+		--end;
+	}
+
+	return zrt_str_new_len(str->data, end);
+}
+
+zrt_String* zrt_str_space(zrt_Int count)
+{
+	return zrt_str_fill(count, ' ');
+}
+
+zrt_String* zrt_str_ucase(zrt_String* str)
+{
+	zrt_String* result = zrt_str_new_len(str->data, str->length);
+	zrt_Int i;
+	for (i = 0; i < result->length; ++i)
+	{
+		result->data[i] = (char)toupper((unsigned char)result->data[i]);
+	}
+
+	return result;
+}
+
+zrt_Real zrt_str_val(zrt_String* str)
+{
+	char buf[64];
+	zrt_Int len = zrt_clamp(str->length, 0, sizeof(buf) - 1);
+	memcpy(buf, str->data, len);
+	buf[len] = 0;
+	return strtod(buf, NULL);
+}
+
+zrt_String* zrt_command()
+{
+	zrt_String* result = zrt_str_new_len("", 0);
+	int i;
+	for (i = 1; i < zrt_argc; ++i)
+	{
+		zrt_String* arg = zrt_str_new(zrt_argv[i]);
+		zrt_String* space = zrt_str_new(i > 1 ? " " : "");
+		zrt_String* joined = zrt_str_concat(result, space);
+		zrt_str_del(result);
+		result = zrt_str_concat(joined, arg);
+		zrt_str_del(joined);
+		zrt_str_del(space);
+		zrt_str_del(arg);
+	}
+
+	return result;
+}
+
+zrt_String* zrt_date()
+{
+	char buf[16];
+	time_t now = time(NULL);
+	strftime(buf, sizeof(buf), "%m-%d-%Y", localtime(&now));
+	return zrt_str_new(buf);
+}
+
+zrt_String* zrt_environ(zrt_String* name)
+{
+	char buf[256];
+	const char* value;
+	zrt_Int len = zrt_clamp(name->length, 0, sizeof(buf) - 1);
+	memcpy(buf, name->data, len);
+	buf[len] = 0;
+
+	value = getenv(buf);
+	return zrt_str_new(value ? value : "");
+}
+
+/* the next key waiting on the console, without waiting for one, or an empty string if there is none */
+zrt_String* zrt_inkey()
+{
+	char ch = 0;
+	int count = 0;
+#ifdef _WIN32
+	if (_kbhit())
+	{
+		ch = (char)_getch();
+		count = 1;
+	}
+#else
+	/* a terminal hands over keys as they are pressed rather than a line at a time, while it is asked */
+	struct termios saved;
+	int isTerminal = tcgetattr(STDIN_FILENO, &saved) == 0;
+	fd_set ready;
+	struct timeval timeout = { 0, 0 };
+
+	fflush(stdout);
+	if (isTerminal)
+	{
+		struct termios raw = saved;
+		raw.c_lflag &= ~(ICANON | ECHO);
+		raw.c_cc[VMIN] = 0;
+		raw.c_cc[VTIME] = 0;
+		tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+	}
+
+	FD_ZERO(&ready);
+	FD_SET(STDIN_FILENO, &ready);
+	if (select(STDIN_FILENO + 1, &ready, NULL, NULL, &timeout) > 0 && read(STDIN_FILENO, &ch, 1) == 1)
+	{
+		count = 1;
+	}
+
+	if (isTerminal)
+	{
+		tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+	}
+#endif
+
+	return zrt_str_new_len(&ch, count);
+}
+
+zrt_Real zrt_rnd()
+{
+	return rand() / (RAND_MAX + 1.0);
+}
+
+zrt_String* zrt_time()
+{
+	char buf[16];
+	time_t now = time(NULL);
+	strftime(buf, sizeof(buf), "%H:%M:%S", localtime(&now));
+	return zrt_str_new(buf);
+}
+
+zrt_Real zrt_timer()
+{
+	/* seconds since midnight */
+	time_t now = time(NULL);
+	struct tm* local = localtime(&now);
+	return local->tm_hour * 3600.0 + local->tm_min * 60.0 + local->tm_sec;
+}
+
+void zrt_println()
+{
+	printf("\n");
 }
 
 void zrt_println_bool(zrt_Bool arg)
@@ -138,7 +605,7 @@ void zrt_println_bool(zrt_Bool arg)
 
 void zrt_println_int(zrt_Int arg)
 {
-	printf("%lld\n", arg);
+	printf("%" PRId64 "\n", arg);
 }
 
 void zrt_println_real(zrt_Real arg)
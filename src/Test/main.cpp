@@ -24,32 +24,62 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
 
+#include <cstring>
 #include <iostream>
+#include <memory>
 
 #include "ZeeBasic/Compiler/CTranslator.hpp"
 #include "ZeeBasic/Compiler/Error.hpp"
-#include "ZeeBasic/Compiler/FileSourceReader.hpp"
+#include "ZeeBasic/Compiler/MappedSourceReader.hpp"
 #include "ZeeBasic/Compiler/Parser.hpp"
+#include "ZeeBasic/Compiler/Pipeline.hpp"
 #include "ZeeBasic/Compiler/Program.hpp"
+#include "ZeeBasic/Compiler/StreamSourceReader.hpp"
 
 using namespace ZeeBasic::Compiler;
 
 int main(int argc, char* argv[])
 {
-	auto source = FileSourceReader{ "test.zb" };
+	// "-" reads the program from standard input, so generated code can be piped in
+	auto source = std::unique_ptr<ISourceReader>{};
+	if (argc > 1 && strcmp(argv[1], "-") == 0)
+	{
+		source = std::make_unique<StreamSourceReader>(0);
+	}
+	else
+	{
+		source = std::make_unique<MappedSourceReader>("test.zb");
+	}
 
 	try
 	{
 		auto program = Program{};
-		auto parser = Parser{ source, program };
+		auto parser = Parser{ *source, program };
 		parser.run();
 
+		auto pipeline = Pipeline{ program };
+		pipeline.run();
+
 		auto translator = CTranslator{ "out.c", program };
 		translator.run();
 	}
-	catch (const Error& err)
+	catch (Error& err)
 	{
+		// the parser resolves its own errors, but the pipeline has no source to find the line and column in
+		if (!err.isResolved())
+		{
+			if (auto range = source->getRange(err.getLocation()); range.startLine > 0)
+			{
+				err.resolve(range);
+			}
+		}
+
+		// a stream only keeps its last chunks, so an early line of piped input can no longer be found
 		std::cerr << "Compile Error!" << std::endl;
+		if (!err.isResolved())
+		{
+			std::cerr << "[unknown location] ";
+		}
 		std::cerr << err.what() << std::endl;
 		return -1;
 	}
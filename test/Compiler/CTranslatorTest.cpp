@@ -0,0 +1,270 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "ZeeBasic/Compiler/CTranslator.hpp"
+
+#include "ZeeBasic/Compiler/ISourceReader.hpp"
+#include "ZeeBasic/Compiler/Parser.hpp"
+#include "ZeeBasic/Compiler/Pipeline.hpp"
+#include "ZeeBasic/Compiler/Program.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+class StringSourceReader
+    :
+    public ISourceReader
+{
+public:
+    StringSourceReader(const char* code)
+        :
+        ISourceReader(),
+        m_text(code),
+        m_offset(0)
+    { }
+
+    ~StringSourceReader()
+    { }
+
+    char readNextChar() override
+    {
+        if (m_text[m_offset] == 0)
+        {
+            return 0;
+        }
+
+        return m_text[m_offset++];
+    }
+
+private:
+    const char* m_text;
+    int m_offset;
+};
+
+// the C for a program, from after the includes up to main, which are the same for every program
+static std::string translate(const char* code, CTranslator::Emission emission = CTranslator::Emission::Expressions)
+{
+    auto reader = StringSourceReader{ code };
+    auto program = Program{};
+    Parser{ reader, program }.run();
+    Pipeline{ program }.run();
+
+    auto path = (std::filesystem::temp_directory_path() / "CTranslatorTest.c").string();
+    CTranslator{ path, program, emission }.run();
+
+    auto text = std::stringstream{};
+    text << std::ifstream{ path }.rdbuf();
+    std::filesystem::remove(path);
+
+    auto output = text.str();
+    auto start = output.find("\n\n") + 2;
+    return output.substr(start, output.find("\nint main") - start);
+}
+
+TEST(ZeeBasic_Compiler_CTranslator, LiteralArguments)
+{
+    // a literal's address is parenthesized, as a builtin may apply -> to it
+    EXPECT_EQ(translate("PRINT LEN(\"abc\")\nPRINT ASC(\"ab\")\nPRINT INSTR(\"hello\", \"l\")\n"),
+        "static zrt_String lit_0 = { 3, ZRT_STR_IMMORTAL, (char*)\"abc\" };\n"
+        "static zrt_String lit_1 = { 2, ZRT_STR_IMMORTAL, (char*)\"ab\" };\n"
+        "static zrt_String lit_2 = { 5, ZRT_STR_IMMORTAL, (char*)\"hello\" };\n"
+        "static zrt_String lit_3 = { 1, ZRT_STR_IMMORTAL, (char*)\"l\" };\n"
+        "\n"
+        "void program(void)\n"
+        "{\n"
+        "    zrt_Int ti_0;\n"
+        "    ti_0 = (&lit_0)->length;\n"
+        "    zrt_println_int(ti_0);\n"
+        "    ti_0 = zrt_str_asc((&lit_1));\n"
+        "    zrt_println_int(ti_0);\n"
+        "    ti_0 = zrt_str_instr((&lit_2), (&lit_3));\n"
+        "    zrt_println_int(ti_0);\n"
+        "    return;\n"
+        "}\n");
+}
+
+TEST(ZeeBasic_Compiler_CTranslator, NestedExpressions)
+{
+    EXPECT_EQ(translate("r = RND\nPRINT -(r * 2 + 1) / (r - 3)\nx% = r * 4\nPRINT x% + (x% - 1) * 2\n"),
+        "void program(void)\n"
+        "{\n"
+        "    zrt_Int ti_0;\n"
+        "    zrt_Real tr_0;\n"
+        "    tr_0 = zrt_rnd();\n"
+        "    ti_0 = (zrt_Int)tr_0;\n"
+        "    zrt_println_real(((zrt_Real)(-((ti_0 * 2) + 1)) / (zrt_Real)(ti_0 - 3)));\n"
+        "    ti_0 = ti_0 * 4;\n"
+        "    zrt_println_int((ti_0 + ((ti_0 - 1) * 2)));\n"
+        "    return;\n"
+        "}\n");
+}
+
+TEST(ZeeBasic_Compiler_CTranslator, Temporaries)
+{
+    EXPECT_EQ(translate("r = RND\nPRINT -(r * 2 + 1) / (r - 3)\n", CTranslator::Emission::Temporaries),
+        "void program(void)\n"
+        "{\n"
+        "    zrt_Int ti_0;\n"
+        "    zrt_Int ti_1;\n"
+        "    zrt_Int ti_2;\n"
+        "    zrt_Real tr_0;\n"
+        "    tr_0 = zrt_rnd();\n"
+        "    ti_0 = (zrt_Int)tr_0;\n"
+        "    ti_1 = 2;\n"
+        "    ti_1 = ti_0 * ti_1;\n"
+        "    ti_2 = 1;\n"
+        "    ti_1 = ti_1 + ti_2;\n"
+        "    ti_1 = -ti_1;\n"
+        "    ti_2 = 3;\n"
+        "    ti_0 = ti_0 - ti_2;\n"
+        "    tr_0 = (zrt_Real)ti_1 / (zrt_Real)ti_0;\n"
+        "    zrt_println_real(tr_0);\n"
+        "    return;\n"
+        "}\n");
+}
+
+TEST(ZeeBasic_Compiler_CTranslator, LiteralEscapes)
+{
+    // one static string for each distinct text, escaped so that backslashes, trigraphs and control characters keep
+    // their meaning
+    EXPECT_EQ(translate("PRINT \"a\\b\"\nPRINT \"?\?=\"\nPRINT \"tab\there\"\nPRINT \"a\\b\"\nPRINT \"\"\n"),
+        "static zrt_String lit_0 = { 3, ZRT_STR_IMMORTAL, (char*)\"a\\\\b\" };\n"
+        "static zrt_String lit_1 = { 3, ZRT_STR_IMMORTAL, (char*)\"\\?\\?=\" };\n"
+        "static zrt_String lit_2 = { 8, ZRT_STR_IMMORTAL, (char*)\"tab\\011here\" };\n"
+        "static zrt_String lit_3 = { 0, ZRT_STR_IMMORTAL, (char*)\"\" };\n"
+        "\n"
+        "void program(void)\n"
+        "{\n"
+        "    zrt_println_str((&lit_0));\n"
+        "    zrt_println_str((&lit_1));\n"
+        "    zrt_println_str((&lit_2));\n"
+        "    zrt_println_str((&lit_0));\n"
+        "    zrt_println_str((&lit_3));\n"
+        "    return;\n"
+        "}\n");
+}
+
+TEST(ZeeBasic_Compiler_CTranslator, Concatenation)
+{
+    // a chain of concatenations is one call that sizes the result once
+    EXPECT_EQ(translate("a$ = STR$(RND)\nb$ = STR$(RND)\nPRINT a$ + \", \" + b$ + \"!\"\nPRINT a$ + b$\n"),
+        "static zrt_String lit_0 = { 2, ZRT_STR_IMMORTAL, (char*)\", \" };\n"
+        "static zrt_String lit_1 = { 1, ZRT_STR_IMMORTAL, (char*)\"!\" };\n"
+        "\n"
+        "void program(void)\n"
+        "{\n"
+        "    zrt_Real tr_0;\n"
+        "    zrt_String ts_0[1];\n"
+        "    zrt_String ts_1[1];\n"
+        "    zrt_String ts_2[1];\n"
+        "    zrt_str_init(ts_0);\n"
+        "    zrt_str_init(ts_1);\n"
+        "    zrt_str_init(ts_2);\n"
+        "    tr_0 = zrt_rnd();\n"
+        "    zrt_str_take(ts_0, zrt_str_new_from_real(tr_0));\n"
+        "    tr_0 = zrt_rnd();\n"
+        "    zrt_str_take(ts_1, zrt_str_new_from_real(tr_0));\n"
+        "    zrt_str_concat_n(ts_2, 4, (zrt_String*[]){ ts_0, (&lit_0), ts_1, (&lit_1) });\n"
+        "    zrt_println_str(ts_2);\n"
+        "    zrt_str_release(ts_2);\n"
+        "    zrt_str_append(ts_0, ts_1);\n"
+        "    zrt_str_release(ts_1);\n"
+        "    zrt_println_str(ts_0);\n"
+        "    zrt_str_release(ts_0);\n"
+        "    zrt_str_release(ts_0);\n"
+        "    zrt_str_release(ts_1);\n"
+        "    zrt_str_release(ts_2);\n"
+        "    return;\n"
+        "}\n");
+}
+
+TEST(ZeeBasic_Compiler_CTranslator, Append)
+{
+    // a concatenation whose first part dies with it grows that string in place
+    EXPECT_EQ(translate("s$ = STR$(RND)\ns$ = s$ + \"x\"\ns$ = s$ + \"y\" + STR$(RND)\nPRINT s$\n"),
+        "static zrt_String lit_0 = { 1, ZRT_STR_IMMORTAL, (char*)\"x\" };\n"
+        "static zrt_String lit_1 = { 1, ZRT_STR_IMMORTAL, (char*)\"y\" };\n"
+        "\n"
+        "void program(void)\n"
+        "{\n"
+        "    zrt_Real tr_0;\n"
+        "    zrt_String ts_0[1];\n"
+        "    zrt_String ts_1[1];\n"
+        "    zrt_str_init(ts_0);\n"
+        "    zrt_str_init(ts_1);\n"
+        "    tr_0 = zrt_rnd();\n"
+        "    zrt_str_take(ts_0, zrt_str_new_from_real(tr_0));\n"
+        "    tr_0 = zrt_rnd();\n"
+        "    zrt_str_take(ts_1, zrt_str_new_from_real(tr_0));\n"
+        "    zrt_str_append_n(ts_0, 3, (zrt_String*[]){ (&lit_0), (&lit_1), ts_1 });\n"
+        "    zrt_str_release(ts_1);\n"
+        "    zrt_println_str(ts_0);\n"
+        "    zrt_str_release(ts_0);\n"
+        "    zrt_str_release(ts_0);\n"
+        "    zrt_str_release(ts_1);\n"
+        "    return;\n"
+        "}\n");
+}
+
+TEST(ZeeBasic_Compiler_CTranslator, RetainAndRelease)
+{
+    // copying a variable shares its string, and each string is released after its last use
+    EXPECT_EQ(translate("a$ = STR$(RND)\nb$ = a$\nPRINT b$\na$ = \"new\"\nPRINT a$ + b$\nPRINT LEN(STR$(RND))\n"),
+        "static zrt_String lit_0 = { 3, ZRT_STR_IMMORTAL, (char*)\"new\" };\n"
+        "\n"
+        "void program(void)\n"
+        "{\n"
+        "    zrt_Int ti_0;\n"
+        "    zrt_Real tr_0;\n"
+        "    zrt_String ts_0[1];\n"
+        "    zrt_String ts_1[1];\n"
+        "    zrt_str_init(ts_0);\n"
+        "    zrt_str_init(ts_1);\n"
+        "    tr_0 = zrt_rnd();\n"
+        "    zrt_str_take(ts_0, zrt_str_new_from_real(tr_0));\n"
+        "    zrt_str_retain(ts_1, ts_0);\n"
+        "    zrt_str_release(ts_0);\n"
+        "    zrt_println_str(ts_1);\n"
+        "    zrt_str_concat_into(ts_0, (&lit_0), ts_1);\n"
+        "    zrt_str_release(ts_1);\n"
+        "    zrt_println_str(ts_0);\n"
+        "    zrt_str_release(ts_0);\n"
+        "    tr_0 = zrt_rnd();\n"
+        "    zrt_str_take(ts_0, zrt_str_new_from_real(tr_0));\n"
+        "    ti_0 = ts_0->length;\n"
+        "    zrt_str_release(ts_0);\n"
+        "    zrt_println_int(ti_0);\n"
+        "    zrt_str_release(ts_0);\n"
+        "    zrt_str_release(ts_1);\n"
+        "    return;\n"
+        "}\n");
+}
@@ -0,0 +1,166 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/ConstantFolder.hpp"
+#include "ZeeBasic/Compiler/Error.hpp"
+
+using namespace ZeeBasic::Compiler;
+using namespace ZeeBasic::Compiler::Nodes;
+
+using BinaryOperator = BinaryExpressionNode::Operator;
+
+static const Type Boolean{ BaseType_Boolean };
+static const Type Integer{ BaseType_Integer };
+static const Type Real{ BaseType_Real };
+static const Type String{ BaseType_String };
+
+// fold a program that prints a single expression
+static FlatAst foldPrint(FlatAst& ast, uint32_t expr)
+{
+    ast.addPrint(expr, SourceLocation{});
+    return ConstantFolder{ ast }.run();
+}
+
+// operands are added in order, as children must come before their parent with the left-hand side first
+static uint32_t addBinary(FlatAst& ast, BinaryOperator op, const Type& type, int64_t lhs, int64_t rhs)
+{
+    auto left = ast.addIntegerLiteral(lhs, {});
+    auto right = ast.addIntegerLiteral(rhs, {});
+    return ast.addBinary(op, type, left, right, {});
+}
+
+TEST(ZeeBasic_Compiler_ConstantFolder, Arithmetic)
+{
+    // -(2 + 3)
+    auto ast = FlatAst{};
+    auto sum = addBinary(ast, BinaryOperator::Add, Integer, 2, 3);
+    auto folded = foldPrint(ast, ast.addUnary(UnaryExpressionNode::Operator::Negate, Integer, sum, {}));
+
+    ASSERT_EQ(folded.getCount(), 2);
+    EXPECT_EQ(folded.getKind(0), FlatAst::Kind::IntegerLiteral);
+    EXPECT_EQ(folded.getInteger(0), -5);
+    EXPECT_EQ(folded.getFirst(1), 0);
+}
+
+TEST(ZeeBasic_Compiler_ConstantFolder, FollowsC)
+{
+    struct Case
+    {
+        BinaryOperator op;
+        int64_t lhs;
+        int64_t rhs;
+        int64_t result;
+    } cases[] = {
+        { BinaryOperator::IntDivide, 7, 2, 3 },
+        { BinaryOperator::IntDivide, -7, 2, -3 },
+        { BinaryOperator::Modulus, -7, 3, -1 },
+        { BinaryOperator::BitwiseXor, 6, 3, 5 },
+        { BinaryOperator::Less, 2, 3, 1 },
+    };
+
+    for (const auto& c : cases)
+    {
+        auto ast = FlatAst{};
+        auto type = c.op == BinaryOperator::Less ? Boolean : Integer;
+        auto folded = foldPrint(ast, addBinary(ast, c.op, type, c.lhs, c.rhs));
+        ASSERT_EQ(folded.getCount(), 2);
+        EXPECT_EQ(folded.getKind(0) == FlatAst::Kind::BooleanLiteral ? int64_t(folded.getBoolean(0)) : folded.getInteger(0), c.result);
+    }
+
+    // 7 / 2 divides as reals
+    auto ast = FlatAst{};
+    auto folded = foldPrint(ast, addBinary(ast, BinaryOperator::Divide, Real, 7, 2));
+    ASSERT_EQ(folded.getKind(0), FlatAst::Kind::RealLiteral);
+    EXPECT_TRUE(folded.getText(0) == "3.5");
+}
+
+TEST(ZeeBasic_Compiler_ConstantFolder, LeavesRunTimeFailures)
+{
+    auto ast = FlatAst{};
+    auto folded = foldPrint(ast, addBinary(ast, BinaryOperator::IntDivide, Integer, 1, 0));
+    EXPECT_EQ(folded.getCount(), 4);
+
+    ast = FlatAst{};
+    folded = foldPrint(ast, addBinary(ast, BinaryOperator::Multiply, Integer, INT64_MAX, 2));
+    EXPECT_EQ(folded.getCount(), 4);
+}
+
+TEST(ZeeBasic_Compiler_ConstantFolder, Strings)
+{
+    auto ast = FlatAst{};
+    auto lhs = ast.addStringLiteral(ConstString{ "ab", 2 }, {});
+    auto rhs = ast.addStringLiteral(ConstString{ "cd", 2 }, {});
+    auto folded = foldPrint(ast, ast.addBinary(BinaryOperator::Add, String, lhs, rhs, {}));
+    ASSERT_EQ(folded.getCount(), 2);
+    EXPECT_TRUE(folded.getText(0) == "abcd");
+}
+
+TEST(ZeeBasic_Compiler_ConstantFolder, Identities)
+{
+    auto symbol = Symbol{ 0, 0, 0, ConstString{ "x%", 2 }, SourceLocation{}, Integer };
+
+    // x% * 1 + 0
+    auto ast = FlatAst{};
+    auto x = ast.addIdentifier(symbol, {});
+    auto product = ast.addBinary(BinaryOperator::Multiply, Integer, x, ast.addIntegerLiteral(1, {}), {});
+    auto folded = foldPrint(ast, ast.addBinary(BinaryOperator::Add, Integer, product, ast.addIntegerLiteral(0, {}), {}));
+    ASSERT_EQ(folded.getCount(), 2);
+    EXPECT_EQ(folded.getKind(0), FlatAst::Kind::Identifier);
+
+    // (x% - 1) * 0
+    ast = FlatAst{};
+    x = ast.addIdentifier(symbol, {});
+    auto difference = ast.addBinary(BinaryOperator::Subtract, Integer, x, ast.addIntegerLiteral(1, {}), {});
+    folded = foldPrint(ast, ast.addBinary(BinaryOperator::Multiply, Integer, difference, ast.addIntegerLiteral(0, {}), {}));
+    ASSERT_EQ(folded.getCount(), 2);
+    EXPECT_EQ(folded.getInteger(0), 0);
+}
+
+TEST(ZeeBasic_Compiler_ConstantFolder, Constants)
+{
+    auto constant = Symbol{ 0, 0, 0, ConstString{ "size", 4 }, SourceLocation{}, Integer };
+    constant.isConstant = true;
+    auto variable = Symbol{ 1, 1, 0, ConstString{ "x%", 2 }, SourceLocation{}, Integer };
+
+    // CONST size = 4 * 4 : x% = size + 1
+    auto ast = FlatAst{};
+    ast.addAssignment(constant, addBinary(ast, BinaryOperator::Multiply, Integer, 4, 4), {});
+    auto size = ast.addIdentifier(constant, {});
+    ast.addAssignment(variable, ast.addBinary(BinaryOperator::Add, Integer, size, ast.addIntegerLiteral(1, {}), {}), {});
+    auto folded = ConstantFolder{ ast }.run();
+
+    ASSERT_EQ(folded.getCount(), 2);
+    ASSERT_EQ(folded.getStatements().size(), 1);
+    EXPECT_EQ(folded.getInteger(0), 17);
+    EXPECT_EQ(&folded.getSymbol(1), &variable);
+
+    // CONST size = x%
+    ast = FlatAst{};
+    ast.addAssignment(constant, ast.addIdentifier(variable, {}), {});
+    EXPECT_THROW(ConstantFolder{ ast }.run(), Error);
+}
@@ -0,0 +1,176 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/ConstantPropagation.hpp"
+#include "ZeeBasic/Compiler/DeadCodeElimination.hpp"
+#include "ZeeBasic/Compiler/IrBuilder.hpp"
+
+using namespace ZeeBasic::Compiler;
+using namespace ZeeBasic::Compiler::Nodes;
+
+using BinaryOperator = BinaryExpressionNode::Operator;
+
+static const Type Boolean{ BaseType_Boolean };
+static const Type Integer{ BaseType_Integer };
+static const Type String{ BaseType_String };
+
+static std::string optimize(Ir::Function& function)
+{
+    ConstantPropagation{ function }.run();
+    DeadCodeElimination{ function }.run();
+    return function.dump();
+}
+
+TEST(ZeeBasic_Compiler_ConstantPropagation, AcrossStatements)
+{
+    // x = 2 : y = x * 3 : PRINT y + x
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    builder.setBlock(builder.createBlock());
+    builder.sealBlock(0);
+
+    builder.writeVariable(0, builder.constant(int64_t(2)));
+    auto three = builder.constant(int64_t(3));
+    builder.writeVariable(1, builder.binary(BinaryOperator::Multiply, Integer, builder.readVariable(0, Integer), three));
+    auto y = builder.readVariable(1, Integer);
+    builder.print(builder.binary(BinaryOperator::Add, Integer, y, builder.readVariable(0, Integer)));
+    builder.ret();
+
+    EXPECT_EQ(optimize(function),
+        "block0:\n"
+        "  %3 = const int 8\n"
+        "  print %3\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_ConstantPropagation, DeadBranch)
+{
+    // DEBUG = FALSE : IF DEBUG THEN x = 1 ELSE x = 2 : PRINT x
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    auto entry = builder.createBlock();
+    auto whenTrue = builder.createBlock();
+    auto whenFalse = builder.createBlock();
+    auto join = builder.createBlock();
+
+    builder.setBlock(entry);
+    builder.sealBlock(entry);
+    builder.branch(builder.constant(false), whenTrue, whenFalse);
+
+    builder.setBlock(whenTrue);
+    builder.sealBlock(whenTrue);
+    builder.writeVariable(0, builder.constant(int64_t(1)));
+    builder.print(builder.stringLiteral(ConstString{ "debug", 5 }));
+    builder.jump(join);
+
+    builder.setBlock(whenFalse);
+    builder.sealBlock(whenFalse);
+    builder.writeVariable(0, builder.constant(int64_t(2)));
+    builder.jump(join);
+
+    builder.setBlock(join);
+    builder.sealBlock(join);
+    builder.print(builder.readVariable(0, Integer));
+    builder.ret();
+
+    EXPECT_EQ(optimize(function),
+        "block0:\n"
+        "  jump block2\n"
+        "block1:\n"
+        "block2:\n"
+        "  jump block3\n"
+        "block3:\n"
+        "  %8 = const int 2\n"
+        "  print %8\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_ConstantPropagation, Loop)
+{
+    // x = 5 : DO : PRINT x : x = x * 1 : LOOP WHILE c
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    auto entry = builder.createBlock();
+    auto body = builder.createBlock();
+    auto exit = builder.createBlock();
+
+    builder.setBlock(entry);
+    builder.sealBlock(entry);
+    builder.writeVariable(0, builder.constant(int64_t(5)));
+    auto condition = builder.call(*getBuiltin(TokenId::Key_RND), Type{ BaseType_Real }, {});
+    builder.jump(body);
+
+    builder.setBlock(body);
+    auto x = builder.readVariable(0, Integer);
+    builder.print(x);
+    auto one = builder.constant(int64_t(1));
+    builder.writeVariable(0, builder.binary(BinaryOperator::Multiply, Integer, x, one));
+    auto half = builder.constantReal(ConstString{ "0.5", 3 });
+    builder.branch(builder.binary(BinaryOperator::Less, Boolean, condition, half), body, exit);
+    builder.sealBlock(body);
+
+    builder.setBlock(exit);
+    builder.sealBlock(exit);
+    builder.ret();
+
+    // the phi for x in the loop is only ever 5
+    EXPECT_EQ(optimize(function),
+        "block0:\n"
+        "  %1 = call real RND\n"
+        "  jump block1\n"
+        "block1:\n"
+        "  %3 = const int 5\n"
+        "  print %3\n"
+        "  %7 = const real 0.5\n"
+        "  %8 = lt bool %1, %7\n"
+        "  branch %8, block1, block2\n"
+        "block2:\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_DeadCodeElimination, UnreadString)
+{
+    // a$ = "x" : b$ = a$ : PRINT 1
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    builder.setBlock(builder.createBlock());
+    builder.sealBlock(0);
+
+    auto a = builder.stringLiteral(ConstString{ "x", 1 });
+    auto b = builder.stringCopy(a);
+    builder.print(builder.constant(int64_t(1)));
+    builder.stringRelease(b);
+    builder.stringRelease(a);
+    builder.ret();
+
+    EXPECT_EQ(optimize(function),
+        "block0:\n"
+        "  %2 = const int 1\n"
+        "  print %2\n"
+        "  ret\n");
+}
@@ -47,3 +47,16 @@ TEST(ZeeBasic_Compiler_Error, Parameters)
 
     EXPECT_EQ(caught, true);
 }
+
+TEST(ZeeBasic_Compiler_Error, Resolve)
+{
+    auto error = Error::create(SourceLocation{ 7 }, "Test %s", "Error");
+    EXPECT_STREQ(error.what(), "Test Error");
+    EXPECT_EQ(error.getLocation(), SourceLocation{ 7 });
+    EXPECT_FALSE(error.isResolved());
+
+    error.resolve({ 2, 300 });
+    EXPECT_STREQ(error.what(), "[2:300] Test Error");
+    EXPECT_EQ(error.getRange().startCol, 300);
+    EXPECT_TRUE(error.isResolved());
+}
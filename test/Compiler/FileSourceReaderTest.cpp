@@ -47,17 +47,11 @@ TEST(ZeeBasic_Compiler_FileSourceReader, ReadData)
     std::ofstream{ "test2.zee" } << "File\nWith\nNewlines";
     auto reader = FileSourceReader{ "test2.zee" };
 
-    auto lineNo = 0;
-    auto colNo = 0;
-    reader.getReadPosition(lineNo, colNo);
-    EXPECT_EQ(lineNo, 1);
-    EXPECT_EQ(colNo, 1);
+    EXPECT_EQ(reader.getRange(SourceLocation{ 0 }), (Range{ 1, 1 }));
 
     auto ch = reader.readNextChar();
     EXPECT_EQ(ch, 'F');
-    reader.getReadPosition(lineNo, colNo);
-    EXPECT_EQ(lineNo, 1);
-    EXPECT_EQ(colNo, 2);
+    EXPECT_EQ(reader.getRange(SourceLocation{ 1 }), (Range{ 1, 2 }));
 
     ch = reader.readNextChar();
     EXPECT_EQ(ch, 'i');
@@ -65,39 +59,30 @@ TEST(ZeeBasic_Compiler_FileSourceReader, ReadData)
     EXPECT_EQ(ch, 'l');
     ch = reader.readNextChar();
     EXPECT_EQ(ch, 'e');
-    reader.getReadPosition(lineNo, colNo);
-    EXPECT_EQ(lineNo, 1);
-    EXPECT_EQ(colNo, 5);
+    EXPECT_EQ(reader.getRange(SourceLocation{ 4 }), (Range{ 1, 5 }));
 
     ch = reader.readNextChar();
     EXPECT_EQ(ch, '\n');
-    reader.getReadPosition(lineNo, colNo);
-    EXPECT_EQ(lineNo, 2);
-    EXPECT_EQ(colNo, 1);
+    EXPECT_EQ(reader.getRange(SourceLocation{ 5 }), (Range{ 2, 1 }));
 
     for (auto i = 0; i < 12; ++i)
     {
         (void)reader.readNextChar();
     }
 
-    reader.getReadPosition(lineNo, colNo);
-    EXPECT_EQ(lineNo, 3);
-    EXPECT_EQ(colNo, 8);
+    EXPECT_EQ(reader.getRange(SourceLocation{ 17 }), (Range{ 3, 8 }));
 
     ch = reader.readNextChar();
     EXPECT_EQ(ch, 's');
-    reader.getReadPosition(lineNo, colNo);
-    EXPECT_EQ(lineNo, 3);
-    EXPECT_EQ(colNo, 9);
+    EXPECT_EQ(reader.getRange(SourceLocation{ 18 }), (Range{ 3, 9 }));
 
     for (auto i = 0; i < 3; ++i)
     {
         ch = reader.readNextChar();
         EXPECT_EQ(ch, 0);
-        reader.getReadPosition(lineNo, colNo);
-        EXPECT_EQ(lineNo, 3);
-        EXPECT_EQ(colNo, 9);
+        EXPECT_EQ(reader.getRange(SourceLocation{ 18 }), (Range{ 3, 9 }));
+        EXPECT_EQ(reader.getRange(SourceLocation{ 19 }), (Range{ 3, 9 }));
     }
 
-    std::filesystem::remove("test.zee");
+    std::filesystem::remove("test2.zee");
 }
@@ -0,0 +1,78 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/FlatAst.hpp"
+
+using namespace ZeeBasic::Compiler;
+using namespace ZeeBasic::Compiler::Nodes;
+
+TEST(ZeeBasic_Compiler_FlatAst, Add)
+{
+    auto symbol = Symbol{ 0, 0, 0, ConstString{ "x%", 2 }, SourceLocation{ 0 }, Type{ BaseType_Integer } };
+    auto ast = FlatAst{};
+
+    auto x = ast.addIdentifier(symbol, SourceLocation{ 5 });
+    auto two = ast.addIntegerLiteral(2, SourceLocation{ 10 });
+    auto product = ast.addBinary(BinaryExpressionNode::Operator::Multiply, Type{ BaseType_Integer }, x, two, SourceLocation{ 5 });
+    auto assignment = ast.addAssignment(symbol, product, SourceLocation{ 0 });
+    auto text = ast.addStringLiteral(ConstString{ "hi", 2 }, SourceLocation{ 18 });
+    auto call = ast.addFunctionCall(*getBuiltin(TokenId::Key_LEN), Type{ BaseType_Integer }, { text }, SourceLocation{ 14 });
+    auto print = ast.addPrint(call, SourceLocation{ 12 });
+
+    ASSERT_EQ(ast.getCount(), 7);
+    EXPECT_EQ(ast.getStatements(), (std::vector<uint32_t>{ assignment, print }));
+
+    // children come before their parents
+    EXPECT_EQ(ast.getKind(product), FlatAst::Kind::Binary);
+    EXPECT_EQ(ast.getBinaryOperator(product), BinaryExpressionNode::Operator::Multiply);
+    EXPECT_LT(ast.getFirst(product), product);
+    EXPECT_LT(ast.getSecond(product), product);
+    EXPECT_EQ(ast.getType(product).base, BaseType_Integer);
+    EXPECT_EQ(ast.getLocation(product), SourceLocation{ 5 });
+
+    EXPECT_EQ(&ast.getSymbol(x), &symbol);
+    EXPECT_EQ(ast.getInteger(two), 2);
+    EXPECT_EQ(&ast.getSymbol(assignment), &symbol);
+    EXPECT_EQ(ast.getSecond(assignment), product);
+
+    EXPECT_EQ(ast.getFunction(call).id, TokenId::Key_LEN);
+    ASSERT_EQ(ast.getArgumentCount(call), 1);
+    EXPECT_EQ(ast.getArgument(call, 0), text);
+    EXPECT_TRUE(ast.getText(text) == "hi");
+    EXPECT_EQ(ast.getFirst(print), call);
+}
+
+TEST(ZeeBasic_Compiler_FlatAst, EmptyPrint)
+{
+    auto ast = FlatAst{};
+    auto print = ast.addPrint(FlatAst::kNone, SourceLocation{ 0 });
+
+    EXPECT_EQ(ast.getKind(print), FlatAst::Kind::Print);
+    EXPECT_EQ(ast.getFirst(print), FlatAst::kNone);
+    EXPECT_EQ(ast.getStatements().size(), 1);
+}
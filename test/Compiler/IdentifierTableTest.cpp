@@ -0,0 +1,77 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/IdentifierTable.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+TEST(ZeeBasic_Compiler_IdentifierTable, Intern)
+{
+    auto table = IdentifierTable{};
+    EXPECT_EQ(table.getCount(), 0);
+    EXPECT_EQ(table.find({ "name$", 5 }), -1);
+
+    auto id = table.intern({ "name$", 5 });
+    EXPECT_EQ(id, 0);
+    EXPECT_EQ(table.intern({ "NAME$", 5 }), id);
+    EXPECT_EQ(table.intern(ConstString::view("Name$ = 1", 5)), id);
+    EXPECT_EQ(table.find({ "nAmE$", 5 }), id);
+    EXPECT_EQ(table.getName(id), "name$");
+    EXPECT_EQ(table.getCount(), 1);
+
+    EXPECT_EQ(table.intern({ "name", 4 }), 1);
+    EXPECT_EQ(table.intern({ "name%", 5 }), 2);
+    EXPECT_EQ(table.getCount(), 3);
+}
+
+TEST(ZeeBasic_Compiler_IdentifierTable, KeepsFirstSpelling)
+{
+    auto table = IdentifierTable{};
+    auto id = table.intern({ "Total%", 6 });
+    (void)table.intern({ "TOTAL%", 6 });
+    EXPECT_EQ(std::string(table.getName(id).getText(), size_t(table.getName(id).getLength())), "Total%");
+}
+
+TEST(ZeeBasic_Compiler_IdentifierTable, Growth)
+{
+    auto table = IdentifierTable{};
+    for (auto i = 0; i < 10000; ++i)
+    {
+        auto name = "var" + std::to_string(i);
+        EXPECT_EQ(table.intern({ name.c_str(), int(name.size()) }), i);
+    }
+
+    for (auto i = 0; i < 10000; ++i)
+    {
+        auto name = "VAR" + std::to_string(i);
+        EXPECT_EQ(table.find({ name.c_str(), int(name.size()) }), i);
+    }
+    EXPECT_EQ(table.getCount(), 10000);
+}
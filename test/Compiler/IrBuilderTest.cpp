@@ -0,0 +1,142 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/IrBuilder.hpp"
+
+using namespace ZeeBasic::Compiler;
+using namespace ZeeBasic::Compiler::Nodes;
+
+using BinaryOperator = BinaryExpressionNode::Operator;
+
+static const Type Boolean{ BaseType_Boolean };
+static const Type Integer{ BaseType_Integer };
+
+TEST(ZeeBasic_Compiler_IrBuilder, StraightLine)
+{
+    // x = 2 : x = x + 3 : PRINT x
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    builder.setBlock(builder.createBlock());
+    builder.sealBlock(0);
+
+    builder.writeVariable(0, builder.constant(int64_t(2)));
+    auto three = builder.constant(int64_t(3));
+    builder.writeVariable(0, builder.binary(BinaryOperator::Add, Integer, builder.readVariable(0, Integer), three));
+    builder.print(builder.readVariable(0, Integer));
+    builder.ret();
+
+    EXPECT_EQ(function.dump(),
+        "block0:\n"
+        "  %0 = const int 2\n"
+        "  %1 = const int 3\n"
+        "  %2 = add int %0, %1\n"
+        "  print %2\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_IrBuilder, Diamond)
+{
+    // IF c THEN x = 1 ELSE x = 2 : PRINT x
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    auto entry = builder.createBlock();
+    auto whenTrue = builder.createBlock();
+    auto whenFalse = builder.createBlock();
+    auto join = builder.createBlock();
+
+    builder.setBlock(entry);
+    builder.sealBlock(entry);
+    builder.branch(builder.constant(true), whenTrue, whenFalse);
+
+    builder.setBlock(whenTrue);
+    builder.sealBlock(whenTrue);
+    builder.writeVariable(0, builder.constant(int64_t(1)));
+    builder.jump(join);
+
+    builder.setBlock(whenFalse);
+    builder.sealBlock(whenFalse);
+    builder.writeVariable(0, builder.constant(int64_t(2)));
+    builder.jump(join);
+
+    builder.setBlock(join);
+    builder.sealBlock(join);
+    builder.print(builder.readVariable(0, Integer));
+    builder.ret();
+
+    EXPECT_EQ(function.dump(),
+        "block0:\n"
+        "  %0 = const bool true\n"
+        "  branch %0, block1, block2\n"
+        "block1:\n"
+        "  %2 = const int 1\n"
+        "  jump block3\n"
+        "block2:\n"
+        "  %4 = const int 2\n"
+        "  jump block3\n"
+        "block3:\n"
+        "  %6 = phi int [%2, block1], [%4, block2]\n"
+        "  print %6\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_IrBuilder, LoopWithoutWrite)
+{
+    // a loop that only reads x needs no phi once its header is sealed
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    auto entry = builder.createBlock();
+    auto header = builder.createBlock();
+    auto exit = builder.createBlock();
+
+    builder.setBlock(entry);
+    builder.sealBlock(entry);
+    builder.writeVariable(0, builder.constant(int64_t(5)));
+    builder.jump(header);
+
+    builder.setBlock(header);
+    builder.print(builder.readVariable(0, Integer));
+    builder.branch(builder.constant(false), header, exit);
+    builder.sealBlock(header);
+
+    builder.setBlock(exit);
+    builder.sealBlock(exit);
+    builder.print(builder.readVariable(0, Integer));
+    builder.ret();
+
+    EXPECT_EQ(function.dump(),
+        "block0:\n"
+        "  %0 = const int 5\n"
+        "  jump block1\n"
+        "block1:\n"
+        "  print %0\n"
+        "  %4 = const bool false\n"
+        "  branch %4, block1, block2\n"
+        "block2:\n"
+        "  print %0\n"
+        "  ret\n");
+}
@@ -26,6 +26,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <vector>
 
 #include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
@@ -42,8 +43,6 @@ public:
     StringSourceReader(const char* code)
         :
         ISourceReader(),
-        m_lineNo(1),
-        m_colNo(1),
         m_text(code),
         m_offset(0)
     { }
@@ -51,8 +50,6 @@ public:
     ~StringSourceReader()
     { }
 
-    void getReadPosition(int& lineNo, int& colNo) override { lineNo = m_lineNo; colNo = m_colNo; }
-
     char readNextChar() override
     {
         if (m_text[m_offset] == 0)
@@ -60,22 +57,10 @@ public:
             return 0;
         }
 
-        if (m_text[m_offset] == '\n')
-        {
-            ++m_lineNo;
-            m_colNo = 1;
-        }
-        else
-        {
-            m_colNo++;
-        }
-
         return m_text[m_offset++];
     }
 
 private:
-    int m_lineNo;
-    int m_colNo;
     const char* m_text;
     int m_offset;
 };
@@ -343,6 +328,32 @@ static struct {
     }
 }
 
+TEST(ZeeBasic_Compiler_LexicalAnalyzer, KeywordsIgnoreCase)
+{
+    auto tokens = parseIntoTokens("print Print pRiNt lcase$ ElseIf");
+    ASSERT_EQ(tokens.size(), 6);
+    EXPECT_EQ(tokens[0].id, TokenId::Key_PRINT);
+    EXPECT_EQ(tokens[1].id, TokenId::Key_PRINT);
+    EXPECT_EQ(tokens[2].id, TokenId::Key_PRINT);
+    EXPECT_EQ(tokens[3].id, TokenId::Key_LCASE_S);
+    EXPECT_EQ(tokens[4].id, TokenId::Key_ELSEIF);
+}
+
+TEST(ZeeBasic_Compiler_LexicalAnalyzer, KeywordNearMisses)
+{
+    static const char* names[] = {
+        "A", "PRIN", "PRINTS", "PRINX", "PRINT_", "PRINT1", "PR1NT", "STR", "STR%", "STRING%", "LCASE", "ELSEIFX",
+        "RANDOMIZER", "XO", "ABSOLUTE", "A_S", "IN", "I2", nullptr
+    };
+    for (auto i = 0; names[i]; ++i)
+    {
+        auto tokens = parseIntoTokens(names[i]);
+        EXPECT_EQ(tokens.size(), 2);
+        EXPECT_TRUE(tokens[0].id == TokenId::UntypedName || tokens[0].id == TokenId::TypedName) << names[i];
+        EXPECT_EQ(tokens[0].text, names[i]);
+    }
+}
+
 TEST(ZeeBasic_Compiler_LexicalAnalyzer, Symbols)
 {
     static struct {
@@ -377,3 +388,89 @@ TEST(ZeeBasic_Compiler_LexicalAnalyzer, Symbols)
         EXPECT_EQ(tokens[1].id, TokenId::EndOfCode);
     }
 }
+
+std::vector<Token> parseBufferIntoTokens(const char* code, ScanLevel scanLevel = ScanLevel::Scalar)
+{
+    auto lexicalAnalyzer = LexicalAnalyzer{ code, strlen(code), scanLevel };
+    auto tokens = std::vector<Token>{};
+    do {
+        auto token = lexicalAnalyzer.parseNextToken();
+        tokens.push_back(token);
+        if (token.id == TokenId::EndOfCode)
+        {
+            break;
+        }
+    } while (true);
+
+    return tokens;
+}
+
+TEST(ZeeBasic_Compiler_LexicalAnalyzer, BufferMatchesStreaming)
+{
+    static const char* sources[] = {
+        "",
+        "\n",
+        "23",
+        "  \t\t  23\t  ",
+        "' comment 1\n'comment 2",
+        "\n  \n\n  \t\t\n",
+        "PRINT -(2 + 3)\n",
+        "a$ = \"hello\" + b$ ' greet\nPRINT a$\n",
+        "x% = 1.5 * .25 / 3. \\ 2 MOD 7\n",
+        "IF a <= b AND c >= d OR e <> f XOR g < h THEN\n",
+        "strVar$ boolVar? intVar% realVar! under_score1\n",
+        "PRINT STR$(42) : PRINT Len(\"\") ; . , ..5",
+        "\n\nname\n  \"string with  spaces\"\n\t=\n",
+        "x = 1                                         \t\t   \t                    + 2\n",
+        "' a comment long enough to span several blocks of the widest scanner, and then some more\nPRINT 1",
+        "PRINT \"a string literal long enough to span several blocks of the widest scanner\" ; \"\"\n",
+        "                                                                ' indented comment",
+        nullptr
+    };
+    for (auto level : { ScanLevel::Scalar, ScanLevel::SSE2, ScanLevel::AVX2 })
+    {
+        for (auto i = 0; sources[i]; ++i)
+        {
+            auto streamed = parseIntoTokens(sources[i]);
+            auto buffered = parseBufferIntoTokens(sources[i], level);
+            ASSERT_EQ(streamed.size(), buffered.size()) << sources[i];
+            for (size_t j = 0; j < streamed.size(); ++j)
+            {
+                EXPECT_EQ(streamed[j].id, buffered[j].id) << sources[i];
+                EXPECT_EQ(streamed[j].location, buffered[j].location) << sources[i];
+                EXPECT_EQ(streamed[j].text, buffered[j].text) << sources[i];
+                EXPECT_EQ(streamed[j].text.getLength(), buffered[j].text.getLength()) << sources[i];
+            }
+        }
+    }
+}
+
+TEST(ZeeBasic_Compiler_LexicalAnalyzer, BufferErrorsMatchStreaming)
+{
+    static const char* sources[] = {
+        "~",
+        "ab~",
+        "boolVar??",
+        "\n  x = _y",
+        "PRINT \"unterminated string\n\"",
+        "PRINT \"unterminated string",
+        "PRINT \"a string literal long enough to span several blocks of the widest scanner\n\"",
+        "PRINT \"a string literal long enough to span several blocks of the widest scanner",
+        nullptr
+    };
+    for (auto level : { ScanLevel::Scalar, ScanLevel::SSE2, ScanLevel::AVX2 })
+    {
+        for (auto i = 0; sources[i]; ++i)
+        {
+            auto streamedError = std::string{};
+            auto bufferedError = std::string{};
+            auto streamedLocation = SourceLocation{};
+            auto bufferedLocation = SourceLocation{};
+            try { parseIntoTokens(sources[i]); } catch (const Error& e) { streamedError = e.what(); streamedLocation = e.getLocation(); }
+            try { parseBufferIntoTokens(sources[i], level); } catch (const Error& e) { bufferedError = e.what(); bufferedLocation = e.getLocation(); }
+            EXPECT_FALSE(streamedError.empty()) << sources[i];
+            EXPECT_EQ(streamedError, bufferedError) << sources[i];
+            EXPECT_EQ(streamedLocation, bufferedLocation) << sources[i];
+        }
+    }
+}
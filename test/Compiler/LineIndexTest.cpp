@@ -0,0 +1,88 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/LineIndex.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+TEST(ZeeBasic_Compiler_LineIndex, Empty)
+{
+    auto lines = LineIndex{};
+    EXPECT_EQ(lines.getLineCount(), 1);
+    EXPECT_EQ(lines.getRange(SourceLocation{ 0 }), (Range{ 1, 1 }));
+
+    auto empty = LineIndex{ "", 0 };
+    EXPECT_EQ(empty.getLineCount(), 1);
+    EXPECT_EQ(empty.getRange(SourceLocation{ 0 }), (Range{ 1, 1 }));
+}
+
+TEST(ZeeBasic_Compiler_LineIndex, Lines)
+{
+    auto source = std::string{ "a = 1\n\nPRINT a\n" };
+    auto lines = LineIndex{ source.data(), source.size() };
+    EXPECT_EQ(lines.getLineCount(), 4);
+    EXPECT_EQ(lines.getRange(SourceLocation{ 0 }), (Range{ 1, 1 }));
+    EXPECT_EQ(lines.getRange(SourceLocation{ 4 }), (Range{ 1, 5 }));
+    EXPECT_EQ(lines.getRange(SourceLocation{ 5 }), (Range{ 1, 6 }));
+    EXPECT_EQ(lines.getRange(SourceLocation{ 6 }), (Range{ 2, 1 }));
+    EXPECT_EQ(lines.getRange(SourceLocation{ 7 }), (Range{ 3, 1 }));
+    EXPECT_EQ(lines.getRange(SourceLocation{ 13 }), (Range{ 3, 7 }));
+    EXPECT_EQ(lines.getRange(SourceLocation{ 15 }), (Range{ 4, 1 }));
+    EXPECT_EQ(lines.getRange(SourceLocation{ 20 }), (Range{ 4, 1 }));
+}
+
+TEST(ZeeBasic_Compiler_LineIndex, WideLines)
+{
+    // columns and lines well past what fits in a byte
+    auto source = std::string{};
+    for (auto i = 0; i < 300; ++i)
+    {
+        source += std::string(size_t(i * 7), ' ') + "x\n";
+    }
+
+    auto lines = LineIndex{ source.data(), source.size() };
+    EXPECT_EQ(lines.getLineCount(), 301);
+
+    auto offset = size_t(0);
+    for (auto i = 0; i < 300; ++i)
+    {
+        offset += size_t(i * 7);
+        EXPECT_EQ(lines.getRange(SourceLocation{ uint32_t(offset) }), (Range{ i + 1, i * 7 + 1 })) << i;
+        offset += 2;
+    }
+}
+
+TEST(ZeeBasic_Compiler_LineIndex, StopsAtNull)
+{
+    auto source = std::string{ "a\nb\0c\nd", 7 };
+    auto lines = LineIndex{ source.data(), source.size() };
+    EXPECT_EQ(lines.getLineCount(), 2);
+    EXPECT_EQ(lines.getRange(SourceLocation{ 3 }), (Range{ 2, 2 }));
+}
@@ -0,0 +1,105 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/MappedSourceReader.hpp"
+
+#include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+TEST(ZeeBasic_Compiler_MappedSourceReader, Initialization)
+{
+    EXPECT_THROW(MappedSourceReader{ "bad.file" }, std::runtime_error);
+
+    std::ofstream{ "mapped.zee" } << "Test File";
+    EXPECT_NO_THROW(MappedSourceReader{ "mapped.zee" });
+    std::filesystem::remove("mapped.zee");
+
+    std::ofstream{ "mapped_empty.zee" };
+    {
+        auto reader = MappedSourceReader{ "mapped_empty.zee" };
+        EXPECT_EQ(reader.getSize(), 0);
+        EXPECT_EQ(reader.readNextChar(), 0);
+    }
+    std::filesystem::remove("mapped_empty.zee");
+}
+
+TEST(ZeeBasic_Compiler_MappedSourceReader, ReadData)
+{
+    std::ofstream{ "mapped2.zee" } << "File\nWith\nNewlines";
+    {
+        auto reader = MappedSourceReader{ "mapped2.zee" };
+        EXPECT_EQ(reader.getSize(), 18);
+        EXPECT_EQ(memcmp(reader.getData(), "File\nWith\nNewlines", 18), 0);
+
+        EXPECT_EQ(reader.readNextChar(), 'F');
+        EXPECT_EQ(reader.getRange(SourceLocation{ 1 }), (Range{ 1, 2 }));
+
+        for (auto i = 0; i < 4; ++i)
+        {
+            (void)reader.readNextChar();
+        }
+
+        EXPECT_EQ(reader.getRange(SourceLocation{ 5 }), (Range{ 2, 1 }));
+
+        for (auto i = 0; i < 13; ++i)
+        {
+            (void)reader.readNextChar();
+        }
+
+        EXPECT_EQ(reader.readNextChar(), 0);
+    }
+    std::filesystem::remove("mapped2.zee");
+}
+
+TEST(ZeeBasic_Compiler_MappedSourceReader, ZeroCopyTokens)
+{
+    std::ofstream{ "mapped3.zee" } << "PRINT name$ + \"text\" ' comment\nx = 1.5";
+    {
+        auto reader = MappedSourceReader{ "mapped3.zee" };
+        auto begin = reader.getData();
+        auto end = begin + reader.getSize();
+
+        auto lexicalAnalyzer = LexicalAnalyzer{ reader };
+        auto count = 0;
+        for (auto token = lexicalAnalyzer.parseNextToken(); token.id != TokenId::EndOfCode; token = lexicalAnalyzer.parseNextToken())
+        {
+            if (token.text.getLength() > 0)
+            {
+                EXPECT_GE(token.text.getText(), begin);
+                EXPECT_LE(token.text.getText() + token.text.getLength(), end);
+            }
+            ++count;
+        }
+        EXPECT_EQ(count, 8);
+    }
+    std::filesystem::remove("mapped3.zee");
+}
@@ -0,0 +1,113 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/NodeArena.hpp"
+
+using namespace ZeeBasic::Compiler;
+using namespace ZeeBasic::Compiler::Nodes;
+
+class CountedNode
+    :
+    public Node
+{
+public:
+    CountedNode(int& liveCount, int value) : m_liveCount(liveCount), value(value) { ++m_liveCount; }
+    ~CountedNode() { --m_liveCount; }
+
+    void parse(IParser&) override { }
+    void translate(ITranslator&) const override { }
+
+    int& m_liveCount;
+    int value;
+};
+
+class alignas(64) AlignedNode
+    :
+    public Node
+{
+public:
+    void parse(IParser&) override { }
+    void translate(ITranslator&) const override { }
+
+    char data[100];
+};
+
+TEST(ZeeBasic_Compiler_NodeArena, Create)
+{
+    auto liveCount = 0;
+    {
+        auto arena = NodeArena{};
+        EXPECT_EQ(arena.getNodeCount(), 0);
+        EXPECT_EQ(arena.getBlockCount(), 0);
+
+        auto first = arena.create<CountedNode>(liveCount, 1);
+        auto second = arena.create<CountedNode>(liveCount, 2);
+        EXPECT_EQ(first->value, 1);
+        EXPECT_EQ(second->value, 2);
+        EXPECT_EQ(liveCount, 2);
+        EXPECT_EQ(arena.getNodeCount(), 2);
+        EXPECT_EQ(arena.getBlockCount(), 1);
+
+        // nodes are packed one after the other
+        EXPECT_LT(reinterpret_cast<char*>(first), reinterpret_cast<char*>(second));
+        EXPECT_LE(reinterpret_cast<char*>(second) - reinterpret_cast<char*>(first), 2 * sizeof(CountedNode));
+    }
+    EXPECT_EQ(liveCount, 0);
+}
+
+TEST(ZeeBasic_Compiler_NodeArena, ManyBlocks)
+{
+    auto liveCount = 0;
+    auto arena = NodeArena{};
+    auto count = int(4 * NodeArena::kBlockSize / sizeof(CountedNode));
+    auto nodes = std::vector<CountedNode*>{};
+    for (auto i = 0; i < count; ++i)
+    {
+        nodes.push_back(arena.create<CountedNode>(liveCount, i));
+        auto aligned = arena.create<AlignedNode>();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % alignof(AlignedNode), 0);
+    }
+
+    EXPECT_EQ(liveCount, count);
+    EXPECT_GT(arena.getBlockCount(), 4);
+    for (auto i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(nodes[i]->value, i);
+    }
+
+    arena.clear();
+    EXPECT_EQ(liveCount, 0);
+    EXPECT_EQ(arena.getNodeCount(), 0);
+    EXPECT_EQ(arena.getBlockCount(), 1);
+
+    EXPECT_EQ(arena.create<CountedNode>(liveCount, 7)->value, 7);
+    EXPECT_EQ(arena.getBlockCount(), 1);
+}
@@ -0,0 +1,115 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/ParallelLexer.hpp"
+
+#include "ZeeBasic/Compiler/Error.hpp"
+#include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+static std::vector<Token> parseSequentially(const std::string& source)
+{
+    auto lexicalAnalyzer = LexicalAnalyzer{ source.data(), source.size() };
+    auto tokens = std::vector<Token>{};
+    do {
+        tokens.push_back(lexicalAnalyzer.parseNextToken());
+    } while (tokens.back().id != TokenId::EndOfCode);
+
+    return tokens;
+}
+
+static std::string generateSource(int lineCount)
+{
+    static const char* lines[] = {
+        "total% = total% + value% * 3 ' running sum\n",
+        "PRINT \"item number \" + STR$(index%)\n",
+        "\n",
+        "    ' indented comment\n",
+        "ratio! = 1.5 / (count% + .25) - offset!\n",
+        "done? = index% >= limit% AND NOT failed? : PRINT done?\n",
+    };
+
+    auto source = std::string{};
+    for (auto i = 0; i < lineCount; ++i)
+    {
+        source += lines[i % (sizeof(lines) / sizeof(lines[0]))];
+    }
+    return source;
+}
+
+static void expectSameTokens(const std::string& source, unsigned threadCount, size_t chunkSize)
+{
+    auto expected = parseSequentially(source);
+    auto actual = ParallelLexer{ source.data(), source.size(), threadCount, chunkSize }.run();
+    ASSERT_EQ(expected.size(), actual.getCount());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        auto token = actual.getToken(i);
+        EXPECT_EQ(expected[i].id, token.id) << i;
+        EXPECT_EQ(expected[i].location, token.location) << i;
+        EXPECT_EQ(expected[i].text.getText(), token.text.getText()) << i;
+        EXPECT_EQ(expected[i].text.getLength(), token.text.getLength()) << i;
+    }
+}
+
+TEST(ZeeBasic_Compiler_ParallelLexer, MatchesSequential)
+{
+    auto source = generateSource(2000);
+    for (auto chunkSize : { size_t(1), size_t(7), size_t(100), size_t(4096), ParallelLexer::kDefaultChunkSize })
+    {
+        expectSameTokens(source, 4, chunkSize);
+        expectSameTokens(source, 1, chunkSize);
+    }
+}
+
+TEST(ZeeBasic_Compiler_ParallelLexer, EdgeCases)
+{
+    expectSameTokens("", 4, 16);
+    expectSameTokens("\n", 4, 1);
+    expectSameTokens("\n\n\n", 4, 1);
+    expectSameTokens("PRINT 1\nPRINT 2", 4, 1);
+    expectSameTokens("PRINT \"a line much longer than a chunk\"\nx = 1\n", 4, 4);
+    expectSameTokens(std::string{ "PRINT 1\nPRINT 2\n\0PRINT ~\n", 25 }, 4, 4);
+}
+
+TEST(ZeeBasic_Compiler_ParallelLexer, FirstErrorWins)
+{
+    auto source = generateSource(500) + "x = ~\n" + generateSource(500) + "PRINT \"unterminated\n";
+
+    auto expected = std::string{};
+    try { parseSequentially(source); } catch (const Error& e) { expected = e.what(); }
+    ASSERT_FALSE(expected.empty());
+
+    auto actual = std::string{};
+    try { ParallelLexer{ source.data(), source.size(), 4, 64 }.run(); } catch (const Error& e) { actual = e.what(); }
+    EXPECT_EQ(expected, actual);
+}
@@ -0,0 +1,239 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "ZeeBasic/Compiler/Parser.hpp"
+
+#include "ZeeBasic/Compiler/BinaryExpressionNode.hpp"
+#include "ZeeBasic/Compiler/CastExpressionNode.hpp"
+#include "ZeeBasic/Compiler/Error.hpp"
+#include "ZeeBasic/Compiler/ISourceReader.hpp"
+#include "ZeeBasic/Compiler/Pipeline.hpp"
+#include "ZeeBasic/Compiler/PrintStatementNode.hpp"
+#include "ZeeBasic/Compiler/Program.hpp"
+
+using namespace ZeeBasic::Compiler;
+using namespace ZeeBasic::Compiler::Nodes;
+
+class StringSourceReader
+    :
+    public ISourceReader
+{
+public:
+    StringSourceReader(const char* code)
+        :
+        ISourceReader(),
+        m_text(code),
+        m_offset(0)
+    { }
+
+    ~StringSourceReader()
+    { }
+
+    char readNextChar() override
+    {
+        if (m_text[m_offset] == 0)
+        {
+            return 0;
+        }
+
+        return m_text[m_offset++];
+    }
+
+    Range getRange(SourceLocation location) const override
+    {
+        auto line = 1;
+        auto col = 1;
+        for (uint32_t i = 0; i < location.offset && m_text[i]; ++i)
+        {
+            if (m_text[i] == '\n')
+            {
+                ++line;
+                col = 1;
+            }
+            else
+            {
+                ++col;
+            }
+        }
+        return Range{ line, col };
+    }
+
+private:
+    const char* m_text;
+    int m_offset;
+};
+
+// the message of the error parsing a program, or an empty string if it parses
+static std::string parseError(const char* code)
+{
+    auto reader = StringSourceReader{ code };
+    auto program = Program{};
+    try
+    {
+        Parser{ reader, program }.run();
+    }
+    catch (const Error& error)
+    {
+        return error.what();
+    }
+    return "";
+}
+
+// the SSA form of a program as parsed, flattened and lowered, without optimizing
+static std::string lower(const char* code)
+{
+    auto reader = StringSourceReader{ code };
+    auto program = Program{};
+    Parser{ reader, program }.run();
+    Pipeline{ program, Pass_None }.run();
+    return program.ir.dump();
+}
+
+TEST(ZeeBasic_Compiler_Parser, BuiltinArgumentCount)
+{
+    EXPECT_EQ(parseError("PRINT MID$(\"abc\")\n"), "[1:7] Bad arguments for built-in function");
+    EXPECT_EQ(parseError("PRINT LEN(\"a\", \"b\")\n"), "[1:7] Bad arguments for built-in function");
+    EXPECT_EQ(parseError("PRINT INSTR(\"abc\")\n"), "[1:7] Bad arguments for built-in function");
+    EXPECT_EQ(parseError("PRINT LEN(\"a\",)\n"), "[1:15] Expected argument for function call");
+
+    // an optional argument may be left out, and a function without arguments needs no parentheses
+    EXPECT_EQ(parseError("PRINT MID$(\"abc\", 2)\nPRINT MID$(\"abc\", 2, 1)\nPRINT RND\n"), "");
+}
+
+TEST(ZeeBasic_Compiler_Parser, BuiltinArgumentType)
+{
+    EXPECT_EQ(parseError("PRINT LEN(1)\n"), "[1:11] Expected string argument for built-in function");
+    EXPECT_EQ(parseError("PRINT SQR(\"4\")\n"), "[1:11] Expected numeric argument for built-in function");
+    EXPECT_EQ(parseError("PRINT ABS(\"4\")\n"), "[1:11] Expected numeric argument for built-in function");
+    EXPECT_EQ(parseError("PRINT CHR$(65.0)\n"), "[1:12] Expected integer argument for built-in function");
+    EXPECT_EQ(parseError("PRINT LEFT$(\"abc\", \"1\")\n"), "[1:20] Expected integer argument for built-in function");
+    EXPECT_EQ(parseError("PRINT SIN(TRUE)\n"), "[1:11] Expected numeric argument for built-in function");
+}
+
+TEST(ZeeBasic_Compiler_Parser, BuiltinCasts)
+{
+    // a Real argument is cast from an integer, while a Number argument is taken as it is and, for a Number result,
+    // gives the result its type
+    EXPECT_EQ(lower("i = RND\nr! = RND\nPRINT SQR(i)\nPRINT SQR(r!)\nPRINT ABS(i)\nPRINT ABS(r!)\nPRINT INT(r!)\n"),
+        "block0:\n"
+        "  %0 = call real RND\n"
+        "  %1 = cast int %0\n"
+        "  %2 = call real RND\n"
+        "  %3 = cast real %1\n"
+        "  %4 = call real SQR %3\n"
+        "  print %4\n"
+        "  %6 = call real SQR %2\n"
+        "  print %6\n"
+        "  %8 = call int ABS %1\n"
+        "  print %8\n"
+        "  %10 = call real ABS %2\n"
+        "  print %10\n"
+        "  %12 = call int INT %2\n"
+        "  print %12\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_Parser, LegalOperations)
+{
+    enum class Cast { None, Left, Right };
+
+    static const struct {
+        const char* expression;
+        int resultType;
+        Cast cast;
+    } operations[] = {
+        { "1 + 2", BaseType_Integer, Cast::None },
+        { "7 MOD 2", BaseType_Integer, Cast::None },
+        { "1 AND 3", BaseType_Integer, Cast::None },
+        { "1 / 2", BaseType_Real, Cast::None },
+        { "1.5 \\ 0.5", BaseType_Integer, Cast::None },
+        { "1.5 - 0.5", BaseType_Real, Cast::None },
+        { "1 < 2", BaseType_Boolean, Cast::None },
+        { "TRUE AND FALSE", BaseType_Boolean, Cast::None },
+        { "TRUE <> FALSE", BaseType_Boolean, Cast::None },
+        { "\"a\" + \"b\"", BaseType_String, Cast::None },
+
+        // an integer meeting a real is cast up to real, on whichever side it is
+        { "1 + 1.5", BaseType_Real, Cast::Left },
+        { "1.5 * 2", BaseType_Real, Cast::Right },
+        { "1 / 2.5", BaseType_Real, Cast::Left },
+        { "2.5 \\ 2", BaseType_Integer, Cast::Right },
+        { "1 < 1.5", BaseType_Boolean, Cast::Left },
+        { "1.5 = 2", BaseType_Boolean, Cast::Right },
+    };
+
+    for (const auto& operation : operations)
+    {
+        auto code = std::string{ "PRINT " } + operation.expression + "\n";
+        auto reader = StringSourceReader{ code.c_str() };
+        auto program = Program{};
+        Parser{ reader, program }.run();
+
+        auto print = dynamic_cast<const PrintStatementNode*>(program.statements[0]);
+        auto binary = dynamic_cast<const BinaryExpressionNode*>(print->getExpression());
+        ASSERT_NE(binary, nullptr) << operation.expression;
+        EXPECT_EQ(binary->getType().base, operation.resultType) << operation.expression;
+
+        auto left = dynamic_cast<const CastExpressionNode*>(&binary->getLeft());
+        auto right = dynamic_cast<const CastExpressionNode*>(&binary->getRight());
+        EXPECT_EQ(left != nullptr, operation.cast == Cast::Left) << operation.expression;
+        EXPECT_EQ(right != nullptr, operation.cast == Cast::Right) << operation.expression;
+        if (left || right)
+        {
+            EXPECT_EQ((left ? left : right)->getType().base, BaseType_Real) << operation.expression;
+        }
+    }
+}
+
+TEST(ZeeBasic_Compiler_Parser, IllegalOperations)
+{
+    static const struct {
+        const char* expression;
+        const char* error;
+    } operations[] = {
+        { "TRUE + FALSE", "Operation not allowed on boolean types" },
+        { "1.5 AND 2.5", "Bitwise operation not allowed on real types" },
+        { "1 OR 2.5", "Bitwise operation not allowed on real types" },
+        { "\"a\" - \"b\"", "Operation not allowed on string types" },
+        { "\"a\" < \"b\"", "Operation not allowed on string types" },
+        { "\"a\" + 1", "Unable to implicitly cast type to string" },
+        { "1.5 + \"a\"", "Unable to implicitly cast type to string" },
+        { "1 + TRUE", "Implicit cast between integer and boolean not allowed" },
+        { "FALSE = 0", "Implicit cast between integer and boolean not allowed" },
+        { "TRUE OR 1.5", "Implicit cast between real and boolean not allowed" },
+        { "1.5 < FALSE", "Implicit cast between real and boolean not allowed" },
+    };
+
+    for (const auto& operation : operations)
+    {
+        auto code = std::string{ "PRINT " } + operation.expression + "\n";
+        EXPECT_EQ(parseError(code.c_str()), std::string{ "[1:7] " } + operation.error) << operation.expression;
+    }
+}
@@ -0,0 +1,200 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "ZeeBasic/Compiler/Pipeline.hpp"
+
+#include "ZeeBasic/Compiler/Error.hpp"
+#include "ZeeBasic/Compiler/ISourceReader.hpp"
+#include "ZeeBasic/Compiler/Parser.hpp"
+#include "ZeeBasic/Compiler/Program.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+class StringSourceReader
+    :
+    public ISourceReader
+{
+public:
+    StringSourceReader(const char* code)
+        :
+        ISourceReader(),
+        m_text(code),
+        m_offset(0)
+    { }
+
+    ~StringSourceReader()
+    { }
+
+    char readNextChar() override
+    {
+        if (m_text[m_offset] == 0)
+        {
+            return 0;
+        }
+
+        return m_text[m_offset++];
+    }
+
+private:
+    const char* m_text;
+    int m_offset;
+};
+
+static std::string compile(const char* code, uint32_t passes)
+{
+    auto reader = StringSourceReader{ code };
+    auto program = Program{};
+    Parser{ reader, program }.run();
+    Pipeline{ program, passes }.run();
+    return program.ir.dump();
+}
+
+static const char* kProgram =
+    "a = 2\n"
+    "r = RND\n"
+    "b = r * a\n"
+    "c = r * a\n"
+    "d = r + 1\n"
+    "PRINT b + c\n"
+    "PRINT a * 3\n";
+
+TEST(ZeeBasic_Compiler_Pipeline, ParserOnlyParses)
+{
+    auto reader = StringSourceReader{ kProgram };
+    auto program = Program{};
+    Parser{ reader, program }.run();
+
+    EXPECT_EQ(program.statements.size(), 7);
+    EXPECT_EQ(program.ast.getCount(), 0);
+    EXPECT_EQ(program.ir.getInstructionCount(), 0);
+}
+
+TEST(ZeeBasic_Compiler_Pipeline, NoPasses)
+{
+    EXPECT_EQ(compile(kProgram, Pass_None),
+        "block0:\n"
+        "  %0 = const int 2\n"
+        "  %1 = call real RND\n"
+        "  %2 = cast int %1\n"
+        "  %3 = mul int %2, %0\n"
+        "  %4 = mul int %2, %0\n"
+        "  %5 = const int 1\n"
+        "  %6 = add int %2, %5\n"
+        "  %7 = add int %3, %4\n"
+        "  print %7\n"
+        "  %9 = const int 3\n"
+        "  %10 = mul int %0, %9\n"
+        "  print %10\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_Pipeline, ConstantPropagation)
+{
+    EXPECT_EQ(compile(kProgram, Pass_ConstantPropagation),
+        "block0:\n"
+        "  %0 = const int 2\n"
+        "  %1 = call real RND\n"
+        "  %2 = cast int %1\n"
+        "  %3 = mul int %2, %0\n"
+        "  %4 = mul int %2, %0\n"
+        "  %5 = const int 1\n"
+        "  %6 = add int %2, %5\n"
+        "  %7 = add int %3, %4\n"
+        "  print %7\n"
+        "  %9 = const int 3\n"
+        "  %10 = const int 6\n"
+        "  print %10\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_Pipeline, ValueNumbering)
+{
+    EXPECT_EQ(compile(kProgram, Pass_ValueNumbering),
+        "block0:\n"
+        "  %0 = const int 2\n"
+        "  %1 = call real RND\n"
+        "  %2 = cast int %1\n"
+        "  %3 = mul int %2, %0\n"
+        "  %5 = const int 1\n"
+        "  %6 = add int %2, %5\n"
+        "  %7 = add int %3, %3\n"
+        "  print %7\n"
+        "  %9 = const int 3\n"
+        "  %10 = mul int %0, %9\n"
+        "  print %10\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_Pipeline, DeadCodeElimination)
+{
+    EXPECT_EQ(compile(kProgram, Pass_DeadCodeElimination),
+        "block0:\n"
+        "  %0 = const int 2\n"
+        "  %1 = call real RND\n"
+        "  %2 = cast int %1\n"
+        "  %3 = mul int %2, %0\n"
+        "  %4 = mul int %2, %0\n"
+        "  %7 = add int %3, %4\n"
+        "  print %7\n"
+        "  %9 = const int 3\n"
+        "  %10 = mul int %0, %9\n"
+        "  print %10\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_Pipeline, AllPasses)
+{
+    EXPECT_EQ(compile(kProgram, Pass_All),
+        "block0:\n"
+        "  %0 = const int 2\n"
+        "  %1 = call real RND\n"
+        "  %2 = cast int %1\n"
+        "  %3 = mul int %2, %0\n"
+        "  %7 = add int %3, %3\n"
+        "  print %7\n"
+        "  %10 = const int 6\n"
+        "  print %10\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_Pipeline, Folding)
+{
+    // folding is not a pass that can be turned off, as CONST depends on it
+    EXPECT_EQ(compile("CONST x = 2 * 3\nPRINT x + 1\n", Pass_None),
+        "block0:\n"
+        "  %0 = const int 7\n"
+        "  print %0\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_Pipeline, Errors)
+{
+    EXPECT_THROW(compile("a = 1\nCONST x = a\n", Pass_All), Error);
+}
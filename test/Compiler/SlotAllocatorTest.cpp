@@ -0,0 +1,178 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/IrBuilder.hpp"
+#include "ZeeBasic/Compiler/SlotAllocator.hpp"
+
+using namespace ZeeBasic::Compiler;
+using namespace ZeeBasic::Compiler::Nodes;
+
+using BinaryOperator = BinaryExpressionNode::Operator;
+
+static const Type Integer{ BaseType_Integer };
+static const Type String{ BaseType_String };
+
+TEST(ZeeBasic_Compiler_SlotAllocator, StraightLine)
+{
+    // a = INT(RND) : b = a * 2 : PRINT b + a : PRINT b
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    builder.setBlock(builder.createBlock());
+    builder.sealBlock(0);
+
+    auto a = builder.cast(Integer, builder.call(*getBuiltin(TokenId::Key_RND), Type{ BaseType_Real }, {}));
+    auto b = builder.binary(BinaryOperator::Multiply, Integer, a, builder.constant(int64_t(2)));
+    auto sum = builder.binary(BinaryOperator::Add, Integer, b, a);
+    builder.print(sum);
+    builder.print(b);
+    builder.ret();
+
+    auto inlined = std::vector<bool>(function.getInstructionCount(), false);
+    auto slots = SlotAllocator{ function, inlined };
+    slots.run();
+
+    // the sum takes the slot of a, which is last used by it
+    EXPECT_EQ(slots.getSlot(a), 0u);
+    EXPECT_EQ(slots.getSlot(b), 1u);
+    EXPECT_EQ(slots.getSlot(sum), 0u);
+    EXPECT_EQ(slots.getSlotCount(BaseType_Integer), 2u);
+    EXPECT_EQ(slots.getSlotCount(BaseType_Real), 1u);
+}
+
+TEST(ZeeBasic_Compiler_SlotAllocator, Strings)
+{
+    // a$ = INKEY$ : b$ = a$ + a$ : PRINT b$ : c$ = INKEY$ : PRINT c$
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    builder.setBlock(builder.createBlock());
+    builder.sealBlock(0);
+
+    auto a = builder.call(*getBuiltin(TokenId::Key_INKEY_S), String, {});
+    auto b = builder.binary(BinaryOperator::Add, String, a, a);
+    builder.stringRelease(a);
+    builder.print(b);
+    builder.stringRelease(b);
+    auto c = builder.call(*getBuiltin(TokenId::Key_INKEY_S), String, {});
+    builder.print(c);
+    builder.stringRelease(c);
+    builder.ret();
+
+    auto inlined = std::vector<bool>(function.getInstructionCount(), false);
+    auto slots = SlotAllocator{ function, inlined };
+    slots.run();
+
+    // a string is never built in the slot of one it is made from
+    EXPECT_EQ(slots.getSlot(a), 0u);
+    EXPECT_EQ(slots.getSlot(b), 1u);
+    EXPECT_EQ(slots.getSlot(c), 0u);
+    EXPECT_EQ(slots.getSlotCount(BaseType_String), 2u);
+    EXPECT_EQ(slots.getReleases(b), std::vector<uint32_t>{ a });
+}
+
+TEST(ZeeBasic_Compiler_SlotAllocator, Append)
+{
+    // s$ = INKEY$ : t$ = INKEY$ : s$ = s$ + t$ : PRINT s$ + t$
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    builder.setBlock(builder.createBlock());
+    builder.sealBlock(0);
+
+    auto s = builder.call(*getBuiltin(TokenId::Key_INKEY_S), String, {});
+    auto t = builder.call(*getBuiltin(TokenId::Key_INKEY_S), String, {});
+    auto appended = builder.binary(BinaryOperator::Add, String, s, t);
+    builder.stringRelease(s);
+    auto joined = builder.binary(BinaryOperator::Add, String, appended, t);
+    builder.print(joined);
+    builder.stringRelease(joined);
+    builder.stringRelease(t);
+    builder.stringRelease(appended);
+    builder.ret();
+
+    auto inlined = std::vector<bool>(function.getInstructionCount(), false);
+    auto slots = SlotAllocator{ function, inlined };
+    slots.run();
+
+    // neither s$ nor the first sum is read again, so both sums grow s$ in place
+    EXPECT_TRUE(slots.isAppend(appended));
+    EXPECT_EQ(slots.getSlot(appended), slots.getSlot(s));
+    EXPECT_TRUE(slots.isAppend(joined));
+    EXPECT_EQ(slots.getSlot(joined), slots.getSlot(s));
+    EXPECT_EQ(slots.getSlotCount(BaseType_String), 2u);
+}
+
+TEST(ZeeBasic_Compiler_SlotAllocator, Branches)
+{
+    // a = INT(RND) : IF c THEN x = a + 1 ELSE x = a + 2 : PRINT x : PRINT a
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    auto entry = builder.createBlock();
+    auto whenTrue = builder.createBlock();
+    auto whenFalse = builder.createBlock();
+    auto join = builder.createBlock();
+
+    builder.setBlock(entry);
+    builder.sealBlock(entry);
+    auto a = builder.cast(Integer, builder.call(*getBuiltin(TokenId::Key_RND), Type{ BaseType_Real }, {}));
+    builder.branch(builder.constant(true), whenTrue, whenFalse);
+
+    builder.setBlock(whenTrue);
+    builder.sealBlock(whenTrue);
+    auto one = builder.binary(BinaryOperator::Add, Integer, a, builder.constant(int64_t(1)));
+    builder.writeVariable(0, one);
+    builder.jump(join);
+
+    builder.setBlock(whenFalse);
+    builder.sealBlock(whenFalse);
+    auto two = builder.binary(BinaryOperator::Add, Integer, a, builder.constant(int64_t(2)));
+    builder.writeVariable(0, two);
+    builder.jump(join);
+
+    builder.setBlock(join);
+    builder.sealBlock(join);
+    auto x = builder.readVariable(0, Integer);
+    builder.print(x);
+    builder.print(a);
+    builder.ret();
+
+    // constants are written where they are used
+    auto inlined = std::vector<bool>(function.getInstructionCount(), false);
+    for (uint32_t index = 0; index < function.getInstructionCount(); ++index)
+    {
+        inlined[index] = function.getInstruction(index).opcode == Ir::Opcode::Constant;
+    }
+    auto slots = SlotAllocator{ function, inlined };
+    slots.run();
+
+    // a is live through both arms, and the phi shares a slot with the values it merges
+    ASSERT_EQ(function.getInstruction(x).opcode, Ir::Opcode::Phi);
+    EXPECT_EQ(slots.getSlot(a), 0u);
+    EXPECT_EQ(slots.getSlot(one), 1u);
+    EXPECT_EQ(slots.getSlot(two), 1u);
+    EXPECT_EQ(slots.getSlot(x), 1u);
+    EXPECT_EQ(slots.getSlotCount(BaseType_Integer), 2u);
+}
@@ -0,0 +1,95 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/SourceScanner.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+static const ScanLevel kLevels[] = { ScanLevel::SSE2, ScanLevel::AVX2 };
+
+TEST(ZeeBasic_Compiler_SourceScanner, Levels)
+{
+    EXPECT_EQ(SourceScanner::get(ScanLevel::Scalar).level, ScanLevel::Scalar);
+    EXPECT_EQ(SourceScanner::get().level, SourceScanner::getBestLevel());
+    for (auto level : kLevels)
+    {
+        EXPECT_LE(SourceScanner::get(level).level, level);
+        EXPECT_LE(SourceScanner::get(level).level, SourceScanner::getBestLevel());
+    }
+}
+
+TEST(ZeeBasic_Compiler_SourceScanner, EmptyRange)
+{
+    auto text = "abc";
+    for (auto level : { ScanLevel::Scalar, ScanLevel::SSE2, ScanLevel::AVX2 })
+    {
+        auto& scanner = SourceScanner::get(level);
+        EXPECT_EQ(scanner.skipBlanks(text, text), text);
+        EXPECT_EQ(scanner.findLineEnd(text, text), text);
+        EXPECT_EQ(scanner.findStringEnd(text, text), text);
+    }
+}
+
+TEST(ZeeBasic_Compiler_SourceScanner, MatchesScalar)
+{
+    // runs of filler ending in each stop character, at every length and alignment up to a few blocks
+    static const char stops[] = { ' ', '\t', '\n', '"', 0, 'x', '\'' };
+    auto& scalar = SourceScanner::get(ScanLevel::Scalar);
+    for (auto level : kLevels)
+    {
+        auto& scanner = SourceScanner::get(level);
+        for (auto filler : { ' ', '\t', 'a' })
+        {
+            for (auto stop : stops)
+            {
+                for (auto offset = 0; offset < 33; ++offset)
+                {
+                    for (auto length = 0; length < 100; ++length)
+                    {
+                        // exact size so that a read past the end is visible to memory checkers
+                        auto buffer = std::vector<char>(size_t(offset + length + 1), filler);
+                        buffer.back() = stop;
+                        auto begin = buffer.data() + offset;
+                        auto end = buffer.data() + buffer.size();
+
+                        EXPECT_EQ(scanner.skipBlanks(begin, end), scalar.skipBlanks(begin, end));
+                        EXPECT_EQ(scanner.findLineEnd(begin, end), scalar.findLineEnd(begin, end));
+                        EXPECT_EQ(scanner.findStringEnd(begin, end), scalar.findStringEnd(begin, end));
+
+                        // and with the stop character excluded from the range
+                        EXPECT_EQ(scanner.skipBlanks(begin, end - 1), scalar.skipBlanks(begin, end - 1));
+                        EXPECT_EQ(scanner.findLineEnd(begin, end - 1), scalar.findLineEnd(begin, end - 1));
+                        EXPECT_EQ(scanner.findStringEnd(begin, end - 1), scalar.findStringEnd(begin, end - 1));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,216 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define pipe(fds) _pipe(fds, 65536, _O_BINARY)
+#define write _write
+#define close _close
+#else
+#include <unistd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/StreamSourceReader.hpp"
+
+#include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+// Pipe holding a whole (small) source, with the write end already closed.
+struct SourcePipe
+{
+    int fds[2];
+
+    SourcePipe(const std::string& source)
+    {
+        EXPECT_EQ(pipe(fds), 0);
+        EXPECT_EQ(write(fds[1], source.data(), unsigned(source.size())), int(source.size()));
+        close(fds[1]);
+    }
+
+    ~SourcePipe()
+    {
+        close(fds[0]);
+    }
+};
+
+TEST(ZeeBasic_Compiler_StreamSourceReader, ReadData)
+{
+    auto source = SourcePipe{ "File\nWith\nNewlines" };
+    auto reader = StreamSourceReader{ source.fds[0], 4 };
+
+    EXPECT_EQ(reader.readNextChar(), 'F');
+    EXPECT_EQ(reader.getRange(SourceLocation{ 1 }), (Range{ 1, 2 }));
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        (void)reader.readNextChar();
+    }
+
+    EXPECT_EQ(reader.readNextChar(), 'W');
+    EXPECT_EQ(reader.getRange(SourceLocation{ 4 }), (Range{ 1, 5 }));
+    EXPECT_EQ(reader.getRange(SourceLocation{ 5 }), (Range{ 2, 1 }));
+
+    for (auto i = 0; i < 11; ++i)
+    {
+        (void)reader.readNextChar();
+    }
+
+    EXPECT_EQ(reader.readNextChar(), 's');
+    EXPECT_EQ(reader.getRange(SourceLocation{ 17 }), (Range{ 3, 8 }));
+    EXPECT_EQ(reader.getRange(SourceLocation{ 18 }), (Range{ 3, 9 }));
+
+    // only the last two chunks are kept
+    EXPECT_EQ(reader.getRange(SourceLocation{ 1 }), Range{});
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(reader.readNextChar(), 0);
+    }
+}
+
+TEST(ZeeBasic_Compiler_StreamSourceReader, TokensSpanChunks)
+{
+    auto text = std::string{
+        "total% = total% + value% * 3 ' running sum\n"
+        "PRINT \"item number \" + STR$(index%)\n"
+        "ratio! = 1.5 / (count% + .25) - offset!\n"
+        "done? = index% >= limit% AND NOT failed? : PRINT done?" };
+
+    auto expected = std::vector<Token>{};
+    auto bufferLexer = LexicalAnalyzer{ text.data(), text.size() };
+    do {
+        expected.push_back(bufferLexer.parseNextToken());
+    } while (expected.back().id != TokenId::EndOfCode);
+
+    for (size_t chunkSize = 1; chunkSize < 12; ++chunkSize)
+    {
+        auto source = SourcePipe{ text };
+        auto reader = StreamSourceReader{ source.fds[0], chunkSize };
+        auto lexer = LexicalAnalyzer{ reader };
+        for (auto& token : expected)
+        {
+            auto actual = lexer.parseNextToken();
+            EXPECT_EQ(actual.id, token.id) << chunkSize;
+            EXPECT_EQ(actual.location, token.location) << chunkSize;
+            EXPECT_EQ(actual.text, token.text) << chunkSize;
+        }
+    }
+}
+
+#ifdef __linux__
+static long getResidentPages()
+{
+    long size = 0;
+    long resident = 0;
+    auto file = fopen("/proc/self/statm", "r");
+    if (file)
+    {
+        EXPECT_EQ(fscanf(file, "%ld %ld", &size, &resident), 2);
+        fclose(file);
+    }
+    return resident;
+}
+
+// Push a stream of the given size through a pipe into the reader, and check that the pages resident while reading it
+// stay within what the reader's buffers need. The bound covers the reader alone: the lexer copies the text of every
+// token it produces from a stream into the ConstString arena, which grows with the input.
+static void checkBoundedMemory(size_t streamSize)
+{
+    auto block = std::string{};
+    while (block.size() < 60000)
+    {
+        block += "total% = total% + value% * 3 ' running sum\nPRINT \"item \" + STR$(total%)\n";
+    }
+    auto newlinesPerBlock = size_t(std::count(block.begin(), block.end(), '\n'));
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    auto blockCount = streamSize / block.size();
+    auto writer = std::thread{ [&] {
+        // the reader only stops at the end of the stream, so the write end is closed on every way out
+        struct CloseOnExit
+        {
+            int fd;
+            ~CloseOnExit() { close(fd); }
+        } closeOnExit{ fds[1] };
+
+        auto failed = false;
+        for (size_t i = 0; i < blockCount && !failed; ++i)
+        {
+            for (size_t written = 0; written < block.size();)
+            {
+                auto count = write(fds[1], block.data() + written, block.size() - written);
+                EXPECT_GT(count, 0);
+                if (count <= 0)
+                {
+                    failed = true;
+                    break;
+                }
+                written += size_t(count);
+            }
+        }
+    } };
+
+    auto reader = StreamSourceReader{ fds[0] };
+    auto before = getResidentPages();
+    auto size = size_t(0);
+    auto newlines = size_t(0);
+    for (auto ch = reader.readNextChar(); ch != 0; ch = reader.readNextChar())
+    {
+        newlines += ch == '\n';
+        ++size;
+    }
+    auto after = getResidentPages();
+
+    writer.join();
+    close(fds[0]);
+
+    EXPECT_EQ(size, blockCount * block.size());
+    EXPECT_EQ(newlines, blockCount * newlinesPerBlock);
+    EXPECT_LT(after - before, 256);
+}
+
+TEST(ZeeBasic_Compiler_StreamSourceReader, BoundedMemory)
+{
+    checkBoundedMemory(size_t(64) << 20);
+}
+
+// Takes about twenty seconds, so it only runs with --gtest_also_run_disabled_tests.
+TEST(ZeeBasic_Compiler_StreamSourceReader, DISABLED_BoundedMemoryMultiGigabyte)
+{
+    checkBoundedMemory(size_t(2) << 30);
+}
+#endif
@@ -0,0 +1,115 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/SymbolTable.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+static Type makeType(BaseType base)
+{
+    auto type = Type{};
+    type.base = base;
+    return type;
+}
+
+TEST(ZeeBasic_Compiler_SymbolTable, FindOrCreate)
+{
+    auto table = SymbolTable{};
+    EXPECT_EQ(table.findSymbol({ "x%", 2 }), nullptr);
+
+    auto x = table.findOrCreateSymbol({ "x%", 2 }, {}, makeType(BaseType_Integer));
+    ASSERT_NE(x, nullptr);
+    EXPECT_EQ(table.findOrCreateSymbol({ "X%", 2 }, {}, makeType(BaseType_Integer)), x);
+    EXPECT_EQ(table.findSymbol({ "x%", 2 }), x);
+
+    auto y = table.findOrCreateSymbol({ "y$", 2 }, {}, makeType(BaseType_String));
+    EXPECT_NE(x, y);
+    EXPECT_EQ(table.getSymbols().size(), 2);
+    EXPECT_EQ(table.getSymbols()[0].get(), x);
+    EXPECT_EQ(table.getSymbols()[1].get(), y);
+    EXPECT_EQ(y->index, 1);
+}
+
+TEST(ZeeBasic_Compiler_SymbolTable, Scopes)
+{
+    auto table = SymbolTable{};
+    auto outer = table.findOrCreateSymbol({ "a%", 2 }, {}, makeType(BaseType_Integer));
+    auto shared = table.findOrCreateSymbol({ "b%", 2 }, {}, makeType(BaseType_Integer));
+    EXPECT_EQ(table.getScope(), 0);
+    EXPECT_EQ(outer->scope, 0);
+
+    table.enterScope();
+    EXPECT_EQ(table.getScope(), 1);
+
+    // declaring hides the outer symbol, while plain lookups still reach enclosing scopes
+    auto inner = table.createSymbol({ "A%", 2 }, {}, makeType(BaseType_Integer));
+    ASSERT_NE(inner, nullptr);
+    EXPECT_NE(inner, outer);
+    EXPECT_EQ(inner->scope, 1);
+    EXPECT_EQ(table.createSymbol({ "a%", 2 }, {}, makeType(BaseType_Integer)), nullptr);
+    EXPECT_EQ(table.findSymbol({ "a%", 2 }), inner);
+    EXPECT_EQ(table.findOrCreateSymbol({ "b%", 2 }, {}, makeType(BaseType_Integer)), shared);
+
+    auto local = table.findOrCreateSymbol({ "c%", 2 }, {}, makeType(BaseType_Integer));
+
+    table.enterScope();
+    auto innermost = table.createSymbol({ "a%", 2 }, {}, makeType(BaseType_Integer));
+    EXPECT_EQ(table.findSymbol({ "a%", 2 }), innermost);
+    table.exitScope();
+
+    EXPECT_EQ(table.findSymbol({ "a%", 2 }), inner);
+    table.exitScope();
+
+    EXPECT_EQ(table.findSymbol({ "a%", 2 }), outer);
+    EXPECT_EQ(table.findSymbol({ "c%", 2 }), nullptr);
+    EXPECT_NE(table.findOrCreateSymbol({ "c%", 2 }, {}, makeType(BaseType_Integer)), local);
+
+    // every symbol stays in declaration order
+    ASSERT_EQ(table.getSymbols().size(), 6);
+    EXPECT_EQ(table.getSymbols()[2].get(), inner);
+    EXPECT_EQ(table.getSymbols()[4].get(), innermost);
+}
+
+TEST(ZeeBasic_Compiler_SymbolTable, ManySymbols)
+{
+    auto table = SymbolTable{};
+    for (auto i = 0; i < 50000; ++i)
+    {
+        auto name = "v" + std::to_string(i) + "%";
+        auto symbol = table.findOrCreateSymbol({ name.c_str(), int(name.size()) }, {}, makeType(BaseType_Integer));
+        ASSERT_EQ(symbol->index, i);
+    }
+
+    for (auto i = 0; i < 50000; ++i)
+    {
+        auto name = "V" + std::to_string(i) + "%";
+        ASSERT_EQ(table.findSymbol({ name.c_str(), int(name.size()) })->index, i);
+    }
+}
@@ -0,0 +1,108 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/TokenBuffer.hpp"
+
+#include "ZeeBasic/Compiler/LexicalAnalyzer.hpp"
+
+using namespace ZeeBasic::Compiler;
+
+static std::vector<Token> parseIntoTokens(const char* code)
+{
+    auto lexicalAnalyzer = LexicalAnalyzer{ code, strlen(code) };
+    auto tokens = std::vector<Token>{};
+    do {
+        tokens.push_back(lexicalAnalyzer.parseNextToken());
+    } while (tokens.back().id != TokenId::EndOfCode);
+
+    return tokens;
+}
+
+TEST(ZeeBasic_Compiler_TokenBuffer, Initialization)
+{
+    auto buffer = TokenBuffer{};
+    EXPECT_EQ(buffer.getCount(), 0);
+    EXPECT_EQ(TokenBuffer::kBytesPerToken, 9);
+}
+
+TEST(ZeeBasic_Compiler_TokenBuffer, RoundTrip)
+{
+    static const char* sources[] = {
+        "",
+        "\n",
+        "PRINT -(2 + 3)\n",
+        "a$ = \"hello\" + b$ ' greet\nPRINT a$ ; \"\"\n",
+        "x% = 1.5 * .25 / 3. \\ 2 MOD 7\n\n\n  y = x% <= 2",
+        "strVar$ boolVar? intVar% realVar! under_score1 <> >= < >\n",
+        nullptr
+    };
+    for (auto i = 0; sources[i]; ++i)
+    {
+        auto tokens = parseIntoTokens(sources[i]);
+        auto buffer = TokenBuffer{ sources[i], strlen(sources[i]) };
+        for (auto& token : tokens)
+        {
+            buffer.append(token);
+        }
+
+        ASSERT_EQ(buffer.getCount(), tokens.size());
+        for (size_t j = 0; j < tokens.size(); ++j)
+        {
+            auto token = buffer.getToken(j);
+            EXPECT_EQ(token.id, tokens[j].id) << sources[i];
+            EXPECT_EQ(token.location, tokens[j].location) << sources[i];
+            EXPECT_EQ(token.text, tokens[j].text) << sources[i];
+            EXPECT_EQ(token.text.getLength(), tokens[j].text.getLength()) << sources[i];
+        }
+    }
+}
+
+TEST(ZeeBasic_Compiler_TokenBuffer, AppendBuffer)
+{
+    auto source = "x = 1\ny = 2\n";
+    auto tokens = parseIntoTokens(source);
+
+    auto first = TokenBuffer{ source, strlen(source) };
+    auto second = TokenBuffer{ source, strlen(source) };
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        (i < 4 ? first : second).append(tokens[i]);
+    }
+
+    first.append(second);
+    ASSERT_EQ(first.getCount(), tokens.size());
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        EXPECT_EQ(first.getId(i), tokens[i].id);
+        EXPECT_EQ(first.getLocation(i), tokens[i].location);
+        EXPECT_EQ(first.getText(i).getText(), tokens[i].text.getText());
+    }
+}
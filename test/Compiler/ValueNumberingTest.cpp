@@ -0,0 +1,160 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include "ZeeBasic/Compiler/IrBuilder.hpp"
+#include "ZeeBasic/Compiler/ValueNumbering.hpp"
+
+using namespace ZeeBasic::Compiler;
+using namespace ZeeBasic::Compiler::Nodes;
+
+using BinaryOperator = BinaryExpressionNode::Operator;
+
+static const Type Integer{ BaseType_Integer };
+static const Type String{ BaseType_String };
+
+TEST(ZeeBasic_Compiler_ValueNumbering, Reassignment)
+{
+    // PRINT a + b : PRINT b + a : a = 1 : PRINT a + b
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    builder.setBlock(builder.createBlock());
+    builder.sealBlock(0);
+
+    auto random = builder.call(*getBuiltin(TokenId::Key_RND), Type{ BaseType_Real }, {});
+    builder.writeVariable(0, builder.cast(Integer, random));
+    builder.writeVariable(1, builder.cast(Integer, random));
+    builder.print(builder.binary(BinaryOperator::Add, Integer, builder.readVariable(0, Integer), builder.readVariable(1, Integer)));
+    builder.print(builder.binary(BinaryOperator::Add, Integer, builder.readVariable(1, Integer), builder.readVariable(0, Integer)));
+    builder.writeVariable(0, builder.constant(int64_t(1)));
+    builder.print(builder.binary(BinaryOperator::Add, Integer, builder.readVariable(0, Integer), builder.readVariable(1, Integer)));
+    builder.ret();
+
+    ValueNumbering{ function }.run();
+    EXPECT_EQ(function.dump(),
+        "block0:\n"
+        "  %0 = call real RND\n"
+        "  %1 = cast int %0\n"
+        "  %3 = add int %1, %1\n"
+        "  print %3\n"
+        "  print %3\n"
+        "  %7 = const int 1\n"
+        "  %8 = add int %7, %1\n"
+        "  print %8\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_ValueNumbering, StringTemporaries)
+{
+    // PRINT a$ + b$ : PRINT a$ + b$
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    builder.setBlock(builder.createBlock());
+    builder.sealBlock(0);
+
+    auto a = builder.call(*getBuiltin(TokenId::Key_INKEY_S), String, {});
+    auto b = builder.call(*getBuiltin(TokenId::Key_INKEY_S), String, {});
+    auto first = builder.binary(BinaryOperator::Add, String, a, b);
+    builder.print(first);
+    builder.stringRelease(first);
+    auto second = builder.binary(BinaryOperator::Add, String, a, b);
+    builder.print(second);
+    builder.stringRelease(second);
+    builder.stringRelease(b);
+    builder.stringRelease(a);
+    builder.ret();
+
+    ValueNumbering{ function }.run();
+    EXPECT_EQ(function.dump(),
+        "block0:\n"
+        "  %0 = call string INKEY$\n"
+        "  %1 = call string INKEY$\n"
+        "  %2 = add string %0, %1\n"
+        "  print %2\n"
+        "  print %2\n"
+        "  str.release %2\n"
+        "  str.release %1\n"
+        "  str.release %0\n"
+        "  ret\n");
+}
+
+TEST(ZeeBasic_Compiler_ValueNumbering, Dominance)
+{
+    // x = a * 2 : IF c THEN PRINT a * 2 ELSE y = a * 3 : PRINT a * 3
+    auto function = Ir::Function{};
+    auto builder = IrBuilder{ function };
+    auto entry = builder.createBlock();
+    auto whenTrue = builder.createBlock();
+    auto whenFalse = builder.createBlock();
+    auto join = builder.createBlock();
+
+    builder.setBlock(entry);
+    builder.sealBlock(entry);
+    auto a = builder.cast(Integer, builder.call(*getBuiltin(TokenId::Key_RND), Type{ BaseType_Real }, {}));
+    builder.print(builder.binary(BinaryOperator::Multiply, Integer, a, builder.constant(int64_t(2))));
+    builder.branch(builder.constant(true), whenTrue, whenFalse);
+
+    builder.setBlock(whenTrue);
+    builder.sealBlock(whenTrue);
+    builder.print(builder.binary(BinaryOperator::Multiply, Integer, a, builder.constant(int64_t(2))));
+    builder.jump(join);
+
+    builder.setBlock(whenFalse);
+    builder.sealBlock(whenFalse);
+    builder.print(builder.binary(BinaryOperator::Multiply, Integer, a, builder.constant(int64_t(3))));
+    builder.jump(join);
+
+    // the product in the ELSE arm does not dominate the join
+    builder.setBlock(join);
+    builder.sealBlock(join);
+    builder.print(builder.binary(BinaryOperator::Multiply, Integer, a, builder.constant(int64_t(3))));
+    builder.ret();
+
+    ValueNumbering{ function }.run();
+    EXPECT_EQ(function.dump(),
+        "block0:\n"
+        "  %0 = call real RND\n"
+        "  %1 = cast int %0\n"
+        "  %2 = const int 2\n"
+        "  %3 = mul int %1, %2\n"
+        "  print %3\n"
+        "  %5 = const bool true\n"
+        "  branch %5, block1, block2\n"
+        "block1:\n"
+        "  print %3\n"
+        "  jump block3\n"
+        "block2:\n"
+        "  %11 = const int 3\n"
+        "  %12 = mul int %1, %11\n"
+        "  print %12\n"
+        "  jump block3\n"
+        "block3:\n"
+        "  %15 = const int 3\n"
+        "  %16 = mul int %1, %15\n"
+        "  print %16\n"
+        "  ret\n");
+}
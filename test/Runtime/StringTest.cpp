@@ -0,0 +1,192 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2020, Jason Hoyt
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+extern "C"
+{
+#include "ZeeBasic/Runtime/ZeeRuntime.h"
+}
+
+static std::string text(const zrt_String* str)
+{
+    return std::string(str->data, size_t(str->length));
+}
+
+// a string of the given text, on the heap unless it is short
+static zrt_String* make(zrt_String* str, const char* value)
+{
+    zrt_str_take(zrt_str_init(str), zrt_str_new(value));
+    return str;
+}
+
+static const char* kLong = "a string too long for the small buffer";
+
+TEST(ZeeBasic_Runtime_String, RetainThenAppend)
+{
+    zrt_String a[1], b[1], tail[1];
+    make(a, kLong);
+    make(tail, "!");
+    zrt_str_retain(zrt_str_init(b), a);
+    EXPECT_EQ(a->data, b->data);
+
+    // the shared text is copied before the append writes to it
+    zrt_str_append(b, tail);
+    EXPECT_NE(a->data, b->data);
+    EXPECT_EQ(text(a), kLong);
+    EXPECT_EQ(text(b), std::string(kLong) + "!");
+
+    zrt_str_release(a);
+    zrt_str_release(b);
+    zrt_str_release(tail);
+}
+
+TEST(ZeeBasic_Runtime_String, TakeSmall)
+{
+    zrt_String str[1];
+    make(str, kLong);
+
+    // the small text lives inside the string that is freed, so it is copied out first
+    zrt_str_take(str, zrt_str_new("abc"));
+    EXPECT_EQ(str->data, str->small);
+    EXPECT_EQ(text(str), "abc");
+
+    zrt_str_take(str, zrt_str_new(kLong));
+    EXPECT_NE(str->data, str->small);
+    EXPECT_EQ(text(str), kLong);
+
+    zrt_str_release(str);
+}
+
+TEST(ZeeBasic_Runtime_String, AppendSelf)
+{
+    zrt_String str[1], comma[1];
+    make(str, "ab");
+    make(comma, ",");
+
+    zrt_String* parts[] = { str, comma, str };
+    zrt_str_append_n(str, 3, parts);
+    EXPECT_EQ(text(str), "abab,ab");
+
+    zrt_str_append(str, str);
+    EXPECT_EQ(text(str), "abab,ababab,ab");
+
+    // once on the heap, growing moves the text that is being appended
+    zrt_str_append_n(str, 3, parts);
+    EXPECT_EQ(text(str), "abab,ababab,ababab,ababab,ab,abab,ababab,ab");
+
+    zrt_str_release(str);
+    zrt_str_release(comma);
+}
+
+TEST(ZeeBasic_Runtime_String, ConcatIntoShared)
+{
+    zrt_String dst[1], lhs[1], rhs[1];
+    make(lhs, kLong);
+    make(rhs, "!");
+
+    // dst shares the text of its left operand, which it lets go of before writing
+    zrt_str_retain(zrt_str_init(dst), lhs);
+    zrt_str_concat_into(dst, lhs, rhs);
+    EXPECT_NE(dst->data, lhs->data);
+    EXPECT_EQ(text(lhs), kLong);
+    EXPECT_EQ(text(dst), std::string(kLong) + "!");
+
+    zrt_str_release(dst);
+    zrt_str_release(lhs);
+    zrt_str_release(rhs);
+}
+
+TEST(ZeeBasic_Runtime_String, ReleaseThenReuse)
+{
+    zrt_String a[1], b[1], tail[1];
+    make(a, kLong);
+    make(tail, "!");
+    zrt_str_retain(zrt_str_init(b), a);
+
+    zrt_str_release(a);
+    EXPECT_EQ(a->length, 0);
+    EXPECT_EQ(a->data, a->small);
+    EXPECT_EQ(text(b), kLong);
+
+    // b holds the only reference now, so it appends in place
+    auto data = b->data;
+    zrt_str_append(b, tail);
+    EXPECT_EQ(text(b), std::string(kLong) + "!");
+    EXPECT_EQ(b->data, data);
+
+    zrt_str_copy(a, b);
+    EXPECT_EQ(text(a), text(b));
+    EXPECT_NE(a->data, b->data);
+
+    zrt_str_release(a);
+    zrt_str_release(b);
+    zrt_str_release(tail);
+}
+
+TEST(ZeeBasic_Runtime_String, Immortal)
+{
+    char shortText[] = "abc";
+    char longText[] = "a static string too long for the small buffer";
+    zrt_String tail[1];
+    make(tail, "!");
+
+    // written strings detach from their static text, which stays as it was
+    zrt_String str = { 3, ZRT_STR_IMMORTAL, shortText };
+    zrt_str_append(&str, tail);
+    EXPECT_EQ(str.data, str.small);
+    EXPECT_EQ(text(&str), "abc!");
+    EXPECT_STREQ(shortText, "abc");
+    zrt_str_release(&str);
+
+    str = { zrt_Int(strlen(longText)), ZRT_STR_IMMORTAL, longText };
+    zrt_str_append(&str, tail);
+    EXPECT_NE(str.data, longText);
+    EXPECT_EQ(text(&str), std::string(longText) + "!");
+    zrt_str_release(&str);
+
+    str = { 3, ZRT_STR_IMMORTAL, shortText };
+    zrt_str_copy(&str, tail);
+    EXPECT_EQ(text(&str), "!");
+    EXPECT_STREQ(shortText, "abc");
+    zrt_str_release(&str);
+
+    // and a static string is never released, nor shared
+    zrt_String literal = { 3, ZRT_STR_IMMORTAL, shortText };
+    zrt_str_release(&literal);
+    EXPECT_EQ(text(&literal), "abc");
+
+    zrt_String copy[1];
+    zrt_str_retain(zrt_str_init(copy), &literal);
+    EXPECT_NE(copy->data, literal.data);
+    EXPECT_EQ(text(copy), "abc");
+
+    zrt_str_release(copy);
+    zrt_str_release(tail);
+}